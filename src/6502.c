@@ -6,6 +6,7 @@
 #include "6502.h"
 #include "adc.h"
 #include "disc.h"
+#include "hostprof.h"
 #include "i8271.h"
 #include "ide.h"
 #include "mem.h"
@@ -183,6 +184,19 @@ static uint32_t dbg_do_readmem(uint32_t addr);
 static void     dbg_do_writemem(uint32_t addr, uint32_t val);
 static uint32_t dbg_disassemble(cpu_debug_t *cpu, uint32_t addr, char *buf, size_t bufsize);
 
+/* I/O in FRED, JIM and SHEILA (&FC00-&FEFF) is dispatched through
+ * these tables, one entry per four byte block, which are filled in by
+ * m6502_io_setup() according to the model being emulated.
+ */
+
+#define IO_BLOCKS ((0xFF00 - 0xFC00) >> 2)
+
+typedef uint8_t (*io_read_fn)(uint16_t addr);
+typedef void (*io_write_fn)(uint16_t addr, uint8_t val);
+
+static io_read_fn io_read_tab[IO_BLOCKS];
+static io_write_fn io_write_tab[IO_BLOCKS];
+
 static uint16_t pc3, oldpc, oldoldpc;
 static uint8_t opcode;
 
@@ -230,28 +244,77 @@ uint64_t stopwatch;
 static int otherstuffcount = 0;
 int romsel;
 
+/*
+ * Peripherals that only need attention at a known future cycle (VIA
+ * timers, sound, Music 5000 and the disc) are not polled on every call
+ * to polltime.  Instead cycles accumulate in sched_elapsed until the
+ * nearest deadline, sched_next, is reached and are then handed over in
+ * one go.  Anything which could observe or move a deadline, such as an
+ * I/O access, must call sched_catchup first and then either recompute
+ * the deadline with sched_sync or force one with sched_next = 0.
+ */
+
+static int sched_elapsed;
+static int sched_next;
+
+static void sched_catchup(void)
+{
+    int c = sched_elapsed;
+    if (c) {
+        sched_elapsed = 0;
+        HOSTPROF(HOSTPROF_VIA, via_poll(&sysvia, c); via_poll(&uservia, c));
+        HOSTPROF(HOSTPROF_SOUND, sound_poll(c));
+        HOSTPROF(HOSTPROF_M5000, music5000_poll(c));
+        if (motoron) {
+            if (fdc_time) {
+                fdc_time -= c;
+                if (fdc_time <= 0)
+                    HOSTPROF(HOSTPROF_DISC, fdc_callback());
+            }
+            disc_time -= c;
+            if (disc_time <= 0) {
+                disc_time += 16;
+                HOSTPROF(HOSTPROF_DISC, disc_poll());
+            }
+        }
+    }
+}
+
+static void sched_sync(void)
+{
+    sched_catchup();
+    int next = via_next_poll(&sysvia);
+    int due = via_next_poll(&uservia);
+    if (due < next)
+        next = due;
+    if ((due = sound_next_poll()) < next)
+        next = due;
+    if ((due = music5000_next_poll()) < next)
+        next = due;
+    if (motoron) {
+        if (fdc_time && fdc_time < next)
+            next = fdc_time;
+        if (disc_time < next)
+            next = disc_time;
+    }
+    sched_next = next;
+}
+
+static inline void sched_io(void)
+{
+    sched_catchup();
+    sched_next = 0;
+}
+
 static void polltime(int c)
 {
     cycles -= c;
-    via_poll(&sysvia, c);
-    via_poll(&uservia, c);
-    video_poll(c, 1);
-    sound_poll(c);
-    music5000_poll(c);
+    sched_elapsed += c;
+    if (sched_elapsed >= sched_next)
+        sched_sync();
+    HOSTPROF(HOSTPROF_VIDEO, video_poll(c, 1));
     stopwatch += c;
     otherstuffcount -= c;
-    if (motoron) {
-        if (fdc_time) {
-            fdc_time -= c;
-            if (fdc_time <= 0)
-                fdc_callback();
-        }
-        disc_time -= c;
-        if (disc_time <= 0) {
-            disc_time += 16;
-            disc_poll();
-        }
-    }
     tubecycle += c * tube_multiplier;
 }
 
@@ -340,6 +403,29 @@ static void os_paste_cnpv(void)
     opcode = readmem(pc);
 }
 
+/*
+ * Nearly every access the cores make, and every instruction fetch, is
+ * to RAM or ROM so these are made inline straight from the page tables
+ * which ROMSEL and ACCCON keep up to date.  I/O, writes to page 2 which
+ * may move the paste vectors, and anything the debugger is watching
+ * still go through readmem and writemem.
+ */
+
+static inline uint8_t fast_readmem(uint16_t addr)
+{
+    if (memstat[vis20k][addr >> 8] && !dbg_core6502 && !debug_memview)
+        return memlook[vis20k][addr >> 8][addr];
+    return readmem(addr);
+}
+
+static inline void fast_writemem(uint16_t addr, uint8_t val)
+{
+    if (memstat[vis20k][addr >> 8] == MSTAT_RAM && (addr >> 8) != 0x02 && !dbg_core6502 && !debug_memview)
+        memlook[vis20k][addr >> 8][addr] = val;
+    else
+        writemem(addr, val);
+}
+
 static inline void fetch_opcode(void)
 {
     pc3 = oldoldpc;
@@ -347,20 +433,22 @@ static inline void fetch_opcode(void)
     oldpc = pc;
     vis20k = RAMbank[pc >> 12];
 
-    if (dbg_core6502)
+    if (dbg_core6502) {
+        sched_io();
         debug_preexec(&core6502_cpu_debug, debug_addr(pc));
+    }
     if (pc == buf_remv && x == 0 && clip_paste_ptr)
         os_paste_remv();
     else if (pc == buf_cnpv && x == 0 && clip_paste_ptr)
         os_paste_cnpv();
     else
-        opcode = readmem(pc);
+        opcode = fast_readmem(pc);
     pc++;
 }
 
 static inline uint16_t read_zp_indirect(uint16_t zp)
 {
-    return readmem(zp & 0xff) + (readmem((zp + 1) & 0xff) << 8);
+    return fast_readmem(zp & 0xff) + (fast_readmem((zp + 1) & 0xff) << 8);
 }
 
 static uint32_t dbg_do_readmem(uint32_t addr) {
@@ -376,10 +464,12 @@ static uint32_t do_readmem(uint32_t addr)
 {
     addr &= 0xffff;
 
-        if (pc == addr)
-            fetchc[addr] = 31;
-        else
-            readc[addr] = 31;
+        if (debug_memview) {
+            if (pc == addr)
+                fetchc[addr] = 31;
+            else
+                readc[addr] = 31;
+        }
 
         if (memstat[vis20k][addr >> 8]) // Anything except I/O.
                 return memlook[vis20k][addr >> 8][addr];
@@ -392,170 +482,10 @@ static uint32_t do_readmem(uint32_t addr)
                         polltime(1);
                 }
         }
-
-        if (addr >= 0xFCFD && addr <= 0xFDFF) {
-            // JIM, including paging registers in FRED.
-            if (sound_paula) {
-                uint8_t r;
-                if (paula_read(addr, &r))
-                    return r;
-            }
-            if (mem_jim_size)
-                return mem_jim_read(addr);
-        }
-
-        switch (addr & ~3) {
-            case 0xFC08:
-            case 0xFC0C:
-                if (sound_music5000)
-                    return music2000_read(addr);
-                break;
-        case 0xFC20:
-        case 0xFC24:
-        case 0xFC28:
-        case 0xFC2C:
-        case 0xFC30:
-        case 0xFC34:
-        case 0xFC38:
-        case 0xFC3C:
-                if (sound_beebsid)
-                        return sid_read((uint16_t)addr);
-                break;
-
-        case 0xFC40:
-        case 0xFC44:
-        case 0xFC48:
-        case 0xFC4C:
-        case 0xFC50:
-        case 0xFC54:
-        case 0xFC58:
-                if (scsi_enabled)
-                        return scsi_read((uint16_t)addr);
-                if (ide_enable)
-                        return ide_read((uint16_t)addr);
-                break;
-
-        case 0xFC5C:
-                return vdfs_read((uint16_t)addr);
-                break;
-
-        case 0xfcc8:
-            if (addr == 0xfccb)
-                return mem_jim_getsize();
-            break;
-
-        case 0xFE00:
-        case 0xFE04:
-                return crtc_read((uint16_t)addr);
-
-        case 0xFE08:
-        case 0xFE0C:
-                return acia_read(&sysacia, (uint16_t)addr);
-
-        case 0xFE10:
-        case 0xFE14:
-                return serial_read((uint16_t)addr);
-
-        case 0xFE18:
-        case 0xFE1C:
-                if (MASTER)
-                        return adc_read((uint16_t)addr);
-                else
-                    return mmccard_read();
-                break;
-
-        case 0xFE24:
-        case 0xFE28:
-                if (MASTER)
-                        return wd1770_read((uint16_t)addr);
-                break;
-
-        case 0xFE30:
-            if (MASTER)
-                return ram_fe30;
-            break;
-
-        case 0xFE34:
-                if (MASTER)
-                        return acccon;
-                break;
-
-        case 0xFE3C:
-            if (integra)
-                return cmos_read_data_integra();
-            break;
-
-        case 0xFE40:
-        case 0xFE44:
-        case 0xFE48:
-        case 0xFE4C:
-        case 0xFE50:
-        case 0xFE54:
-        case 0xFE58:
-        case 0xFE5C:
-                return sysvia_read((uint16_t)addr);
-
-        case 0xFE60:
-        case 0xFE64:
-        case 0xFE68:
-        case 0xFE6C:
-        case 0xFE70:
-        case 0xFE74:
-        case 0xFE78:
-        case 0xFE7C:
-            if (!MODELA)
-                return uservia_read((uint16_t)addr);
-            break;
-
-        case 0xFE80:
-        case 0xFE84:
-        case 0xFE88:
-        case 0xFE8C:
-        case 0xFE90:
-        case 0xFE94:
-        case 0xFE98:
-        case 0xFE9C:
-            switch(fdc_type) {
-                case FDC_NONE:
-                case FDC_MASTER:
-                    break;
-                case FDC_I8271:
-                    return i8271_read((uint16_t)addr);
-                default:
-                    return wd1770_read((uint16_t)addr);
-            }
-            break;
-
-        case 0xFEC0:
-        case 0xFEC4:
-        case 0xFEC8:
-        case 0xFECC:
-        case 0xFED0:
-        case 0xFED4:
-        case 0xFED8:
-                if (!MASTER)
-                        return adc_read((uint16_t)addr);
-                break;
-        case 0xFEDC:
-            if (MASTER)
-                return mmccard_read();
-            else if (!MODELA)
-                return adc_read((uint16_t)addr);
-            break;
-
-        case 0xFEE0:
-        case 0xFEE4:
-        case 0xFEE8:
-        case 0xFEEC:
-        case 0xFEF0:
-        case 0xFEF4:
-        case 0xFEF8:
-        case 0xFEFC:
-                return tube_host_read((uint16_t)addr);
-        }
-        if (addr >= 0xFC00 && addr < 0xFE00)
-                return 0xFF;
-        return addr >> 8;
+        sched_io();
+        if (addr < 0xFC00 || addr >= 0xFF00)
+                return addr >> 8;
+        return io_read_tab[(addr - 0xFC00) >> 2](addr);
 }
 
 uint8_t readmem(uint16_t addr)
@@ -768,13 +698,233 @@ static void write_fe34(int val)
         write_romsel(val);
 }
 
+/* I/O handlers.  Those for devices that are determined by the model are
+ * chosen once in m6502_io_setup() while those for peripherals that can
+ * be switched on and off from the GUI still test for them here.
+ */
+
+static uint8_t io_read_none(uint16_t addr)
+{
+    if (addr < 0xFE00)
+        return 0xFF;
+    return addr >> 8;
+}
+
+static void io_write_none(uint16_t addr, uint8_t val)
+{
+}
+
+static uint8_t io_read_jim(uint16_t addr)
+{
+    // JIM, including paging registers in FRED.
+    if (addr >= 0xFCFD) {
+        if (sound_paula) {
+            uint8_t r;
+            if (paula_read(addr, &r))
+                return r;
+        }
+        if (mem_jim_size)
+            return mem_jim_read(addr);
+    }
+    return 0xFF;
+}
+
+static void io_write_jim(uint16_t addr, uint8_t val)
+{
+    if (addr >= 0xFCFD) {
+        if (addr >= 0xFCFF && sound_music5000)
+            music5000_write(addr, val);
+        if (sound_paula)
+            paula_write(addr, val);
+        if (mem_jim_size)
+            mem_jim_write(addr, val);
+    }
+}
+
+static uint8_t io_read_music2000(uint16_t addr)
+{
+    if (sound_music5000)
+        return music2000_read(addr);
+    return 0xFF;
+}
+
+static void io_write_music2000(uint16_t addr, uint8_t val)
+{
+    if (sound_music5000)
+        music2000_write(addr, val);
+}
+
+static uint8_t io_read_sid(uint16_t addr)
+{
+    if (sound_beebsid) {
+        sound_sid_sync();
+        return sid_read(addr);
+    }
+    return 0xFF;
+}
+
+static void io_write_sid(uint16_t addr, uint8_t val)
+{
+    if (sound_beebsid) {
+        sound_sid_sync();
+        sid_write(addr, val);
+    }
+}
+
+static uint8_t io_read_hdisc(uint16_t addr)
+{
+    if (scsi_enabled)
+        return scsi_read(addr);
+    if (ide_enable)
+        return ide_read(addr);
+    return 0xFF;
+}
+
+static void io_write_hdisc(uint16_t addr, uint8_t val)
+{
+    if (scsi_enabled)
+        scsi_write(addr, val);
+    else if (ide_enable)
+        ide_write(addr, val);
+}
+
+static uint8_t io_read_jim_size(uint16_t addr)
+{
+    if (addr == 0xFCCB)
+        return mem_jim_getsize();
+    return 0xFF;
+}
+
+static uint8_t io_read_sysacia(uint16_t addr)
+{
+    return acia_read(&sysacia, addr);
+}
+
+static void io_write_sysacia(uint16_t addr, uint8_t val)
+{
+    acia_write(&sysacia, addr, val);
+}
+
+static uint8_t io_read_mmccard(uint16_t addr)
+{
+    return mmccard_read();
+}
+
+static void io_write_mmccard(uint16_t addr, uint8_t val)
+{
+    mmccard_write(val);
+}
+
+static uint8_t io_read_fe30(uint16_t addr)
+{
+    return ram_fe30;
+}
+
+static uint8_t io_read_acccon(uint16_t addr)
+{
+    return acccon;
+}
+
+static void io_write_romsel(uint16_t addr, uint8_t val)
+{
+    write_romsel(val);
+}
+
+static void io_write_fe34(uint16_t addr, uint8_t val)
+{
+    write_fe34(val);
+}
+
+static uint8_t io_read_cmos_integra(uint16_t addr)
+{
+    return cmos_read_data_integra();
+}
+
+static void io_write_cmos_addr_integra(uint16_t addr, uint8_t val)
+{
+    cmos_write_addr_integra(val);
+}
+
+static void io_write_cmos_data_integra(uint16_t addr, uint8_t val)
+{
+    cmos_write_data_integra(val);
+}
+
+static void io_range(uint16_t start, uint16_t end, io_read_fn rfunc, io_write_fn wfunc)
+{
+    for (int blk = (start - 0xFC00) >> 2; blk <= (end - 0xFC00) >> 2; blk++) {
+        if (rfunc)
+            io_read_tab[blk] = rfunc;
+        if (wfunc)
+            io_write_tab[blk] = wfunc;
+    }
+}
+
+void m6502_io_setup(void)
+{
+    io_range(0xFC00, 0xFEFF, io_read_none, io_write_none);
+
+    io_range(0xFCFC, 0xFDFF, io_read_jim, io_write_jim);
+    io_range(0xFC08, 0xFC0F, io_read_music2000, io_write_music2000);
+    io_range(0xFC20, 0xFC3F, io_read_sid, io_write_sid);
+    io_range(0xFC40, 0xFC5B, io_read_hdisc, io_write_hdisc);
+    io_range(0xFC5C, 0xFC5F, vdfs_read, vdfs_write);
+    io_range(0xFCC8, 0xFCCB, io_read_jim_size, NULL);
+
+    io_range(0xFE00, 0xFE07, crtc_read, crtc_write);
+    io_range(0xFE08, 0xFE0F, io_read_sysacia, io_write_sysacia);
+    io_range(0xFE10, 0xFE17, serial_read, serial_write);
+    io_range(0xFE30, 0xFE33, NULL, io_write_romsel);
+    io_range(0xFE34, 0xFE37, NULL, io_write_fe34);
+    io_range(0xFE40, 0xFE5F, sysvia_read, sysvia_write);
+    io_range(0xFEE0, 0xFEFF, tube_host_read, tube_host_write);
+
+    if (MASTER) {
+        io_range(0xFE18, 0xFE1F, adc_read, adc_write);
+        io_range(0xFE20, 0xFE23, NULL, videoula_write);
+        io_range(0xFE24, 0xFE2B, wd1770_read, wd1770_write);
+        io_range(0xFE30, 0xFE33, io_read_fe30, NULL);
+        io_range(0xFE34, 0xFE37, io_read_acccon, NULL);
+        io_range(0xFEDC, 0xFEDF, io_read_mmccard, io_write_mmccard);
+    }
+    else {
+        io_range(0xFE18, 0xFE1F, io_read_mmccard, io_write_mmccard);
+        io_range(0xFE20, 0xFE27, NULL, videoula_write);
+        io_range(0xFEC0, 0xFEDB, adc_read, MODELA ? NULL : adc_write);
+        if (!MODELA)
+            io_range(0xFEDC, 0xFEDF, adc_read, adc_write);
+    }
+
+    if (integra) {
+        io_range(0xFE38, 0xFE3B, NULL, io_write_cmos_addr_integra);
+        io_range(0xFE3C, 0xFE3F, io_read_cmos_integra, io_write_cmos_data_integra);
+    }
+    else if (!MASTER && !BPLUS)
+        io_range(0xFE38, 0xFE3F, NULL, io_write_romsel);
+
+    if (!MODELA)
+        io_range(0xFE60, 0xFE7F, uservia_read, uservia_write);
+
+    switch(fdc_type) {
+        case FDC_NONE:
+        case FDC_MASTER:
+            break;
+        case FDC_I8271:
+            io_range(0xFE80, 0xFE9F, i8271_read, i8271_write);
+            break;
+        default:
+            io_range(0xFE80, 0xFE9F, wd1770_read, wd1770_write);
+    }
+}
+
 static void do_writemem(uint32_t addr, uint32_t val)
 {
         int c;
 
     addr &= 0xffff;
 
-        writec[addr] = 31;
+        if (debug_memview)
+            writec[addr] = 31;
 
         c = memstat[vis20k][addr >> 8];
         if (c == MSTAT_RAM) {
@@ -821,184 +971,8 @@ static void do_writemem(uint32_t addr, uint32_t val)
                         polltime(1);
                 }
         }
-
-        if (addr >= 0xFCFD && addr <= 0xFDFF) {
-            // JIM, including paging registers in FRED.
-            if (addr >= 0xFCFF && sound_music5000)
-                music5000_write((uint16_t)addr, (uint8_t)val);
-            if (sound_paula)
-                paula_write(addr, val);
-            if (mem_jim_size)
-                mem_jim_write(addr, val);
-        }
-
-        switch (addr & ~3) {
-            case 0xFC08:
-            case 0xFC0C:
-                if (sound_music5000)
-                    music2000_write(addr, (uint8_t)val);
-                break;
-        case 0xFC20:
-        case 0xFC24:
-        case 0xFC28:
-        case 0xFC2C:
-        case 0xFC30:
-        case 0xFC34:
-        case 0xFC38:
-        case 0xFC3C:
-                if (sound_beebsid)
-                        sid_write((uint16_t)addr, (uint8_t)val);
-                break;
-
-        case 0xFC40:
-        case 0xFC44:
-        case 0xFC48:
-        case 0xFC4C:
-        case 0xFC50:
-        case 0xFC54:
-        case 0xFC58:
-                if (scsi_enabled)
-                        scsi_write((uint16_t)addr, (uint8_t)val);
-                else if (ide_enable)
-                        ide_write((uint16_t)addr, (uint8_t)val);
-                break;
-
-        case 0xFC5C:
-                vdfs_write((uint16_t)addr, (uint8_t)val);
-                break;
-
-        case 0xFE00:
-        case 0xFE04:
-                crtc_write((uint16_t)addr, (uint8_t)val);
-                break;
-
-        case 0xFE08:
-        case 0xFE0C:
-                acia_write(&sysacia, (uint16_t)addr, (uint8_t)val);
-                break;
-
-        case 0xFE10:
-        case 0xFE14:
-                serial_write((uint16_t)addr, (uint8_t)val);
-                break;
-
-        case 0xFE18:
-        case 0xFE1C:
-                if (MASTER)
-                        adc_write((uint16_t)addr, (uint8_t)val);
-                else
-                    mmccard_write(val);
-                break;
-
-        case 0xFE20:
-                videoula_write((uint16_t)addr, (uint8_t)val);
-                break;
-
-        case 0xFE24:
-                if (MASTER)
-                        wd1770_write((uint16_t)addr, (uint8_t)val);
-                else
-                        videoula_write((uint16_t)addr, (uint8_t)val);
-                break;
-
-        case 0xFE28:
-                if (MASTER)
-                        wd1770_write((uint16_t)addr, (uint8_t)val);
-                break;
-
-        case 0xFE30:
-            write_romsel(val);
-            break;
-
-        case 0xFE34:
-            write_fe34(val);
-            break;
-
-        case 0xFE38:
-            if (integra)
-                cmos_write_addr_integra(val);
-            else if (!MASTER && !BPLUS)
-                write_romsel(val);
-            break;
-
-        case 0xFE3C:
-            if (integra)
-                cmos_write_data_integra(val);
-            else if (!MASTER && !BPLUS)
-                write_romsel(val);
-            break;
-
-        case 0xFE40:
-        case 0xFE44:
-        case 0xFE48:
-        case 0xFE4C:
-        case 0xFE50:
-        case 0xFE54:
-        case 0xFE58:
-        case 0xFE5C:
-                sysvia_write((uint16_t)addr, (uint8_t)val);
-                break;
-
-        case 0xFE60:
-        case 0xFE64:
-        case 0xFE68:
-        case 0xFE6C:
-        case 0xFE70:
-        case 0xFE74:
-        case 0xFE78:
-        case 0xFE7C:
-            if (!MODELA)
-                uservia_write((uint16_t)addr, (uint8_t)val);
-            break;
-
-        case 0xFE80:
-        case 0xFE84:
-        case 0xFE88:
-        case 0xFE8C:
-        case 0xFE90:
-        case 0xFE94:
-        case 0xFE98:
-        case 0xFE9C:
-            switch(fdc_type) {
-                case FDC_NONE:
-                case FDC_MASTER:
-                    break;
-                case FDC_I8271:
-                    i8271_write((uint16_t)addr, (uint8_t)val);
-                    break;
-                default:
-                    wd1770_write((uint16_t)addr, (uint8_t)val);
-            }
-            break;
-
-        case 0xFEC0:
-        case 0xFEC4:
-        case 0xFEC8:
-        case 0xFECC:
-        case 0xFED0:
-        case 0xFED4:
-        case 0xFED8:
-            if (!MASTER && !MODELA)
-                adc_write((uint16_t)addr, (uint8_t)val);
-            break;
-        case 0xFEDC:
-            if (MASTER)
-                mmccard_write(val);
-            else if (!MODELA)
-                adc_write((uint16_t)addr, (uint8_t)val);
-            break;
-
-        case 0xFEE0:
-        case 0xFEE4:
-        case 0xFEE8:
-        case 0xFEEC:
-        case 0xFEF0:
-        case 0xFEF4:
-        case 0xFEF8:
-        case 0xFEFC:
-                tube_host_write((uint16_t)addr, (uint8_t)val);
-                break;
-        }
+        sched_io();
+        io_write_tab[(addr - 0xFC00) >> 2](addr, val);
 }
 
 void writemem(uint16_t addr, uint8_t val)
@@ -1047,6 +1021,7 @@ void m6502_reset(void)
         ram_fe30 = 0;
         ram_fe34 = 0;
         cycles = 0;
+        sched_elapsed = sched_next = 0;
 
         pc = readmem(0xFFFC) | (readmem(0xFFFD) << 8);
         p.i = 1;
@@ -1057,6 +1032,20 @@ void m6502_reset(void)
         log_debug("PC : %04X\n", pc);
 }
 
+/*
+ * The counters which decide when the peripherals and the tube next
+ * run are not part of a savestate, so anything which must run the same
+ * way from a loaded state, such as a movie, puts them back to these
+ * fixed values.  This is called between slices so nothing is pending.
+ */
+
+void m6502_reset_timing(void)
+{
+    sched_elapsed = sched_next = 0;
+    otherstuffcount = 0;
+    tubecycle = tubecycles = 0;
+}
+
 void dumpregs(void)
 {
         log_debug("6502 registers :\n");
@@ -1069,22 +1058,22 @@ void dumpregs(void)
 
 static inline uint16_t getsw(void)
 {
-        uint16_t temp = readmem(pc);
+        uint16_t temp = fast_readmem(pc);
         pc++;
-        temp |= (readmem(pc) << 8);
+        temp |= (fast_readmem(pc) << 8);
         pc++;
         return temp;
 }
 
 static void otherstuff_poll(void) {
+    sched_io();
+    hostprof_t hostprof_prev = hostprof_enter(HOSTPROF_OTHER);
     otherstuffcount += 128;
     acia_poll(&sysacia);
     if (sound_music5000)
         music2000_poll();
-    if (!tapelcount) {
-        tape_poll();
-        tapelcount = tapellatch;
-    }
+    if (!tapelcount)
+        tapelcount = tape_poll();
     tapelcount--;
     if (motorspin) {
         motorspin--;
@@ -1106,6 +1095,7 @@ static void otherstuff_poll(void) {
         mcount = 6;
         mouse_poll();
     }
+    hostprof_leave(hostprof_prev);
 }
 
 #define getw() getsw()
@@ -1118,12 +1108,12 @@ static inline void setzn(uint8_t v)
 
 static inline void push(uint8_t v)
 {
-    writemem(0x100 + s--, v);
+    fast_writemem(0x100 + s--, v);
 }
 
 static inline uint8_t pull(void)
 {
-    return readmem(0x100 + ++s);
+    return fast_readmem(0x100 + ++s);
 }
 
 static inline void adc_nmos(uint8_t temp)
@@ -1272,7 +1262,7 @@ static inline void sbc_cmos(uint8_t temp)
 
 static inline void nmos_arr(void)
 {
-    uint_fast8_t s = readmem(pc++);
+    uint_fast8_t s = fast_readmem(pc++);
     uint_fast8_t t = a & s;                 /* Perform the AND. */
     if (p.d) {
         uint_fast8_t ah = t >> 4;               /* Separate the high */
@@ -1321,6 +1311,8 @@ void m6502_exec(int slice)
         int tempi;
         int8_t offset;
         cycles += slice;
+        hostprof_t hostprof_prev = hostprof_enter(HOSTPROF_CPU);
+        sched_sync();
 
         while (cycles > 0) {
                 fetch_opcode();
@@ -1332,19 +1324,19 @@ void m6502_exec(int slice)
                         push(pc >> 8);
                         push(pc & 0xFF);
                         push(pack_flags(0x30));
-                        pc = readmem(0xFFFE) | (readmem(0xFFFF) << 8);
+                        pc = fast_readmem(0xFFFE) | (fast_readmem(0xFFFF) << 8);
                         p.i = 1;
                         polltime(7);
                         takeint = 0;
                         break;
 
                 case 0x01:      /*ORA (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
-                        a |= readmem(addr);
+                        a |= fast_readmem(addr);
                         setzn(a);
                         break;
 
@@ -1354,57 +1346,57 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x03:      /*Undocumented - SLO (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(6);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(1);
                         p.c = temp & 0x80;
                         temp <<= 1;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         a |= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x04:      /*Undocumented - NOP zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x05:      /*ORA zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        a |= readmem(addr);
+                        a |= fast_readmem(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x06:      /*ASL zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         p.c = temp & 0x80;
                         temp <<= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x07:      /*Undocumented - SLO zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         p.c = temp & 0x80;
                         temp <<= 1;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         a |= temp;
                         setzn(a);
                         polltime(5);
@@ -1420,7 +1412,7 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x09:      /*ORA imm */
-                        a |= readmem(pc);
+                        a |= fast_readmem(pc);
                         pc++;
                         setzn(a);
                         polltime(2);
@@ -1436,7 +1428,7 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x0B:      /*Undocumented - ANC imm */
-                        a &= readmem(pc);
+                        a &= fast_readmem(pc);
                         pc++;
                         setzn(a);
                         p.c = p.n;
@@ -1454,41 +1446,41 @@ void m6502_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a |= readmem(addr);
+                        a |= fast_readmem(addr);
                         setzn(a);
                         break;
 
                 case 0x0E:      /*ASL abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(1);
                         p.c = temp & 0x80;
                         temp <<= 1;
                         setzn(temp);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         break;
 
                 case 0x0F:      /*Undocumented - SLO abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(1);
                         p.c = temp & 0x80;
                         temp <<= 1;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         a |= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x10:
-                        /*BPL*/ offset = (int8_t) readmem(pc);
+                        /*BPL*/ offset = (int8_t) fast_readmem(pc);
                         pc++;
                         temp = 2;
                         if (!p.n) {
@@ -1501,74 +1493,74 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x11:      /*ORA (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a |= readmem(addr + y);
+                        a |= fast_readmem(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x13:      /*Undocumented - SLO (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(6);
-                        temp = readmem(addr + y);
+                        temp = fast_readmem(addr + y);
                         polltime(1);
-                        writemem(addr + y, temp);
+                        fast_writemem(addr + y, temp);
                         polltime(1);
                         p.c = temp & 0x80;
                         temp <<= 1;
-                        writemem(addr + y, temp);
+                        fast_writemem(addr + y, temp);
                         a |= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x14:      /*Undocumented - NOP zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        readmem((addr + x) & 0xFF);
+                        fast_readmem((addr + x) & 0xFF);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x15:      /*ORA zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        a |= readmem((addr + x) & 0xFF);
+                        a |= fast_readmem((addr + x) & 0xFF);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x16:      /*ASL zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (fast_readmem(pc) + x) & 0xFF;
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         p.c = temp & 0x80;
                         temp <<= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x17:      /*Undocumented - SLO zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (fast_readmem(pc) + x) & 0xFF;
                         pc++;
                         polltime(3);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(1);
                         p.c = temp & 0x80;
                         temp <<= 1;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(1);
                         a |= temp;
                         setzn(a);
@@ -1585,7 +1577,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a |= readmem(addr + y);
+                        a |= fast_readmem(addr + y);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -1599,13 +1591,13 @@ void m6502_exec(int slice)
                 case 0x1B:      /*Undocumented - SLO abs,y */
                         addr = getw() + y;
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(1);
                         p.c = temp & 0x80;
                         temp <<= 1;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         a |= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
@@ -1615,7 +1607,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        readmem(addr);
+                        fast_readmem(addr);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
@@ -1627,20 +1619,20 @@ void m6502_exec(int slice)
                         addr += x;
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a |= readmem(addr);
+                        a |= fast_readmem(addr);
                         setzn(a);
                         break;
 
                 case 0x1E:      /*ASL abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += x;
-                        temp = readmem(addr);
-                        writemem(addr, temp);
+                        temp = fast_readmem(addr);
+                        fast_writemem(addr, temp);
                         p.c = temp & 0x80;
                         temp <<= 1;
                         takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         polltime(7);
                         break;
@@ -1648,62 +1640,62 @@ void m6502_exec(int slice)
                 case 0x1F:      /*Undocumented - SLO abs,x */
                         addr = getw() + x;
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(1);
                         p.c = temp & 0x80;
                         temp <<= 1;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         a |= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x20:      /*JSR*/
-                        addr = readmem(pc++);
+                        addr = fast_readmem(pc++);
                         push(pc >> 8);
                         push((uint8_t)pc);
-                        pc = addr | (readmem(pc) << 8);
+                        pc = addr | (fast_readmem(pc) << 8);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         polltime(1);
                         break;
 
                 case 0x21:      /*AND (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a &= readmem(addr);
+                        a &= fast_readmem(addr);
                         setzn(a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x23:      /*Undocumented - RLA (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(6);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(1);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         a &= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x24:      /*BIT zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         p.z = !(a & temp);
                         p.v = temp & 0x40;
                         p.n = temp & 0x80;
@@ -1712,39 +1704,39 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x25:      /*AND zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        a &= readmem(addr);
+                        a &= fast_readmem(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x26:      /*ROL zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x27:      /*Undocumented - RLA zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         a &= temp;
                         setzn(a);
                         polltime(5);
@@ -1759,7 +1751,7 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x29:
-                        /*AND*/ a &= readmem(pc);
+                        /*AND*/ a &= fast_readmem(pc);
                         pc++;
                         setzn(a);
                         polltime(2);
@@ -1778,7 +1770,7 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x2B:      /*Undocumented - ANC imm */
-                        a &= readmem(pc);
+                        a &= fast_readmem(pc);
                         pc++;
                         setzn(a);
                         p.c = p.n;
@@ -1790,7 +1782,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         p.z = !(a & temp);
                         p.v = temp & 0x40;
                         p.n = temp & 0x80;
@@ -1800,16 +1792,16 @@ void m6502_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a &= readmem(addr);
+                        a &= fast_readmem(addr);
                         setzn(a);
                         break;
 
                 case 0x2E:      /*ROL abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
@@ -1819,19 +1811,19 @@ void m6502_exec(int slice)
                         polltime(1);
                         if (!takeint)
                                 takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         break;
 
                 case 0x2F:      /*Undocumented - RLA abs */
                         addr = getw();  /*Found in The Hobbit */
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         a &= temp;
                         setzn(a);
                         polltime(6);
@@ -1839,7 +1831,7 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x30:
-                        /*BMI*/ offset = (int8_t) readmem(pc);
+                        /*BMI*/ offset = (int8_t) fast_readmem(pc);
                         pc++;
                         temp = 2;
                         if (p.n) {
@@ -1852,81 +1844,81 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x31:      /*AND (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a &= readmem(addr + y);
+                        a &= fast_readmem(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x33:      /*Undocumented - RLA (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(6);
-                        temp = readmem(addr + y);
+                        temp = fast_readmem(addr + y);
                         polltime(1);
-                        writemem(addr + y, temp);
+                        fast_writemem(addr + y, temp);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
                         polltime(1);
-                        writemem(addr + y, temp);
+                        fast_writemem(addr + y, temp);
                         a &= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x34:      /*Undocumented - NOP zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        readmem((addr + x) & 0xFF);
+                        fast_readmem((addr + x) & 0xFF);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x35:      /*AND zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        a &= readmem((addr + x) & 0xFF);
+                        a &= fast_readmem((addr + x) & 0xFF);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x36:      /*ROL zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
                         addr += x;
                         addr &= 0xFF;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x37:      /*Undocumented - RLA zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (fast_readmem(pc) + x) & 0xFF;
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         a &= temp;
                         setzn(a);
                         polltime(6);
@@ -1943,7 +1935,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a &= readmem(addr + y);
+                        a &= fast_readmem(addr + y);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -1957,16 +1949,16 @@ void m6502_exec(int slice)
                 case 0x3B:      /*Undocumented - RLA abs,y */
                         addr = getw() + y;
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         a &= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
@@ -1976,7 +1968,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        readmem(addr + x);
+                        fast_readmem(addr + x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
@@ -1986,7 +1978,7 @@ void m6502_exec(int slice)
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
                         addr += x;
-                        a &= readmem(addr);
+                        a &= fast_readmem(addr);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -1994,16 +1986,16 @@ void m6502_exec(int slice)
 
                 case 0x3E:      /*ROL abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += x;
-                        temp = readmem(addr);
-                        writemem(addr, temp);
+                        temp = fast_readmem(addr);
+                        fast_writemem(addr, temp);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         polltime(7);
                         takeint = (interrupt && !p.i);
@@ -2012,16 +2004,16 @@ void m6502_exec(int slice)
                 case 0x3F:      /*Undocumented - RLA abs,x */
                         addr = getw() + x;
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         a &= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
@@ -2038,72 +2030,72 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x41:      /*EOR (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a ^= readmem(addr);
+                        a ^= fast_readmem(addr);
                         setzn(a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x43:      /*Undocumented - SRE (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(6);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         p.c = temp & 1;
                         temp >>= 1;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         a ^= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x44:      /*Undocumented - NOP zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        readmem(addr);
+                        fast_readmem(addr);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x45:      /*EOR zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        a ^= readmem(addr);
+                        a ^= fast_readmem(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x46:      /*LSR zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         p.c = temp & 1;
                         temp >>= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x47:      /*Undocumented - SRE zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
                         polltime(3);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         p.c = temp & 1;
                         temp >>= 1;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         a ^= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
@@ -2116,7 +2108,7 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x49:      /*EOR imm */
-                        a ^= readmem(pc);
+                        a ^= fast_readmem(pc);
                         pc++;
                         setzn(a);
                         polltime(2);
@@ -2132,7 +2124,7 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x4B:      /*Undocumented - ASR imm */
-                        a &= readmem(pc);
+                        a &= fast_readmem(pc);
                         pc++;
                         p.c = a & 1;
                         a >>= 1;
@@ -2152,16 +2144,16 @@ void m6502_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a ^= readmem(addr);
+                        a ^= fast_readmem(addr);
                         setzn(a);
                         break;
 
                 case 0x4E:      /*LSR abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         takeint = ((interrupt & 128) && !p.i);  // takeint=1;
                         polltime(1);
                         if (!takeint)
@@ -2169,26 +2161,26 @@ void m6502_exec(int slice)
                         p.c = temp & 1;
                         temp >>= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         break;
 
                 case 0x4F:      /*Undocumented - SRE abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         p.c = temp & 1;
                         temp >>= 1;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         a ^= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x50:
-                        /*BVC*/ offset = (int8_t) readmem(pc);
+                        /*BVC*/ offset = (int8_t) fast_readmem(pc);
                         pc++;
                         temp = 2;
                         if (!p.v) {
@@ -2201,74 +2193,74 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x51:      /*EOR (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a ^= readmem(addr + y);
+                        a ^= fast_readmem(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x53:      /*Undocumented - SRE (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp) + y;
                         polltime(6);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         p.c = temp & 1;
                         temp >>= 1;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         a ^= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x54:      /*Undocumented - NOP zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        readmem((addr + x) & 0xFF);
+                        fast_readmem((addr + x) & 0xFF);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x55:      /*EOR zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        a ^= readmem((addr + x) & 0xFF);
+                        a ^= fast_readmem((addr + x) & 0xFF);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x56:      /*LSR zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (fast_readmem(pc) + x) & 0xFF;
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         p.c = temp & 1;
                         temp >>= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x57:      /*Undocumented - SRE zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (fast_readmem(pc) + x) & 0xFF;
                         pc++;
                         polltime(3);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         p.c = temp & 1;
                         temp >>= 1;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(1);
                         a ^= temp;
                         setzn(a);
@@ -2285,7 +2277,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a ^= readmem(addr + y);
+                        a ^= fast_readmem(addr + y);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -2299,13 +2291,13 @@ void m6502_exec(int slice)
                 case 0x5B:      /*Undocumented - SRE abs,y */
                         addr = getw() + y;
                         polltime(5);
-                        temp = readmem(addr + y);
+                        temp = fast_readmem(addr + y);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         p.c = temp & 1;
                         temp >>= 1;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         a ^= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
@@ -2315,10 +2307,10 @@ void m6502_exec(int slice)
                         addr = getw();
                         polltime(4);
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00)) {
-                                readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                                fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                                 polltime(1);
                         }
-                        readmem(addr + x);
+                        fast_readmem(addr + x);
                         takeint = (interrupt && !p.i);
                         break;
 
@@ -2326,24 +2318,24 @@ void m6502_exec(int slice)
                         addr = getw();
                         polltime(4);
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00)) {
-                                readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                                fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                                 polltime(1);
                         }
                         addr += x;
-                        a ^= readmem(addr);
+                        a ^= fast_readmem(addr);
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x5E:      /*LSR abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += x;
-                        temp = readmem(addr);
-                        writemem(addr, temp);
+                        temp = fast_readmem(addr);
+                        fast_writemem(addr, temp);
                         p.c = temp & 1;
                         temp >>= 1;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         polltime(7);
                         takeint = (interrupt && !p.i);
@@ -2352,13 +2344,13 @@ void m6502_exec(int slice)
                 case 0x5F:      /*Undocumented - SRE abs,x */
                         addr = getw() + x;
                         polltime(5);
-                        temp = readmem(addr + x);
+                        temp = fast_readmem(addr + x);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         p.c = temp & 1;
                         temp >>= 1;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         a ^= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
@@ -2374,80 +2366,80 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x61:      /*ADC (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         adc_nmos(temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x63:      /*Undocumented - RRA (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(6);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         tempi = temp & 1;
                         temp >>= 1;
                         if (p.c)
                             temp |= 0x80;
                         p.c = tempi;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         adc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x64:      /*Undocumented - NOP zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        readmem(addr);
+                        fast_readmem(addr);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x65:      /*ADC zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         adc_nmos(temp);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x66:      /*ROR zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         tempi = p.c;
                         p.c = temp & 1;
                         temp >>= 1;
                         if (tempi)
                                 temp |= 0x80;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x67:      /*Undocumented - RRA zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
                         polltime(3);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         tempi = temp & 1;
                         temp >>= 1;
                         if (p.c)
                             temp |= 0x80;
                         p.c = tempi;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         adc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
@@ -2460,7 +2452,7 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x69:      /*ADC imm */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         adc_nmos(temp);
                         polltime(2);
@@ -2485,10 +2477,10 @@ void m6502_exec(int slice)
                 case 0x6C:      /*JMP () */
                         addr = getw();
                         if ((addr & 0xFF) == 0xFF)
-                                pc = readmem(addr) | (readmem(addr - 0xFF) <<
+                                pc = fast_readmem(addr) | (fast_readmem(addr - 0xFF) <<
                                                       8);
                         else
-                                pc = readmem(addr) | (readmem(addr + 1) << 8);
+                                pc = fast_readmem(addr) | (fast_readmem(addr + 1) << 8);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
@@ -2497,17 +2489,17 @@ void m6502_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         adc_nmos(temp);
                         break;
 
                 case 0x6E:      /*ROR abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         if ((interrupt & 128) && !p.i)
                                 takeint = 1;
                         polltime(1);
@@ -2519,28 +2511,28 @@ void m6502_exec(int slice)
                         if (tempi)
                                 temp |= 0x80;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         break;
 
                 case 0x6F:      /*Undocumented - RRA abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         tempi = temp & 1;
                         temp >>= 1;
                         if (p.c)
                             temp |= 0x80;
                         p.c = tempi;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         adc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x70:
-                        /*BVS*/ offset = (int8_t) readmem(pc);
+                        /*BVS*/ offset = (int8_t) fast_readmem(pc);
                         pc++;
                         temp = 2;
                         if (p.v) {
@@ -2553,84 +2545,84 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x71:      /*ADC (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = fast_readmem(addr + y);
                         adc_nmos(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x73:      /*Undocumented - RRA (,y) */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(6);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         tempi = temp & 1;
                         temp >>= 1;
                         if (p.c)
                             temp |= 0x80;
                         p.c = tempi;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         adc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x74:      /*Undocumented - NOP zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        readmem((addr + x) & 0xFF);
+                        fast_readmem((addr + x) & 0xFF);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x75:      /*ADC zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF);
+                        temp = fast_readmem((addr + x) & 0xFF);
                         adc_nmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x76:      /*ROR zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
                         addr += x;
                         addr &= 0xFF;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         tempi = p.c;
                         p.c = temp & 1;
                         temp >>= 1;
                         if (tempi)
                                 temp |= 0x80;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x77:      /*Undocumented - RRA zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (fast_readmem(pc) + x) & 0xFF;
                         pc++;
                         polltime(3);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         tempi = temp & 1;
                         temp >>= 1;
                         if (p.c)
                             temp |= 0x80;
                         p.c = tempi;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(1);
                         adc_nmos(temp);
                         takeint = (interrupt && !p.i);
@@ -2646,7 +2638,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = fast_readmem(addr + y);
                         adc_nmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -2660,16 +2652,16 @@ void m6502_exec(int slice)
                 case 0x7B:      /*Undocumented - RRA abs,y */
                         addr = getw() + y;
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         tempi = temp & 1;
                         temp >>= 1;
                         if (p.c)
                             temp |= 0x80;
                         p.c = tempi;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         adc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
@@ -2678,7 +2670,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        readmem(addr);
+                        fast_readmem(addr);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
@@ -2688,7 +2680,7 @@ void m6502_exec(int slice)
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
                         addr += x;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         adc_nmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -2696,16 +2688,16 @@ void m6502_exec(int slice)
 
                 case 0x7E:      /*ROR abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += x;
-                        temp = readmem(addr);
-                        writemem(addr, temp);
+                        temp = fast_readmem(addr);
+                        fast_writemem(addr, temp);
                         tempi = p.c;
                         p.c = temp & 1;
                         temp >>= 1;
                         if (tempi)
                                 temp |= 0x80;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         polltime(7);
                         takeint = (interrupt && !p.i);
@@ -2714,80 +2706,80 @@ void m6502_exec(int slice)
                 case 0x7F:      /*Undocumented - RRA abs,x */
                         addr = getw();
                         polltime(5);
-                        temp = readmem(addr + x);
+                        temp = fast_readmem(addr + x);
                         polltime(1);
-                        writemem(addr + x, temp);
+                        fast_writemem(addr + x, temp);
                         tempi = temp & 1;
                         temp >>= 1;
                         if (p.c)
                             temp |= 0x80;
                         p.c = tempi;
                         polltime(1);
-                        writemem(addr + x, temp);
+                        fast_writemem(addr + x, temp);
                         adc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x80:      /*Undocumented - NOP imm */
-                        readmem(pc);
+                        fast_readmem(pc);
                         pc++;
                         polltime(2);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x81:      /*STA (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        writemem(addr, a);
+                        fast_writemem(addr, a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x82:      /*Undocumented - NOP imm *//*Should sometimes lock up the machine */
-                        readmem(pc);
+                        fast_readmem(pc);
                         pc++;
                         polltime(2);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x83:      /*Undocumented - SAX (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        writemem(addr, a & x);
+                        fast_writemem(addr, a & x);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x84:      /*STY zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        writemem(addr, y);
+                        fast_writemem(addr, y);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x85:      /*STA zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        writemem(addr, a);
+                        fast_writemem(addr, a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x86:      /*STX zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        writemem(addr, x);
+                        fast_writemem(addr, x);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x87:      /*Undocumented - SAX zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        writemem(addr, a & x);
+                        fast_writemem(addr, a & x);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
@@ -2800,7 +2792,7 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x89:      /*Undocumented - NOP imm */
-                        readmem(pc);
+                        fast_readmem(pc);
                         pc++;
                         polltime(2);
                         takeint = (interrupt && !p.i);
@@ -2814,7 +2806,7 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x8B:      /*Undocumented - ANE */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         a = (a | 0xEE) & x & temp;      /*Internal parameter always 0xEE on BBC, always 0xFF on Electron */
                         setzn(a);
@@ -2826,32 +2818,32 @@ void m6502_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, y);
+                        fast_writemem(addr, y);
                         break;
 
                 case 0x8D:      /*STA abs */
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, a);
+                        fast_writemem(addr, a);
                         break;
 
                 case 0x8E:      /*STX abs */
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, x);
+                        fast_writemem(addr, x);
                         break;
 
                 case 0x8F:      /*Undocumented - SAX abs */
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, a & x);
+                        fast_writemem(addr, a & x);
                         break;
 
                 case 0x90:
-                        /*BCC*/ offset = (int8_t) readmem(pc);
+                        /*BCC*/ offset = (int8_t) fast_readmem(pc);
                         pc++;
                         temp = 2;
                         if (!p.c) {
@@ -2864,51 +2856,51 @@ void m6502_exec(int slice)
                         break;
 
                 case 0x91:      /*STA (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp) + y;
-                        writemem(addr, a);
+                        fast_writemem(addr, a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x93:      /*Undocumented - SHA (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
-                        writemem(addr + y, a & x & ((addr >> 8) + 1));
+                        fast_writemem(addr + y, a & x & ((addr >> 8) + 1));
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x94:      /*STY zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        writemem((addr + x) & 0xFF, y);
+                        fast_writemem((addr + x) & 0xFF, y);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x95:      /*STA zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        writemem((addr + x) & 0xFF, a);
+                        fast_writemem((addr + x) & 0xFF, a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x96:      /*STX zp,y */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        writemem((addr + y) & 0xFF, x);
+                        fast_writemem((addr + y) & 0xFF, x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x97:      /*Undocumented - SAX zp,y */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        writemem((addr + y) & 0xFF, a & x);
+                        fast_writemem((addr + y) & 0xFF, a & x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
@@ -2923,10 +2915,10 @@ void m6502_exec(int slice)
                 case 0x99:      /*STA abs,y */
                         addr = getw();
                         polltime(4);
-                        readmem((addr & 0xFF00) | ((addr + y) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + y) & 0xFF));
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr + y, a);
+                        fast_writemem(addr + y, a);
                         break;
 
                 case 0x9A:
@@ -2937,8 +2929,8 @@ void m6502_exec(int slice)
 
                 case 0x9B:      /*Undocumented - SHS abs,y */
                         addr = getw();
-                        readmem((addr & 0xFF00) + ((addr + y) & 0xFF));
-                        writemem(addr + y, a & x & ((addr >> 8) + 1));
+                        fast_readmem((addr & 0xFF00) + ((addr + y) & 0xFF));
+                        fast_writemem(addr + y, a & x & ((addr >> 8) + 1));
                         s = a & x;
                         polltime(5);
                         takeint = (interrupt && !p.i);
@@ -2946,8 +2938,8 @@ void m6502_exec(int slice)
 
                 case 0x9C:      /*Undocumented - SHY abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) + ((addr + x) & 0xFF));
-                        writemem(addr + x, y & ((addr >> 8) + 1));
+                        fast_readmem((addr & 0xFF00) + ((addr + x) & 0xFF));
+                        fast_writemem(addr + x, y & ((addr >> 8) + 1));
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
@@ -2955,32 +2947,32 @@ void m6502_exec(int slice)
                 case 0x9D:      /*STA abs,x */
                         addr = getw();
                         polltime(4);
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr + x, a);
+                        fast_writemem(addr + x, a);
                         break;
 
                 case 0x9E:      /*Undocumented - SHX abs,y */
                         addr = getw();
                         polltime(4);
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr + y, x & ((addr >> 8) + 1));
+                        fast_writemem(addr + y, x & ((addr >> 8) + 1));
                         break;
 
                 case 0x9F:      /*Undocumented - SHA abs,y */
                         addr = getw();
                         polltime(4);
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr + y, a & x & ((addr >> 8) + 1));
+                        fast_writemem(addr + y, a & x & ((addr >> 8) + 1));
                         break;
 
                 case 0xA0:      /*LDY imm */
-                        y = readmem(pc);
+                        y = fast_readmem(pc);
                         pc++;
                         setzn(y);
                         polltime(2);
@@ -2988,17 +2980,17 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xA1:      /*LDA (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a = readmem(addr);
+                        a = fast_readmem(addr);
                         setzn(a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xA2:      /*LDX imm */
-                        x = readmem(pc);
+                        x = fast_readmem(pc);
                         pc++;
                         setzn(x);
                         polltime(2);
@@ -3006,46 +2998,46 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xA3:      /*Undocumented - LAX (,y) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a = x = readmem(addr);
+                        a = x = fast_readmem(addr);
                         setzn(a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xA4:      /*LDY zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        y = readmem(addr);
+                        y = fast_readmem(addr);
                         setzn(y);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xA5:      /*LDA zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        a = readmem(addr);
+                        a = fast_readmem(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xA6:      /*LDX zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        x = readmem(addr);
+                        x = fast_readmem(addr);
                         setzn(x);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xA7:      /*Undocumented - LAX zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        a = x = readmem(addr);
+                        a = x = fast_readmem(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
@@ -3059,7 +3051,7 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xA9:      /*LDA imm */
-                        a = readmem(pc);
+                        a = fast_readmem(pc);
                         pc++;
                         setzn(a);
                         polltime(1);
@@ -3075,7 +3067,7 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xAB:      /*Undocumented - LAX */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         a = x = ((a | 0xEE) & temp);    /*WAAAAY more complicated than this, but it varies from machine to machine anyway */
                         setzn(a);
@@ -3087,7 +3079,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        y = readmem(addr);
+                        y = fast_readmem(addr);
                         setzn(y);
                         break;
 
@@ -3095,7 +3087,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a = readmem(addr);
+                        a = fast_readmem(addr);
                         setzn(a);
                         break;
 
@@ -3103,7 +3095,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        x = readmem(addr);
+                        x = fast_readmem(addr);
                         setzn(x);
                         break;
 
@@ -3111,12 +3103,12 @@ void m6502_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a = x = readmem(addr);
+                        a = x = fast_readmem(addr);
                         setzn(a);
                         break;
 
                 case 0xB0:
-                        /*BCS*/ offset = (int8_t) readmem(pc);
+                        /*BCS*/ offset = (int8_t) fast_readmem(pc);
                         pc++;
                         temp = 2;
                         if (p.c) {
@@ -3129,60 +3121,60 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xB1:      /*LDA (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a = readmem(addr + y);
+                        a = fast_readmem(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xB3:      /*LAX (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a = x = readmem(addr + y);
+                        a = x = fast_readmem(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xB4:      /*LDY zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        y = readmem((addr + x) & 0xFF);
+                        y = fast_readmem((addr + x) & 0xFF);
                         setzn(y);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xB5:      /*LDA zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        a = readmem((addr + x) & 0xFF);
+                        a = fast_readmem((addr + x) & 0xFF);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xB6:      /*LDX zp,y */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        x = readmem((addr + y) & 0xFF);
+                        x = fast_readmem((addr + y) & 0xFF);
                         setzn(x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xB7:      /*LAX zp,y */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        a = x = readmem((addr + y) & 0xFF);
+                        a = x = fast_readmem((addr + y) & 0xFF);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -3199,7 +3191,7 @@ void m6502_exec(int slice)
                         polltime(3);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a = readmem(addr + y);
+                        a = fast_readmem(addr + y);
                         setzn(a);
                         polltime(1);
                         takeint = (interrupt && !p.i);
@@ -3217,7 +3209,7 @@ void m6502_exec(int slice)
                         polltime(3);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a = x = s = s & readmem(addr + y);      /*No, really! */
+                        a = x = s = s & fast_readmem(addr + y);      /*No, really! */
                         setzn(a);
                         polltime(1);
                         takeint = (interrupt && !p.i);
@@ -3227,7 +3219,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        y = readmem(addr + x);
+                        y = fast_readmem(addr + x);
                         setzn(y);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -3237,7 +3229,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        a = readmem(addr + x);
+                        a = fast_readmem(addr + x);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -3247,7 +3239,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        x = readmem(addr + y);
+                        x = fast_readmem(addr + y);
                         setzn(x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -3257,14 +3249,14 @@ void m6502_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a = x = readmem(addr + y);
+                        a = x = fast_readmem(addr + y);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xC0:      /*CPY imm */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         setzn(y - temp);
                         p.c = (y >= temp);
@@ -3273,10 +3265,10 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xC1:      /*CMP (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(6);
@@ -3284,32 +3276,32 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xC2:      /*Undocumented - NOP imm *//*Should sometimes lock up the machine */
-                        readmem(pc);
+                        fast_readmem(pc);
                         pc++;
                         polltime(2);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xC3:      /*Undocumented - DCP (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(6);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         temp--;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xC4:      /*CPY zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         setzn(y - temp);
                         p.c = (y >= temp);
                         polltime(3);
@@ -3317,9 +3309,9 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xC5:      /*CMP zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(3);
@@ -3327,20 +3319,20 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xC6:      /*DEC zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr) - 1;
-                        writemem(addr, temp);
+                        temp = fast_readmem(addr) - 1;
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xC7:      /*Undocumented - DCP zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr) - 1;
-                        writemem(addr, temp);
+                        temp = fast_readmem(addr) - 1;
+                        fast_writemem(addr, temp);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(5);
@@ -3355,7 +3347,7 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xC9:      /*CMP imm */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         setzn(a - temp);
                         p.c = (a >= temp);
@@ -3371,7 +3363,7 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xCB:      /*Undocumented - SBX imm */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         setzn((a & x) - temp);
                         p.c = ((a & x) >= temp);
@@ -3384,7 +3376,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         setzn(y - temp);
                         p.c = (y >= temp);
                         break;
@@ -3393,7 +3385,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         break;
@@ -3401,22 +3393,22 @@ void m6502_exec(int slice)
                 case 0xCE:      /*DEC abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr) - 1;
+                        temp = fast_readmem(addr) - 1;
                         polltime(1);
 //                                takeint=(interrupt && !p.i);
-                        writemem(addr, temp + 1);
+                        fast_writemem(addr, temp + 1);
                         takeint = ((interrupt & 128) && !p.i);  // takeint=1;
                         polltime(1);
                         if (!takeint)
                                 takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         break;
 
                 case 0xCF:      /*Undocumented - DCP abs */
                         addr = getw();
-                        temp = readmem(addr) - 1;
-                        writemem(addr, temp);
+                        temp = fast_readmem(addr) - 1;
+                        fast_writemem(addr, temp);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(6);
@@ -3424,7 +3416,7 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xD0:
-                        /*BNE*/ offset = (int8_t) readmem(pc);
+                        /*BNE*/ offset = (int8_t) fast_readmem(pc);
                         pc++;
                         temp = 2;
                         if (!p.z) {
@@ -3437,12 +3429,12 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xD1:      /*CMP (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = fast_readmem(addr + y);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(5);
@@ -3450,32 +3442,32 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xD3:      /*Undocumented - DCP (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp) + y;
                         polltime(6);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(1);
-                        writemem(addr, --temp);
+                        fast_writemem(addr, --temp);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xD4:      /*Undocumented - NOP zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        readmem((addr + x) & 0xFF);
+                        fast_readmem((addr + x) & 0xFF);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xD5:      /*CMP zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF);
+                        temp = fast_readmem((addr + x) & 0xFF);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(4);
@@ -3483,20 +3475,20 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xD6:      /*DEC zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF) - 1;
+                        temp = fast_readmem((addr + x) & 0xFF) - 1;
                         setzn(temp);
-                        writemem((addr + x) & 0xFF, temp);
+                        fast_writemem((addr + x) & 0xFF, temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xD7:      /*Undocumented - DCP zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (fast_readmem(pc) + x) & 0xFF;
                         pc++;
-                        temp = readmem(addr) - 1;
-                        writemem(addr, temp);
+                        temp = fast_readmem(addr) - 1;
+                        fast_writemem(addr, temp);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(6);
@@ -3513,7 +3505,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = fast_readmem(addr + y);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(4);
@@ -3527,14 +3519,14 @@ void m6502_exec(int slice)
 
                 case 0xDB:      /*Undocumented - DCP abs,y */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += y;
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(1);
-                        writemem(addr, --temp);
+                        fast_writemem(addr, --temp);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         takeint = (interrupt && !p.i);
@@ -3544,7 +3536,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        readmem(addr + x);
+                        fast_readmem(addr + x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
@@ -3553,7 +3545,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + x);
+                        temp = fast_readmem(addr + x);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(4);
@@ -3562,35 +3554,35 @@ void m6502_exec(int slice)
 
                 case 0xDE:      /*DEC abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += x;
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(1);
-                        writemem(addr, --temp);
+                        fast_writemem(addr, --temp);
                         setzn(temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xDF:      /*Undocumented - DCP abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += x;
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(1);
-                        writemem(addr, --temp);
+                        fast_writemem(addr, --temp);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE0:      /*CPX imm */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         setzn(x - temp);
                         p.c = (x >= temp);
@@ -3599,41 +3591,41 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xE1:      /*SBC (,x) *//*This was missed out of every B-em version since 0.6 as it was never used! */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         sbc_nmos(temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE2:      /*Undocumented - NOP imm *//*Should sometimes lock up the machine */
-                        readmem(pc);
+                        fast_readmem(pc);
                         pc++;
                         polltime(2);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE3:      /*Undocumented - ISB (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(6);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         temp++;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         sbc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE4:      /*CPX zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         setzn(x - temp);
                         p.c = (x >= temp);
                         polltime(3);
@@ -3641,34 +3633,34 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xE5:      /*SBC zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         sbc_nmos(temp);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE6:      /*INC zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr) + 1;
-                        writemem(addr, temp);
+                        temp = fast_readmem(addr) + 1;
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE7:      /*Undocumented - ISB zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
                         polltime(3);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         temp++;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         sbc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
@@ -3681,7 +3673,7 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xE9:      /*SBC imm */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         sbc_nmos(temp);
                         polltime(2);
@@ -3694,7 +3686,7 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xEB:      /*Undocumented - SBC imm */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         sbc_nmos(temp);
                         polltime(2);
@@ -3705,7 +3697,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         setzn(x - temp);
                         p.c = (x >= temp);
                         break;
@@ -3714,40 +3706,40 @@ void m6502_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         sbc_nmos(temp);
                         break;
 
                 case 0xEE:      /*INC abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr) + 1;
+                        temp = fast_readmem(addr) + 1;
                         polltime(1);
-                        writemem(addr, temp - 1);
+                        fast_writemem(addr, temp - 1);
                         if ((interrupt & 128) && !p.i)
                                 takeint = 1;
                         polltime(1);
                         if (interrupt && !p.i)
                                 takeint = 1;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         break;
 
                 case 0xEF:      /*Undocumented - ISB abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         temp++;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         sbc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xF0:
-                        /*BEQ*/ offset = (int8_t) readmem(pc);
+                        /*BEQ*/ offset = (int8_t) fast_readmem(pc);
                         pc++;
                         temp = 2;
                         if (p.z) {
@@ -3761,68 +3753,68 @@ void m6502_exec(int slice)
                         break;
 
                 case 0xF1:      /*SBC (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = fast_readmem(addr + y);
                         sbc_nmos(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xF3:      /*Undocumented - ISB (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp) + y;
                         polltime(6);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         temp++;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         sbc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xF4:      /*Undocumented - NOP zpx */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xF5:      /*SBC zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF);
+                        temp = fast_readmem((addr + x) & 0xFF);
                         sbc_nmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xF6:      /*INC zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF) + 1;
-                        writemem((addr + x) & 0xFF, temp);
+                        temp = fast_readmem((addr + x) & 0xFF) + 1;
+                        fast_writemem((addr + x) & 0xFF, temp);
                         setzn(temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xF7:      /*Undocumented - ISB zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (fast_readmem(pc) + x) & 0xFF;
                         pc++;
                         polltime(3);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         temp++;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(1);
                         sbc_nmos(temp);
                         takeint = (interrupt && !p.i);
@@ -3838,7 +3830,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = fast_readmem(addr + y);
                         sbc_nmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -3852,12 +3844,12 @@ void m6502_exec(int slice)
                 case 0xFB:      /*Undocumented - ISB abs,y */
                         addr = getw() + y;
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         temp++;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         sbc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
@@ -3866,7 +3858,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        readmem(addr + x);
+                        fast_readmem(addr + x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
@@ -3875,7 +3867,7 @@ void m6502_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + x);
+                        temp = fast_readmem(addr + x);
                         sbc_nmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -3883,11 +3875,11 @@ void m6502_exec(int slice)
 
                 case 0xFE:      /*INC abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += x;
-                        temp = readmem(addr) + 1;
-                        writemem(addr, temp - 1);
-                        writemem(addr, temp);
+                        temp = fast_readmem(addr) + 1;
+                        fast_writemem(addr, temp - 1);
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         polltime(7);
                         takeint = (interrupt && !p.i);
@@ -3896,12 +3888,12 @@ void m6502_exec(int slice)
                 case 0xFF:      /*Undocumented - ISB abs,x */
                         addr = getw() + x;
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         temp++;
                         polltime(1);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         sbc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4034,7 +4026,7 @@ void m6502_exec(int slice)
                         push(pc >> 8);
                         push(pc & 0xFF);
                         push(pack_flags(0x20));
-                        pc = readmem(0xFFFE) | (readmem(0xFFFF) << 8);
+                        pc = fast_readmem(0xFFFE) | (fast_readmem(0xFFFF) << 8);
                         p.i = 1;
                         polltime(7);
 //                        log_debug("INT\n");
@@ -4045,21 +4037,22 @@ void m6502_exec(int slice)
                     otherstuff_poll();
                 if (tube_exec && tubecycle > 3.0) {
                     int whole_cycles = (int)tubecycle;
-                    tubecycles += whole_cycles;
                     tubecycle -= whole_cycles;
-                    tube_exec();
+                    HOSTPROF(HOSTPROF_TUBE, tube_run(whole_cycles));
                 }
 
                 if (nmi && !oldnmi) {
                         push(pc >> 8);
                         push(pc & 0xFF);
                         push(pack_flags(0x20));
-                        pc = readmem(0xFFFA) | (readmem(0xFFFB) << 8);
+                        pc = fast_readmem(0xFFFA) | (fast_readmem(0xFFFB) << 8);
                         p.i = 1;
                         polltime(7);
                 }
                 oldnmi = nmi;
         }
+        sched_catchup();
+        hostprof_leave(hostprof_prev);
 }
 
 void m65c02_exec(int slice)
@@ -4070,6 +4063,8 @@ void m65c02_exec(int slice)
         int tempi;
         int8_t offset;
         cycles += slice;
+        hostprof_t hostprof_prev = hostprof_enter(HOSTPROF_CPU);
+        sched_sync();
 //        log_debug("PC = %04X\n",pc);
 //        log_debug("Exec cycles %i\n",cycles);
         while (cycles > 0) {
@@ -4082,7 +4077,7 @@ void m65c02_exec(int slice)
                         push(pc >> 8);
                         push(pc & 0xFF);
                         push(pack_flags(0x30));
-                        pc = readmem(0xFFFE) | (readmem(0xFFFF) << 8);
+                        pc = fast_readmem(0xFFFE) | (fast_readmem(0xFFFF) << 8);
                         p.i = 1;
                         p.d = 0;
                         polltime(7);
@@ -4090,12 +4085,12 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x01:      /*ORA (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
-                        a |= readmem(addr);
+                        a |= fast_readmem(addr);
                         setzn(a);
                         break;
 
@@ -4103,36 +4098,36 @@ void m65c02_exec(int slice)
                         if (dbg_core6502)
                             debug_trap(&core6502_cpu_debug, debug_addr(oldpc), 1);
                         polltime(2);
-                        (void)readmem(pc++);
+                        (void)fast_readmem(pc++);
                         break;
 
                 case 0x04:      /*TSB zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         p.z = !(temp & a);
                         temp |= a;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(5);
                         break;
 
                 case 0x05:      /*ORA zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        a |= readmem(addr);
+                        a |= fast_readmem(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x06:      /*ASL zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         p.c = temp & 0x80;
                         temp <<= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4146,7 +4141,7 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x09:      /*ORA imm */
-                        a |= readmem(pc);
+                        a |= fast_readmem(pc);
                         pc++;
                         setzn(a);
                         polltime(2);
@@ -4163,10 +4158,10 @@ void m65c02_exec(int slice)
 
                 case 0x0C:      /*TSB abs */
                         addr = getw();
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         p.z = !(temp & a);
                         temp |= a;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(6);
                         break;
 
@@ -4174,26 +4169,26 @@ void m65c02_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a |= readmem(addr);
+                        a |= fast_readmem(addr);
                         setzn(a);
                         break;
 
                 case 0x0E:      /*ASL abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        readmem(addr);
+                        fast_readmem(addr);
                         polltime(1);
                         p.c = temp & 0x80;
                         temp <<= 1;
                         setzn(temp);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         break;
 
                 case 0x10:
-                        /*BPL*/ offset = (int8_t) readmem(pc);
+                        /*BPL*/ offset = (int8_t) fast_readmem(pc);
                         pc++;
                         temp = 2;
                         if (!p.n) {
@@ -4206,52 +4201,52 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x11:      /*ORA (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a |= readmem(addr + y);
+                        a |= fast_readmem(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x12:      /*ORA () */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a |= readmem(addr);
+                        a |= fast_readmem(addr);
                         setzn(a);
                         polltime(5);
                         break;
 
                 case 0x14:      /*TRB zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         p.z = !(temp & a);
                         temp &= ~a;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(5);
                         break;
 
                 case 0x15:      /*ORA zp,x */
-                        addr = (readmem(pc++) + x) & 0xff;
-                        a |= readmem(addr);
+                        addr = (fast_readmem(pc++) + x) & 0xff;
+                        a |= fast_readmem(addr);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x16:      /*ASL zp,x */
-                        addr = (readmem(pc++) + x) & 0xFF;
-                        temp = readmem(addr);
-                        writemem(addr, temp);
+                        addr = (fast_readmem(pc++) + x) & 0xFF;
+                        temp = fast_readmem(addr);
+                        fast_writemem(addr, temp);
                         p.c = temp & 0x80;
                         temp <<= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4266,7 +4261,7 @@ void m65c02_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a |= readmem(addr + y);
+                        a |= fast_readmem(addr + y);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -4280,10 +4275,10 @@ void m65c02_exec(int slice)
 
                 case 0x1C:      /*TRB abs */
                         addr = getw();
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         p.z = !(temp & a);
                         temp &= ~a;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(6);
                         break;
 
@@ -4294,41 +4289,41 @@ void m65c02_exec(int slice)
                         addr += x;
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a |= readmem(addr);
+                        a |= fast_readmem(addr);
                         setzn(a);
                         break;
 
                 case 0x1E:      /*ASL abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         tempw =
                             ((addr & 0xFF00) ^ ((addr + x) & 0xFF00)) ? 1 : 0;
                         addr += x;
-                        temp = readmem(addr);
-                        readmem(addr);
+                        temp = fast_readmem(addr);
+                        fast_readmem(addr);
                         p.c = temp & 0x80;
                         temp <<= 1;
                         takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         polltime(6 + tempw);
                         break;
 
                 case 0x20:      /*JSR*/
-                        addr = readmem(pc++);
+                        addr = fast_readmem(pc++);
                         push(pc >> 8);
                         push((uint8_t)pc);
-                        pc = addr | (readmem(pc) << 8);
+                        pc = addr | (fast_readmem(pc) << 8);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         polltime(1);
                         break;
 
                 case 0x21:      /*AND (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a &= readmem(addr);
+                        a &= fast_readmem(addr);
                         setzn(a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
@@ -4346,9 +4341,9 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x24:      /*BIT zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         p.z = !(a & temp);
                         p.v = temp & 0x40;
                         p.n = temp & 0x80;
@@ -4357,25 +4352,25 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x25:      /*AND zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        a &= readmem(addr);
+                        a &= fast_readmem(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x26:      /*ROL zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4388,7 +4383,7 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x29:
-                        /*AND*/ a &= readmem(pc);
+                        /*AND*/ a &= fast_readmem(pc);
                         pc++;
                         setzn(a);
                         polltime(2);
@@ -4411,7 +4406,7 @@ void m65c02_exec(int slice)
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         polltime(1);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         p.z = !(a & temp);
                         p.v = temp & 0x40;
                         p.n = temp & 0x80;
@@ -4421,16 +4416,16 @@ void m65c02_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a &= readmem(addr);
+                        a &= fast_readmem(addr);
                         setzn(a);
                         break;
 
                 case 0x2E:      /*ROL abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        readmem(addr);
+                        fast_readmem(addr);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
@@ -4438,12 +4433,12 @@ void m65c02_exec(int slice)
                                 temp |= 1;
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         break;
 
                 case 0x30:
-                        /*BMI*/ offset = (int8_t) readmem(pc);
+                        /*BMI*/ offset = (int8_t) fast_readmem(pc);
                         pc++;
                         temp = 2;
                         if (p.n) {
@@ -4456,30 +4451,30 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x31:      /*AND (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a &= readmem(addr + y);
+                        a &= fast_readmem(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x32:      /*AND () */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a &= readmem(addr);
+                        a &= fast_readmem(addr);
                         setzn(a);
                         polltime(5);
                         break;
 
                 case 0x34:      /*BIT zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF);
+                        temp = fast_readmem((addr + x) & 0xFF);
                         p.z = !(a & temp);
                         p.v = temp & 0x40;
                         p.n = temp & 0x80;
@@ -4487,24 +4482,24 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x35:      /*AND zp,x */
-                        addr = (readmem(pc++) + x) & 0xff;
-                        a &= readmem(addr);
+                        addr = (fast_readmem(pc++) + x) & 0xff;
+                        a &= fast_readmem(addr);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x36:      /*ROL zp,x */
-                        addr = (readmem(pc++) + x) & 0xff;
-                        temp = readmem(addr);
-                        writemem(addr, temp);
+                        addr = (fast_readmem(pc++) + x) & 0xff;
+                        temp = fast_readmem(addr);
+                        fast_writemem(addr, temp);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4519,7 +4514,7 @@ void m65c02_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a &= readmem(addr + y);
+                        a &= fast_readmem(addr + y);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -4536,7 +4531,7 @@ void m65c02_exec(int slice)
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
                         addr += x;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         p.z = !(a & temp);
                         p.v = temp & 0x40;
                         p.n = temp & 0x80;
@@ -4548,7 +4543,7 @@ void m65c02_exec(int slice)
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
                         addr += x;
-                        a &= readmem(addr);
+                        a &= fast_readmem(addr);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -4556,18 +4551,18 @@ void m65c02_exec(int slice)
 
                 case 0x3E:      /*ROL abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         tempw =
                             ((addr & 0xFF00) ^ ((addr + x) & 0xFF00)) ? 1 : 0;
                         addr += x;
-                        temp = readmem(addr);
-                        readmem(addr);
+                        temp = fast_readmem(addr);
+                        fast_readmem(addr);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         polltime(6 + tempw);
                         takeint = (interrupt && !p.i);
@@ -4583,37 +4578,37 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x41:      /*EOR (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a ^= readmem(addr);
+                        a ^= fast_readmem(addr);
                         setzn(a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x44: /* NOP */
-                        readmem(pc++);
+                        fast_readmem(pc++);
                         polltime(3);
                         break;
 
                 case 0x45:      /*EOR zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        a ^= readmem(addr);
+                        a ^= fast_readmem(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x46:      /*LSR zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         p.c = temp & 1;
                         temp >>= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4625,7 +4620,7 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x49:      /*EOR imm */
-                        a ^= readmem(pc);
+                        a ^= fast_readmem(pc);
                         pc++;
                         setzn(a);
                         polltime(2);
@@ -4651,26 +4646,26 @@ void m65c02_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a ^= readmem(addr);
+                        a ^= fast_readmem(addr);
                         setzn(a);
                         break;
 
                 case 0x4E:      /*LSR abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
-                        readmem(addr);
+                        fast_readmem(addr);
                         polltime(1);
                         p.c = temp & 1;
                         temp >>= 1;
                         setzn(temp);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         break;
 
                 case 0x50:
-                        /*BVC*/ offset = (int8_t) readmem(pc);
+                        /*BVC*/ offset = (int8_t) fast_readmem(pc);
                         pc++;
                         temp = 2;
                         if (!p.v) {
@@ -4683,22 +4678,22 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x51:      /*EOR (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a ^= readmem(addr + y);
+                        a ^= fast_readmem(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x52:      /*EOR () */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a ^= readmem(addr);
+                        a ^= fast_readmem(addr);
                         setzn(a);
                         polltime(5);
                         break;
@@ -4712,21 +4707,21 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x55:      /*EOR zp,x */
-                        addr = (readmem(pc++) + x) & 0xff;
-                        a ^= readmem(addr);
+                        addr = (fast_readmem(pc++) + x) & 0xff;
+                        a ^= fast_readmem(addr);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x56:      /*LSR zp,x */
-                        addr = (readmem(pc++) + x) & 0xFF;
-                        temp = readmem(addr);
-                        writemem(addr, temp);
+                        addr = (fast_readmem(pc++) + x) & 0xFF;
+                        temp = fast_readmem(addr);
+                        fast_writemem(addr, temp);
                         p.c = temp & 1;
                         temp >>= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4741,7 +4736,7 @@ void m65c02_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a ^= readmem(addr + y);
+                        a ^= fast_readmem(addr + y);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -4753,8 +4748,8 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x5C: /* NOP */
-                        readmem(pc++);
-                        readmem(pc++);
+                        fast_readmem(pc++);
+                        fast_readmem(pc++);
                         polltime(8);
                         break;
 
@@ -4762,26 +4757,26 @@ void m65c02_exec(int slice)
                         addr = getw();
                         polltime(4);
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00)) {
-                                readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                                fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                                 polltime(1);
                         }
                         addr += x;
-                        a ^= readmem(addr);
+                        a ^= fast_readmem(addr);
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x5E:      /*LSR abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         tempw =
                             ((addr & 0xFF00) ^ ((addr + x) & 0xFF00)) ? 1 : 0;
                         addr += x;
-                        temp = readmem(addr);
-                        readmem(addr);
+                        temp = fast_readmem(addr);
+                        fast_readmem(addr);
                         p.c = temp & 1;
                         temp >>= 1;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         polltime(6 + tempw);
                         takeint = (interrupt && !p.i);
@@ -4797,42 +4792,42 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x61:      /*ADC (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         adc_cmos(temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x64:      /*STZ zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        writemem(addr, 0);
+                        fast_writemem(addr, 0);
                         polltime(3);
                         break;
 
                 case 0x65:      /*ADC zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         adc_cmos(temp);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x66:      /*ROR zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         tempi = p.c;
                         p.c = temp & 1;
                         temp >>= 1;
                         if (tempi)
                                 temp |= 0x80;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4845,7 +4840,7 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x69:      /*ADC imm */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         adc_cmos(temp);
                         polltime(2);
@@ -4865,7 +4860,7 @@ void m65c02_exec(int slice)
 
                 case 0x6C:      /*JMP () */
                         addr = getw();
-                        pc = readmem(addr) | (readmem(addr + 1) << 8);
+                        pc = fast_readmem(addr) | (fast_readmem(addr + 1) << 8);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4874,17 +4869,17 @@ void m65c02_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         adc_cmos(temp);
                         break;
 
                 case 0x6E:      /*ROR abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        readmem(addr);
+                        fast_readmem(addr);
                         if ((interrupt & 128) && !p.i)
                                 takeint = 1;
                         polltime(1);
@@ -4896,11 +4891,11 @@ void m65c02_exec(int slice)
                         if (tempi)
                                 temp |= 0x80;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         break;
 
                 case 0x70:
-                        /*BVS*/ offset = (int8_t) readmem(pc);
+                        /*BVS*/ offset = (int8_t) fast_readmem(pc);
                         pc++;
                         temp = 2;
                         if (p.v) {
@@ -4913,52 +4908,52 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x71:      /*ADC (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = fast_readmem(addr + y);
                         adc_cmos(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x72:      /*ADC () */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         adc_cmos(temp);
                         polltime(5);
                         break;
 
                 case 0x74:      /*STZ zp,x */
-                        addr = (readmem(pc++) +x) & 0xff;
-                        writemem(addr, 0);
+                        addr = (fast_readmem(pc++) +x) & 0xff;
+                        fast_writemem(addr, 0);
                         polltime(4);
                         break;
 
                 case 0x75:      /*ADC zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF);
+                        temp = fast_readmem((addr + x) & 0xFF);
                         adc_cmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x76:      /*ROR zp,x */
-                        addr = (readmem(pc++) + x) & 0xff;
-                        temp = readmem(addr);
-                        writemem(addr, temp);
+                        addr = (fast_readmem(pc++) + x) & 0xff;
+                        temp = fast_readmem(addr);
+                        fast_writemem(addr, temp);
                         tempi = p.c;
                         p.c = temp & 1;
                         temp >>= 1;
                         if (tempi)
                                 temp |= 0x80;
                         setzn(temp);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4973,7 +4968,7 @@ void m65c02_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = fast_readmem(addr + y);
                         adc_cmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -4988,7 +4983,7 @@ void m65c02_exec(int slice)
                 case 0x7C:      /*JMP (,x) */
                         addr = getw();
                         addr += x;
-                        pc = readmem(addr) | (readmem(addr + 1) << 8);
+                        pc = fast_readmem(addr) | (fast_readmem(addr + 1) << 8);
                         polltime(6);
                         break;
 
@@ -4997,7 +4992,7 @@ void m65c02_exec(int slice)
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
                         addr += x;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         adc_cmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -5005,25 +5000,25 @@ void m65c02_exec(int slice)
 
                 case 0x7E:      /*ROR abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         tempw =
                             ((addr & 0xFF00) ^ ((addr + x) & 0xFF00)) ? 1 : 0;
                         addr += x;
-                        temp = readmem(addr);
-                        readmem(addr);
+                        temp = fast_readmem(addr);
+                        fast_readmem(addr);
                         tempi = p.c;
                         p.c = temp & 1;
                         temp >>= 1;
                         if (tempi)
                                 temp |= 0x80;
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         polltime(6 + tempw);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x80:
-                        /*BRA*/ offset = (int8_t) readmem(pc);
+                        /*BRA*/ offset = (int8_t) fast_readmem(pc);
                         pc++;
                         temp = 3;
                         if ((pc & 0xFF00) ^ ((pc + offset) & 0xFF00))
@@ -5033,34 +5028,34 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x81:      /*STA (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        writemem(addr, a);
+                        fast_writemem(addr, a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x84:      /*STY zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        writemem(addr, y);
+                        fast_writemem(addr, y);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x85:      /*STA zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        writemem(addr, a);
+                        fast_writemem(addr, a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x86:      /*STX zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        writemem(addr, x);
+                        fast_writemem(addr, x);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
@@ -5073,7 +5068,7 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x89:      /*BIT imm */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         p.z = !(a & temp);
                         polltime(2);
@@ -5090,7 +5085,7 @@ void m65c02_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, y);
+                        fast_writemem(addr, y);
                         break;
 
                 case 0x8D:      /*STA abs */
@@ -5098,18 +5093,18 @@ void m65c02_exec(int slice)
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         polltime(1);
-                        writemem(addr, a);
+                        fast_writemem(addr, a);
                         break;
 
                 case 0x8E:      /*STX abs */
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, x);
+                        fast_writemem(addr, x);
                         break;
 
                 case 0x90:
-                        /*BCC*/ offset = (int8_t) readmem(pc);
+                        /*BCC*/ offset = (int8_t) fast_readmem(pc);
                         pc++;
                         temp = 2;
                         if (!p.c) {
@@ -5122,41 +5117,41 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0x91:      /*STA (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp) + y;
-                        writemem(addr, a);
+                        fast_writemem(addr, a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x92:      /*STA () */
-                        temp = readmem(pc++);
+                        temp = fast_readmem(pc++);
                         addr = read_zp_indirect(temp);
-                        writemem(addr, a);
+                        fast_writemem(addr, a);
                         polltime(5);
                         break;
 
                 case 0x94:      /*STY zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        writemem((addr + x) & 0xFF, y);
+                        fast_writemem((addr + x) & 0xFF, y);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x95:      /*STA zp,x */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        writemem((addr + x) & 0xFF, a);
+                        fast_writemem((addr + x) & 0xFF, a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x96:      /*STX zp,y */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        writemem((addr + y) & 0xFF, x);
+                        fast_writemem((addr + y) & 0xFF, x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
@@ -5171,10 +5166,10 @@ void m65c02_exec(int slice)
                 case 0x99:      /*STA abs,y */
                         addr = getw();
                         polltime(4);
-                        readmem((addr & 0xFF00) | ((addr + y) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + y) & 0xFF));
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr + y, a);
+                        fast_writemem(addr + y, a);
                         break;
 
                 case 0x9A:
@@ -5187,28 +5182,28 @@ void m65c02_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, 0);
+                        fast_writemem(addr, 0);
                         break;
 
                 case 0x9D:      /*STA abs,x */
                         addr = getw();
                         polltime(4);
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr + x, a);
+                        fast_writemem(addr + x, a);
                         break;
 
                 case 0x9E:      /*STZ abs,x */
                         addr = getw();
                         addr += x;
                         polltime(4);
-                        writemem(addr, 0);
+                        fast_writemem(addr, 0);
                         polltime(1);
                         break;
 
                 case 0xA0:      /*LDY imm */
-                        y = readmem(pc);
+                        y = fast_readmem(pc);
                         pc++;
                         setzn(y);
                         polltime(2);
@@ -5216,17 +5211,17 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0xA1:      /*LDA (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a = readmem(addr);
+                        a = fast_readmem(addr);
                         setzn(a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xA2:      /*LDX imm */
-                        x = readmem(pc);
+                        x = fast_readmem(pc);
                         pc++;
                         setzn(x);
                         polltime(2);
@@ -5234,27 +5229,27 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0xA4:      /*LDY zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        y = readmem(addr);
+                        y = fast_readmem(addr);
                         setzn(y);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xA5:      /*LDA zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        a = readmem(addr);
+                        a = fast_readmem(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xA6:      /*LDX zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        x = readmem(addr);
+                        x = fast_readmem(addr);
                         setzn(x);
                         polltime(3);
                         takeint = (interrupt && !p.i);
@@ -5268,7 +5263,7 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0xA9:      /*LDA imm */
-                        a = readmem(pc);
+                        a = fast_readmem(pc);
                         pc++;
                         setzn(a);
                         polltime(1);
@@ -5287,7 +5282,7 @@ void m65c02_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        y = readmem(addr);
+                        y = fast_readmem(addr);
                         setzn(y);
                         break;
 
@@ -5295,7 +5290,7 @@ void m65c02_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a = readmem(addr);
+                        a = fast_readmem(addr);
                         setzn(a);
                         break;
 
@@ -5303,12 +5298,12 @@ void m65c02_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        x = readmem(addr);
+                        x = fast_readmem(addr);
                         setzn(x);
                         break;
 
                 case 0xB0:
-                        /*BCS*/ offset = (int8_t) readmem(pc);
+                        /*BCS*/ offset = (int8_t) fast_readmem(pc);
                         pc++;
                         temp = 2;
                         if (p.c) {
@@ -5321,45 +5316,45 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0xB1:      /*LDA (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a = readmem(addr + y);
+                        a = fast_readmem(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xB2:      /*LDA () */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a = readmem(addr);
+                        a = fast_readmem(addr);
                         setzn(a);
                         polltime(5);
                         break;
 
                 case 0xB4:      /*LDY zp,x */
-                        addr = (readmem(pc++) + x) & 0xff;
-                        y = readmem(addr);
+                        addr = (fast_readmem(pc++) + x) & 0xff;
+                        y = fast_readmem(addr);
                         setzn(y);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xB5:      /*LDA zp,x */
-                        addr = (readmem(pc++) + x) & 0xff;
-                        a = readmem(addr);
+                        addr = (fast_readmem(pc++) + x) & 0xff;
+                        a = fast_readmem(addr);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xB6:      /*LDX zp,y */
-                        addr = (readmem(pc++) + y) & 0xff;
-                        x = readmem(addr);
+                        addr = (fast_readmem(pc++) + y) & 0xff;
+                        x = fast_readmem(addr);
                         setzn(x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -5376,7 +5371,7 @@ void m65c02_exec(int slice)
                         polltime(3);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a = readmem(addr + y);
+                        a = fast_readmem(addr + y);
                         setzn(a);
                         polltime(1);
                         takeint = (interrupt && !p.i);
@@ -5393,7 +5388,7 @@ void m65c02_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        y = readmem(addr + x);
+                        y = fast_readmem(addr + x);
                         setzn(y);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -5403,7 +5398,7 @@ void m65c02_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        a = readmem(addr + x);
+                        a = fast_readmem(addr + x);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -5413,14 +5408,14 @@ void m65c02_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        x = readmem(addr + y);
+                        x = fast_readmem(addr + y);
                         setzn(x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xC0:      /*CPY imm */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         setzn(y - temp);
                         p.c = (y >= temp);
@@ -5429,10 +5424,10 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0xC1:      /*CMP (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(6);
@@ -5440,9 +5435,9 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0xC4:      /*CPY zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         setzn(y - temp);
                         p.c = (y >= temp);
                         polltime(3);
@@ -5450,9 +5445,9 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0xC5:      /*CMP zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(3);
@@ -5460,10 +5455,10 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0xC6:      /*DEC zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr) - 1;
-                        writemem(addr, temp);
+                        temp = fast_readmem(addr) - 1;
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
@@ -5477,7 +5472,7 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0xC9:      /*CMP imm */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         setzn(a - temp);
                         p.c = (a >= temp);
@@ -5504,7 +5499,7 @@ void m65c02_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         setzn(y - temp);
                         p.c = (y >= temp);
                         break;
@@ -5513,7 +5508,7 @@ void m65c02_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         break;
@@ -5521,20 +5516,20 @@ void m65c02_exec(int slice)
                 case 0xCE:      /*DEC abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr) - 1;
+                        temp = fast_readmem(addr) - 1;
                         polltime(1);
 //                                takeint=(interrupt && !p.i);
-                        readmem(addr);
+                        fast_readmem(addr);
                         takeint = ((interrupt & 128) && !p.i);  // takeint=1;
                         polltime(1);
                         if (!takeint)
                                 takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         break;
 
                 case 0xD0:
-                        /*BNE*/ offset = (int8_t) readmem(pc);
+                        /*BNE*/ offset = (int8_t) fast_readmem(pc);
                         pc++;
                         temp = 2;
                         if (!p.z) {
@@ -5547,12 +5542,12 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0xD1:      /*CMP (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = fast_readmem(addr + y);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(5);
@@ -5560,18 +5555,18 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0xD2:      /*CMP () */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(5);
                         break;
 
                 case 0xD5:      /*CMP zp,x */
-                        addr = (readmem(pc++) + x) & 0xff;
-                        temp = readmem(addr);
+                        addr = (fast_readmem(pc++) + x) & 0xff;
+                        temp = fast_readmem(addr);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(4);
@@ -5579,10 +5574,10 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0xD6:      /*DEC zp,x */
-                        addr = (readmem(pc++) + x) & 0xFF;
-                        temp = readmem(addr);
-                        writemem(addr, temp);
-                        writemem(addr, --temp);
+                        addr = (fast_readmem(pc++) + x) & 0xFF;
+                        temp = fast_readmem(addr);
+                        fast_writemem(addr, temp);
+                        fast_writemem(addr, --temp);
                         setzn(temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
@@ -5598,7 +5593,7 @@ void m65c02_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = fast_readmem(addr + y);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(4);
@@ -5621,7 +5616,7 @@ void m65c02_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + x);
+                        temp = fast_readmem(addr + x);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(4);
@@ -5630,18 +5625,18 @@ void m65c02_exec(int slice)
 
                 case 0xDE:      /*DEC abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += x;
-                        temp = readmem(addr) - 1;
-                        readmem(addr);
-                        writemem(addr, temp);
+                        temp = fast_readmem(addr) - 1;
+                        fast_readmem(addr);
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         polltime(7);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE0:      /*CPX imm */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         setzn(x - temp);
                         p.c = (x >= temp);
@@ -5650,19 +5645,19 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0xE1:      /*SBC (,x) */
-                        temp = readmem(pc) + x;
+                        temp = fast_readmem(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         sbc_cmos(temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE4:      /*CPX zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         setzn(x - temp);
                         p.c = (x >= temp);
                         polltime(3);
@@ -5670,19 +5665,19 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0xE5:      /*SBC zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         sbc_cmos(temp);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE6:      /*INC zp */
-                        addr = readmem(pc);
+                        addr = fast_readmem(pc);
                         pc++;
-                        temp = readmem(addr) + 1;
-                        writemem(addr, temp);
+                        temp = fast_readmem(addr) + 1;
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
@@ -5696,7 +5691,7 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0xE9:      /*SBC imm */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         sbc_cmos(temp);
                         polltime(2);
@@ -5712,7 +5707,7 @@ void m65c02_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         setzn(x - temp);
                         p.c = (x >= temp);
                         break;
@@ -5721,24 +5716,24 @@ void m65c02_exec(int slice)
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         sbc_cmos(temp);
                         break;
 
                 case 0xEE:      /*INC abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr) + 1;
+                        temp = fast_readmem(addr) + 1;
                         polltime(1);
-                        readmem(addr);
+                        fast_readmem(addr);
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         break;
 
                 case 0xF0:
-                        /*BEQ*/ offset = (int8_t) readmem(pc);
+                        /*BEQ*/ offset = (int8_t) fast_readmem(pc);
                         pc++;
                         temp = 2;
                         if (p.z) {
@@ -5752,39 +5747,39 @@ void m65c02_exec(int slice)
                         break;
 
                 case 0xF1:      /*SBC (),y */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = fast_readmem(addr + y);
                         sbc_cmos(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xF2:      /*SBC () */
-                        temp = readmem(pc);
+                        temp = fast_readmem(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = fast_readmem(addr);
                         sbc_cmos(temp);
                         polltime(5);
                         break;
 
                 case 0xF5:      /*SBC zp,x */
-                        addr = (readmem(pc++) + x) & 0xff;
-                        temp = readmem(addr);
+                        addr = (fast_readmem(pc++) + x) & 0xff;
+                        temp = fast_readmem(addr);
                         sbc_cmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xF6:      /*INC zp,x */
-                        addr = (readmem(pc++) + x) & 0xff;
-                        temp = readmem(addr);
-                        writemem(addr, temp);
-                        writemem(addr, ++temp);
+                        addr = (fast_readmem(pc++) + x) & 0xff;
+                        temp = fast_readmem(addr);
+                        fast_writemem(addr, temp);
+                        fast_writemem(addr, ++temp);
                         setzn(temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
@@ -5800,7 +5795,7 @@ void m65c02_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = fast_readmem(addr + y);
                         sbc_cmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -5816,7 +5811,7 @@ void m65c02_exec(int slice)
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + x);
+                        temp = fast_readmem(addr + x);
                         sbc_cmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -5824,11 +5819,11 @@ void m65c02_exec(int slice)
 
                 case 0xFE:      /*INC abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        fast_readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += x;
-                        temp = readmem(addr) + 1;
-                        readmem(addr);
-                        writemem(addr, temp);
+                        temp = fast_readmem(addr) + 1;
+                        fast_readmem(addr);
+                        fast_writemem(addr, temp);
                         setzn(temp);
                         polltime(7);
                         takeint = (interrupt && !p.i);
@@ -5868,7 +5863,7 @@ void m65c02_exec(int slice)
                         if (p.n)
                                 temp |= 0x80;
                         push(temp);
-                        pc = readmem(0xFFFE) | (readmem(0xFFFF) << 8);
+                        pc = fast_readmem(0xFFFE) | (fast_readmem(0xFFFF) << 8);
                         p.i = 1;
                         p.d = 0;
                         polltime(7);
@@ -5879,9 +5874,8 @@ void m65c02_exec(int slice)
                 interrupt &= ~128;
                 if (tube_exec && tubecycle >= 3.0 && !(tubeula.r1stat & TUBE_STAT_P)) {
                     int whole_cycles = (int)tubecycle;
-                    tubecycles += whole_cycles;
                     tubecycle -= whole_cycles;
-                    tube_exec();
+                    HOSTPROF(HOSTPROF_TUBE, tube_run(whole_cycles));
                 }
 
                 if (otherstuffcount <= 0)
@@ -5891,7 +5885,7 @@ void m65c02_exec(int slice)
                         push(pc & 0xFF);
                         temp = pack_flags(0x20);
                         push(temp);
-                        pc = readmem(0xFFFA) | (readmem(0xFFFB) << 8);
+                        pc = fast_readmem(0xFFFA) | (fast_readmem(0xFFFB) << 8);
                         p.i = 1;
                         polltime(7);
                         p.d = 0;
@@ -5900,6 +5894,8 @@ void m65c02_exec(int slice)
                 }
                 oldnmi = nmi;
         }
+        sched_catchup();
+        hostprof_leave(hostprof_prev);
 }
 
 void m6502_savestate(FILE * f)
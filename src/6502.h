@@ -28,10 +28,12 @@ extern int romsel;
 extern uint8_t ram1k, ram4k, ram8k;
 
 void m6502_reset(void);
+void m6502_reset_timing(void);
 void m6502_exec(int slice);
 void m65c02_exec(int slice);
 void dumpregs(void);
 void m6502_update_swram(void);
+void m6502_io_setup(void);
 
 uint8_t readmem(uint16_t addr);
 void writemem(uint16_t addr, uint8_t val);
@@ -100,6 +100,140 @@ const uint32_t OpSizeLookup[6] =
    (sz64 << 8) | sz64                // Floating Point Double Precision
 };
 
+/*
+ * Decoded instruction cache
+ *
+ * Decoding an instruction, that is finding the function, the operand
+ * sizes and addressing modes and reading the index bytes, displacements
+ * and immediates, depends only on the bytes of the instruction so the
+ * result is kept, direct mapped by address, and reused the next time
+ * round a loop.  Only the effective addresses, which depend on the
+ * registers, are worked out each time.
+ *
+ * Each 256 byte page holding part of a cached instruction is flagged
+ * and a write to a flagged page discards the entries for it.  The cache
+ * is not used while the debugger is enabled so it sees each instruction
+ * fetched.
+ */
+
+#define DECODE_CACHE_SIZE  4096
+#define DECODE_CACHE_MASK  (DECODE_CACHE_SIZE - 1)
+#define DECODE_MAX_LENGTH  32
+#define DECODE_MAX_VALUES  6
+#define DECODE_EMPTY       0xFFFFFFFF
+
+typedef struct
+{
+   uint32_t pc;                              // Address of the instruction or DECODE_EMPTY
+   uint32_t opcode;
+   uint32_t Function;
+   uint32_t OpSize;
+   uint16_t Regs[2];
+   uint8_t  WriteIndex;
+   uint8_t  OpLength;                        // Bytes up to the first displacement or immediate
+   uint8_t  Length;                          // Bytes up to the first read as the instruction executes
+   uint32_t Values[DECODE_MAX_VALUES];       // Displacements and immediates in the order read
+} DecodedInstruction;
+
+static DecodedInstruction DecodeCache[DECODE_CACHE_SIZE];
+uint8_t n32016_code_pages[MEG16 >> CODE_PAGE_SHIFT];
+
+static uint32_t* pRecord;                    // Values of the instruction being cached, or NULL
+static uint32_t  RecordCount;
+static const uint32_t* pReplay;              // Values of the cached instruction, or NULL
+
+void n32016_flush_decode_cache(void)
+{
+   uint32_t i;
+
+   for (i = 0; i < DECODE_CACHE_SIZE; i++)
+   {
+      DecodeCache[i].pc = DECODE_EMPTY;
+   }
+
+   memset(n32016_code_pages, 0, sizeof(n32016_code_pages));
+}
+
+void n32016_code_written(uint32_t addr, uint32_t size)
+{
+   uint32_t page, last, a;
+
+   addr &= 0xFFFFFF;
+   last = ((addr + size - 1) & 0xFFFFFF) >> CODE_PAGE_SHIFT;
+
+   for (page = addr >> CODE_PAGE_SHIFT; ; page = (page + 1) & 0xFFFF)
+   {
+      if (n32016_code_pages[page])
+      {
+         n32016_code_pages[page] = 0;
+
+         // Including any instruction starting just before the page
+         a = (page << CODE_PAGE_SHIFT) - DECODE_MAX_LENGTH;
+         for (; a != ((page + 1) << CODE_PAGE_SHIFT); a++)
+         {
+            DecodeCache[a & DECODE_CACHE_MASK].pc = DECODE_EMPTY;
+         }
+      }
+
+      if (page == last)
+      {
+         break;
+      }
+   }
+}
+
+static inline uint32_t RecordValue(uint32_t Value)
+{
+   if (pRecord && RecordCount < DECODE_MAX_VALUES)
+   {
+      pRecord[RecordCount] = Value;
+   }
+
+   RecordCount++;
+   return Value;
+}
+
+static inline int32_t FetchDisplacement(void)
+{
+   if (pReplay)
+   {
+      return (int32_t) *pReplay++;
+   }
+
+   return (int32_t) RecordValue(GetDisplacement(&pc));
+}
+
+static inline uint32_t FetchImmediate(uint32_t addr)
+{
+   if (pReplay)
+   {
+      return *pReplay++;
+   }
+
+   return RecordValue(SWAP32(read_x32(addr)));
+}
+
+static void CacheDecode(DecodedInstruction* pEntry, uint32_t opcode, uint32_t Function, uint32_t WriteIndex, uint32_t OpLength)
+{
+   if ((pc - startpc) > DECODE_MAX_LENGTH || RecordCount > DECODE_MAX_VALUES)
+   {
+      return;
+   }
+
+   pEntry->pc         = startpc;
+   pEntry->opcode     = opcode;
+   pEntry->Function   = Function;
+   pEntry->OpSize     = OpSize.Whole;
+   pEntry->Regs[0]    = Regs[0].Whole;
+   pEntry->Regs[1]    = Regs[1].Whole;
+   pEntry->WriteIndex = WriteIndex;
+   pEntry->OpLength   = OpLength;
+   pEntry->Length     = pc - startpc;
+
+   n32016_code_pages[(startpc & 0xFFFFFF) >> CODE_PAGE_SHIFT] = 1;
+   n32016_code_pages[((pc - 1) & 0xFFFFFF) >> CODE_PAGE_SHIFT] = 1;
+}
+
 void n32016_init()
 {
    init_ram();
@@ -117,6 +251,7 @@ void n32016_reset()
 void n32016_reset_addr(uint32_t StartAddress)
 {
    n32016_build_matrix();
+   n32016_flush_decode_cache();
 
    pc = StartAddress;
    psr = 0;
@@ -399,15 +534,15 @@ static void GetGenPhase2(RegLKU gen, int c)
 
          if (OpSize.Op[c] == sz64)
          {
-            temp3.u32 = SWAP32(read_x32(pc));
+            temp3.u32 = FetchImmediate(pc);
             Immediate64.u64 = (((uint64_t) temp3.u32) << 32);
-            temp3.u32 = SWAP32(read_x32(pc + 4));
+            temp3.u32 = FetchImmediate(pc + 4);
             Immediate64.u64 |= temp3.u32;
          }
          else
          {
             // Why can't they just decided on an endian and then stick to it?
-            temp3.u32 = SWAP32(read_x32(pc));
+            temp3.u32 = FetchImmediate(pc);
             if (OpSize.Op[c] == sz8)
                genaddr[c] = temp3.u8;
             else if (OpSize.Op[c] == sz16)
@@ -425,7 +560,7 @@ static void GetGenPhase2(RegLKU gen, int c)
 
       if (gen.OpType <= R7_Offset)
       {
-         genaddr[c] = r[gen.Whole & 7] + GetDisplacement(&pc);
+         genaddr[c] = r[gen.Whole & 7] + FetchDisplacement();
          return;
       }
 
@@ -455,35 +590,35 @@ static void GetGenPhase2(RegLKU gen, int c)
       switch (gen.OpType)
       {
          case FrameRelative:
-            temp = GetDisplacement(&pc);
-            temp2 = GetDisplacement(&pc);
+            temp = FetchDisplacement();
+            temp2 = FetchDisplacement();
             genaddr[c] = read_x32(fp + temp);
             genaddr[c] += temp2;
             break;
 
          case StackRelative:
-            temp = GetDisplacement(&pc);
-            temp2 = GetDisplacement(&pc);
+            temp = FetchDisplacement();
+            temp2 = FetchDisplacement();
             genaddr[c] = read_x32(GET_SP() + temp);
             genaddr[c] += temp2;
             break;
 
          case StaticRelative:
-            temp = GetDisplacement(&pc);
-            temp2 = GetDisplacement(&pc);
+            temp = FetchDisplacement();
+            temp2 = FetchDisplacement();
             genaddr[c] = read_x32(sb + temp);
             genaddr[c] += temp2;
             break;
 
          case Absolute:
-            genaddr[c] = GetDisplacement(&pc);
+            genaddr[c] = FetchDisplacement();
             break;
 
          case External:
             temp = read_x32(mod + 4);
-            temp += ((int32_t) GetDisplacement(&pc)) * 4;
+            temp += ((int32_t) FetchDisplacement()) * 4;
             temp2 = read_x32(temp);
-            genaddr[c] = temp2 + GetDisplacement(&pc);
+            genaddr[c] = temp2 + FetchDisplacement();
             break;
 
          case TopOfStack:
@@ -492,19 +627,19 @@ static void GetGenPhase2(RegLKU gen, int c)
             break;
 
          case FpRelative:
-            genaddr[c] = GetDisplacement(&pc) + fp;
+            genaddr[c] = FetchDisplacement() + fp;
             break;
 
          case SpRelative:
-            genaddr[c] = GetDisplacement(&pc) + GET_SP();
+            genaddr[c] = FetchDisplacement() + GET_SP();
             break;
 
          case SbRelative:
-            genaddr[c] = GetDisplacement(&pc) + sb;
+            genaddr[c] = FetchDisplacement() + sb;
             break;
 
          case PcRelative:
-            genaddr[c] = GetDisplacement(&pc) + startpc;
+            genaddr[c] = FetchDisplacement() + startpc;
             break;
 
          default:
@@ -988,14 +1123,16 @@ uint32_t ReturnCommon(void)
 
 void n32016_exec()
 {
-   uint32_t opcode, WriteIndex;
+   uint32_t opcode, WriteIndex, OpLength;
    uint32_t temp, temp2, temp3;
    Temp64Type temp64;
    uint32_t Function;
+   DecodedInstruction* pEntry = NULL;
 
    // Avoid a "might be uninitialized" warning
    temp = 0;
    temp64.u64 = 0;
+   OpLength = 0;
 
    if (tube_irq & 2)
    {
@@ -1031,14 +1168,42 @@ void n32016_exec()
       }
 #endif
 
-      opcode = read_x32(pc);
-
       if (pc == PR.BPC)
       {
          SET_TRAP(BreakPointHit);
          goto DoTrap;
       }
 
+      pRecord = NULL;
+      pReplay = NULL;
+
+#ifdef INCLUDE_DEBUGGER
+      if (!n32016_debug_enabled)
+#endif
+      {
+         pEntry = &DecodeCache[pc & DECODE_CACHE_MASK];
+
+         if (pEntry->pc == pc)
+         {
+            opcode        = pEntry->opcode;
+            Function      = pEntry->Function;
+            OpSize.Whole  = pEntry->OpSize;
+            Regs[0].Whole = pEntry->Regs[0];
+            Regs[1].Whole = pEntry->Regs[1];
+            WriteIndex    = pEntry->WriteIndex;
+            pc           += pEntry->OpLength;
+            pReplay       = pEntry->Values;
+            BreakPoint(startpc, opcode);
+            goto Decoded;
+         }
+
+         pEntry->pc  = DECODE_EMPTY;
+         pRecord     = pEntry->Values;
+         RecordCount = 0;
+      }
+
+      opcode = read_x32(pc);
+
       BreakPoint(startpc, opcode);
 
       Function = FunctionLookup[opcode & 0xFF];
@@ -1291,9 +1456,14 @@ void n32016_exec()
          break;
       }
 
+      OpLength = pc - startpc;
+
+      Decoded:
 #ifdef PC_SIMULATION
-      uint32_t Temp = pc;
-      n32016_show_instruction(startpc, &Temp, opcode, Function, &OpSize);
+      {
+         uint32_t Temp = pc;
+         n32016_show_instruction(startpc, &Temp, opcode, Function, &OpSize);
+      }
 #endif
 
       GetGenPhase2(Regs[0], 0);
@@ -1301,7 +1471,7 @@ void n32016_exec()
 
       if (Function <= RETT)
       {
-         temp = GetDisplacement(&pc);
+         temp = FetchDisplacement();
       }
 
       if (TrapFlags)
@@ -1311,6 +1481,15 @@ void n32016_exec()
          continue;
       }
 
+      if (pReplay)
+      {
+         pc = startpc + pEntry->Length;
+      }
+      else if (pRecord)
+      {
+         CacheDecode(pEntry, opcode, Function, WriteIndex, OpLength);
+      }
+
 #ifdef INSTRUCTION_PROFILING
       IP[startpc]++;
 #endif
@@ -1941,6 +2120,7 @@ void n32016_exec()
             }
 
             nscfg.lsb = (opcode >> 15);                                  // Only sets the bottom 8 bits of which the lower 4 are used!
+            n32016_flush_decode_cache();                                 // Decoding format 9, 11 and 12 depends on the FPU flag
             continue;
          }
          // No break due to continue
@@ -348,6 +348,12 @@ extern void n32016_set_pc(uint32_t value);
 extern void BreakPoint(uint32_t pc, uint32_t opcode);
 extern int32_t GetDisplacement(uint32_t* pPC);
 
+// Decoded instruction cache, see 32016.c
+#define CODE_PAGE_SHIFT 8
+extern uint8_t n32016_code_pages[];
+extern void n32016_code_written(uint32_t addr, uint32_t size);
+extern void n32016_flush_decode_cache(void);
+
 extern ProcessorRegisters PR;
 extern uint32_t r[8];
 extern RegLKU Regs[2];
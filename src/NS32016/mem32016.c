@@ -78,6 +78,16 @@ void dump_ram(void)
 }
 #endif
 
+// Writes to a page holding instructions in the decoded instruction
+// cache discard them, see 32016.c
+static inline void code_written(uint32_t addr, uint32_t size)
+{
+   if (n32016_code_pages[addr >> CODE_PAGE_SHIFT] | n32016_code_pages[(addr + size - 1) >> CODE_PAGE_SHIFT])
+   {
+      n32016_code_written(addr, size);
+   }
+}
+
 // Tube Access
 // FFFFF0 - R1 status
 // FFFFF2 - R1 data
@@ -223,6 +233,7 @@ void write_x8_internal(uint32_t addr, uint8_t val)
 #else
       *(unsigned char *)(addr) = val;
 #endif
+      code_written(addr, sizeof(uint8_t));
       return;
    }
 
@@ -237,6 +248,7 @@ void write_x8_internal(uint32_t addr, uint8_t val)
 #ifdef PANDORA_ROM_PAGE_OUT
       PiTRACE("Pandora ROM no longer occupying the entire memory space!")
       memset(ns32016ram, 0, RAM_SIZE);
+      n32016_flush_decode_cache();
 #else
       PiTRACE("Pandora ROM write to 0xF90000");
 #endif
@@ -269,6 +281,7 @@ void write_x16(uint32_t addr, uint16_t val)
 #else
       *((uint16_t*) (addr)) = val;
 #endif
+      code_written(addr, sizeof(uint16_t));
       return;
    }
 #endif
@@ -295,6 +308,7 @@ void write_x32(uint32_t addr, uint32_t val)
 #else
       *((uint32_t*) (addr)) = val;
 #endif
+      code_written(addr, sizeof(uint32_t));
       return;
    }
 #endif
@@ -343,6 +357,10 @@ void write_Arbitary(uint32_t addr, void* pData, uint32_t Size)
 #endif
    {
       memcpy(ns32016ram + addr, pData, Size);
+      if (Size)
+      {
+         code_written(addr, Size);
+      }
       return;
    }
 #endif
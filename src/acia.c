@@ -113,6 +113,10 @@ void acia_poll(ACIA *acia)
     }
 }
 
+bool acia_rx_full(ACIA *acia) {
+    return acia->status_reg & RXD_REG_FUL;
+}
+
 void acia_receive(ACIA *acia, uint8_t val) { /*Called when the acia recives some data*/
     acia->rx_data_reg = val;
     acia->status_reg |= RXD_REG_FUL | INTERUPT;
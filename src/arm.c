@@ -404,6 +404,44 @@ static void writearml(uint32_t addr, uint32_t val)
             debug_trap(&tubearm_cpu_debug, PC, TRAP_BAD_WRITE_LONG);
 }
 
+/*
+ * The instruction fetch and nearly every load and store is to RAM so
+ * while the debugger is not attached these are made inline straight
+ * from the RAM arrays.  The tube registers, the ROM, bad addresses and
+ * anything the debugger may be watching still go through the
+ * functions above.
+ */
+
+static inline uint32_t fast_readarml(uint32_t addr)
+{
+    if (addr < ARM_RAM_SIZE && !arm_debug_enabled)
+        return armram[addr>>2];
+    return readarml(addr);
+}
+
+static inline uint8_t fast_readarmb(uint32_t addr)
+{
+    if (addr < ARM_RAM_SIZE && !arm_debug_enabled)
+        return armramb[addr];
+    return readarmb(addr);
+}
+
+static inline void fast_writearml(uint32_t addr, uint32_t val)
+{
+    if (addr < ARM_RAM_SIZE && !arm_debug_enabled)
+        armram[addr>>2] = val;
+    else
+        writearml(addr, val);
+}
+
+static inline void fast_writearmb(uint32_t addr, uint8_t val)
+{
+    if (addr < ARM_RAM_SIZE && !arm_debug_enabled)
+        armramb[addr] = val;
+    else
+        writearmb(addr, val);
+}
+
 /*****************************************************
  * CPU Debug Interface
  *****************************************************/
@@ -918,14 +956,14 @@ static int ldrlookup[4]={0,8,16,24};
 
 static void refillpipeline()
 {
-        opcode2=readarml(PC-4);
-        opcode3=readarml(PC);
+        opcode2=fast_readarml(PC-4);
+        opcode3=fast_readarml(PC);
 }
 
 static void refillpipeline2()
 {
-        opcode2=readarml(PC-8);
-        opcode3=readarml(PC-4);
+        opcode2=fast_readarml(PC-8);
+        opcode3=fast_readarml(PC-4);
 }
 
 void arm_exec()
@@ -936,7 +974,7 @@ void arm_exec()
         {
                 opcode=opcode2;
                 opcode2=opcode3;
-                opcode3=readarml(PC);
+                opcode3=fast_readarml(PC);
                 if (arm_debug_enabled)
                     debug_preexec(&tubearm_cpu_debug, PC-8);
                 if (flaglookup[opcode>>28][armregs[15]>>28])
@@ -1873,7 +1911,7 @@ void arm_exec()
                                         }
                                         templ=memmode;
                                         memmode=0;
-                                        templ2=readarmb(addr);
+                                        templ2=fast_readarmb(addr);
                                         memmode=templ;
                                         if (databort) break;
                                         LOADREG(RD,templ2);
@@ -1893,7 +1931,7 @@ void arm_exec()
                                         addr=GETADDR(RN);
                                         if (opcode&0x2000000) addr2=shift2(opcode);
                                         else                  addr2=opcode&0xFFF;
-                                        templ2=ldrresult(readarml(addr),addr);
+                                        templ2=ldrresult(fast_readarml(addr),addr);
                                         if (databort) break;
                                         LOADREG(RD,templ2);
                                         if (opcode&0x800000) armregs[RN]+=addr2;
@@ -1905,7 +1943,7 @@ void arm_exec()
                                         if (opcode&0x2000000) addr2=shift2(opcode);
                                         else                  addr2=opcode&0xFFF;
                                         templ=memmode; memmode=0;
-                                        templ2=ldrresult(readarml(addr),addr);
+                                        templ2=ldrresult(fast_readarml(addr),addr);
                                         memmode=templ;
                                         if (databort) break;
                                         LOADREG(RD,templ2);
@@ -1918,8 +1956,8 @@ void arm_exec()
                                         addr=GETADDR(RN);
                                         if (opcode&0x2000000) addr2=shift2(opcode);
                                         else                  addr2=opcode&0xFFF;
-                                        if (RD==15) { writearml(addr,armregs[RD]+4); }
-                                        else        { writearml(addr,armregs[RD]); }
+                                        if (RD==15) { fast_writearml(addr,armregs[RD]+4); }
+                                        else        { fast_writearml(addr,armregs[RD]); }
                                         if (databort) break;
                                         if (opcode&0x800000) armregs[RN]+=addr2;
                                         else                 armregs[RN]-=addr2;
@@ -1929,8 +1967,8 @@ void arm_exec()
                                         addr=GETADDR(RN);
                                         if (opcode&0x2000000) addr2=shift2(opcode);
                                         else                  addr2=opcode&0xFFF;
-                                        if (RD==15) { writearml(addr,armregs[RD]+4); }
-                                        else        { writearml(addr,armregs[RD]); }
+                                        if (RD==15) { fast_writearml(addr,armregs[RD]+4); }
+                                        else        { fast_writearml(addr,armregs[RD]); }
                                         templ=memmode; memmode=0;
                                         if (databort) break;
                                         memmode=templ;
@@ -1944,8 +1982,8 @@ void arm_exec()
                                         else                  addr2=opcode&0xFFF;
                                         if (opcode&0x800000) addr=GETADDR(RN)+addr2;
                                         else                 addr=GETADDR(RN)-addr2;
-                                        if (RD==15) { writearml(addr,armregs[RD]+4); }
-                                        else        { writearml(addr,armregs[RD]); }
+                                        if (RD==15) { fast_writearml(addr,armregs[RD]+4); }
+                                        else        { fast_writearml(addr,armregs[RD]); }
                                         if (databort) break;
                                         if (opcode&0x200000) armregs[RN]=addr;
                                         tubecycles-=3;
@@ -1955,7 +1993,7 @@ void arm_exec()
                                         addr=GETADDR(RN);
                                         if (opcode&0x2000000) addr2=shift2(opcode);
                                         else                  addr2=opcode&0xFFF;
-                                        writearmb(addr,armregs[RD]);
+                                        fast_writearmb(addr,armregs[RD]);
                                         if (databort) break;
                                         if (opcode&0x800000) armregs[RN]+=addr2;
                                         else                 armregs[RN]-=addr2;
@@ -1965,7 +2003,7 @@ void arm_exec()
                                         addr=GETADDR(RN);
                                         if (opcode&0x2000000) addr2=shift2(opcode);
                                         else                  addr2=opcode&0xFFF;
-                                        writearmb(addr,armregs[RD]);
+                                        fast_writearmb(addr,armregs[RD]);
                                         templ=memmode;
                                         memmode=0;
                                         if (databort) break;
@@ -1980,7 +2018,7 @@ void arm_exec()
                                         else                  addr2=opcode&0xFFF;
                                         if (opcode&0x800000) addr=GETADDR(RN)+addr2;
                                         else                 addr=GETADDR(RN)-addr2;
-                                        writearmb(addr,armregs[RD]);
+                                        fast_writearmb(addr,armregs[RD]);
                                         if (databort) break;
                                         if (opcode&0x200000) armregs[RN]=addr;
                                         tubecycles-=3;
@@ -2004,7 +2042,7 @@ void arm_exec()
                                         {
                                                 addr+=addr2;
                                         }
-                                        templ=readarml(addr);
+                                        templ=fast_readarml(addr);
                                         templ=ldrresult(templ,addr);
                                         if (databort) break;
                                         if (!(opcode&0x1000000))
@@ -2044,7 +2082,7 @@ void arm_exec()
                                         {
                                                 addr+=addr2;
                                         }
-                                        templ=readarmb(addr);
+                                        templ=fast_readarmb(addr);
                                         if (databort) break;
                                         if (!(opcode&0x1000000))
                                         {
@@ -2065,8 +2103,8 @@ void arm_exec()
                                 if (opcode&mask) \
                                 { \
                                         if (!(addr&0xC)) tubecycles--; \
-                                        if (c==15) { writearml(addr,armregs[c]+4); } \
-                                        else       { writearml(addr,armregs[c]); } \
+                                        if (c==15) { fast_writearml(addr,armregs[c]+4); } \
+                                        else       { fast_writearml(addr,armregs[c]); } \
                                         addr+=4; \
                                         tubecycles--; \
                                         break; \
@@ -2080,7 +2118,7 @@ void arm_exec()
                                 if (opcode&mask) \
                                 { \
                                         if (!(addr&0xC)) tubecycles--; \
-                                        writearml(addr,armregs[c]); \
+                                        fast_writearml(addr,armregs[c]); \
                                         addr+=4; \
                                         tubecycles--; \
                                 } \
@@ -2089,7 +2127,7 @@ void arm_exec()
                         if (opcode&0x8000) \
                         { \
                                 if (!(addr&0xC)) tubecycles--; \
-                                writearml(addr,armregs[15]+4); \
+                                fast_writearml(addr,armregs[15]+4); \
                                 tubecycles--; \
                         }
 
@@ -2099,8 +2137,8 @@ void arm_exec()
                                 if (opcode&mask) \
                                 { \
                                         if (!(addr&0xC)) tubecycles--; \
-                                        if (c==15) { writearml(addr,armregs[c]+4); } \
-                                        else       { writearml(addr,*usrregs[c]); } \
+                                        if (c==15) { fast_writearml(addr,armregs[c]+4); } \
+                                        else       { fast_writearml(addr,*usrregs[c]); } \
                                         addr+=4; \
                                         tubecycles--; \
                                         break; \
@@ -2114,7 +2152,7 @@ void arm_exec()
                                 if (opcode&mask) \
                                 { \
                                         if (!(addr&0xC)) tubecycles--; \
-                                        writearml(addr,*usrregs[c]); \
+                                        fast_writearml(addr,*usrregs[c]); \
                                         addr+=4; \
                                         tubecycles--; \
                                 } \
@@ -2123,7 +2161,7 @@ void arm_exec()
                         if (opcode&0x8000) \
                         { \
                                 if (!(addr&0xC)) tubecycles--; \
-                                writearml(addr,armregs[15]+4); \
+                                fast_writearml(addr,armregs[15]+4); \
                                 tubecycles--; \
                         }
 
@@ -2133,7 +2171,7 @@ void arm_exec()
                                 if (opcode&mask) \
                                 { \
                                         if (!(addr&0xC)) tubecycles--; \
-                                        templ=readarml(addr); if (!databort) armregs[c]=templ; \
+                                        templ=fast_readarml(addr); if (!databort) armregs[c]=templ; \
                                         addr+=4; \
                                         tubecycles--; \
                                 } \
@@ -2142,7 +2180,7 @@ void arm_exec()
                         if (opcode&0x8000) \
                         { \
                                 if (!(addr&0xC)) tubecycles--; \
-                                templ=readarml(addr); \
+                                templ=fast_readarml(addr); \
                                 if (!databort) armregs[15]=(armregs[15]&0xFC000003)|((templ+4)&0x3FFFFFC); \
                                 tubecycles--; \
                                 refillpipeline(); \
@@ -2156,14 +2194,14 @@ void arm_exec()
                                         if (opcode&mask) \
                                         { \
                                                 if (!(addr&0xC)) tubecycles--; \
-                                                templ=readarml(addr); if (!databort) armregs[c]=templ; \
+                                                templ=fast_readarml(addr); if (!databort) armregs[c]=templ; \
                                                 addr+=4; \
                                                 tubecycles--; \
                                         } \
                                         mask<<=1; \
                                 } \
                                 if (!(addr&0xC)) tubecycles--; \
-                                templ=readarml(addr); \
+                                templ=fast_readarml(addr); \
                                 if (!databort) \
                                 { \
                                         if (armregs[15]&3) armregs[15]=(templ+4); \
@@ -2179,7 +2217,7 @@ void arm_exec()
                                         if (opcode&mask) \
                                         { \
                                                 if (!(addr&0xC)) tubecycles--; \
-                                                templ=readarml(addr); if (!databort) *usrregs[c]=templ; \
+                                                templ=fast_readarml(addr); if (!databort) *usrregs[c]=templ; \
                                                 addr+=4; \
                                                 tubecycles--; \
                                         } \
@@ -0,0 +1,176 @@
+/*B-em throughput benchmark
+  Boots each model in turn, types in a fixed workload and times how
+  long the host takes to run a fixed number of emulated cycles of it.
+  This runs headless so video is rendered to a memory bitmap that is
+  never displayed and sound is generated but discarded, which leaves
+  the emulation itself as the thing being measured.*/
+
+#include <stdarg.h>
+#include "b-em.h"
+#include "6502.h"
+#include "disc.h"
+#include "hostprof.h"
+#include "main.h"
+#include "model.h"
+#include "bench.h"
+
+#define BENCH_WARMUP  6000000   // 3s to boot and type the program in.
+#define BENCH_CYCLES 20000000   // 10s of emulated time measured.
+
+typedef enum {
+    BENCH_ANY,      // every model.
+    BENCH_DISC,     // models with a floppy disc controller.
+    BENCH_TUBE      // a plain model B with the named tube CPU.
+} bench_need_t;
+
+typedef struct {
+    const char *name;
+    bench_need_t need;
+    const char *tube_cpu;
+    const char *text;
+} bench_work_t;
+
+static const bench_work_t bench_work[] = {
+    { "basic", BENCH_ANY,  NULL,
+      "10A=0:B%=0\r"
+      "20REPEATA=A+1.5:B%=B%+1:UNTILFALSE\r"
+      "RUN\r" },
+    { "mode2", BENCH_ANY,  NULL,
+      "10MODE2:C%=0\r"
+      "20REPEATCOLOURC%:PRINT\"B-em benchmark \";:C%=(C%+1)MOD8:UNTILFALSE\r"
+      "RUN\r" },
+    { "disc",  BENCH_DISC, NULL,
+      "10ONERRORGOTO20\r"
+      "20*CAT\r"
+      "30GOTO20\r"
+      "RUN\r" },
+    { "tube",  BENCH_TUBE, "6502",
+      "10A=0:B%=0\r"
+      "20REPEATA=A+1.5:B%=B%+1:UNTILFALSE\r"
+      "RUN\r" }
+};
+
+static int bench_find_tube(const char *cpu)
+{
+    for (int i = 0; i < num_tubes; i++)
+        if (tubes[i].cpu && !strcmp(tubes[i].cpu->name, cpu))
+            return i;
+    return -1;
+}
+
+/*
+ * The tube workloads run on the first ordinary model B with a disc
+ * interface so the host side is the same for every tube.
+ */
+
+static int bench_find_host(void)
+{
+    for (int i = 0; i < model_count; i++) {
+        MODEL *m = models + i;
+        if (m->cfgsect && m->tube == -1 && m->fdc_type == FDC_I8271 && !m->modela && !m->os01 && !m->master && !m->bplus && !m->integra)
+            return i;
+    }
+    return -1;
+}
+
+static bool bench_load_disc(void)
+{
+    ALLEGRO_PATH *dir = al_create_path_for_directory("discs");
+    ALLEGRO_PATH *path = find_dat_file(dir, "Welcome", ".ssd");
+    al_destroy_path(dir);
+    if (!path) {
+        log_warn("bench: Welcome.ssd not found, skipping disc workloads");
+        return false;
+    }
+    disc_free(0);
+    drives[0].discfn = path;
+    return disc_load(0, path) == 0;
+}
+
+static void bench_paste(const char *text)
+{
+    size_t size = strlen(text) + 1;
+    char *str = al_malloc(size);
+    if (str) {
+        memcpy(str, text, size);
+        os_paste_start(str);
+    }
+}
+
+#ifdef BEM_PROFILE
+static void bench_outf(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+}
+#endif
+
+static void bench_one(int model, int tube, const bench_work_t *work, const char *label)
+{
+    oldmodel = curmodel;
+    curmodel = model;
+    selecttube = tube;
+    main_restart();
+    oldmodel = curmodel;
+    if (work->need == BENCH_DISC && !bench_load_disc())
+        return;
+    if (work->text && models[model].tube == -1)
+        bench_paste(work->text);
+
+    main_run_cycles(BENCH_WARMUP);
+    int frames = framesrun;
+    hostprof_reset();
+    double start = al_get_time();
+    uint64_t cycles = main_run_cycles(BENCH_CYCLES);
+    double secs = al_get_time() - start;
+    frames = framesrun - frames;
+
+    if (work->need == BENCH_DISC)
+        disc_free(0);
+    if (secs > 0 && cycles > 0)
+        printf("%-32s %-10s %9.3f %9.3f %9.1f\n", models[model].name, label, cycles / secs / 1000000, secs * 1e9 / cycles, frames / secs);
+#ifdef BEM_PROFILE
+    hostprof_print(bench_outf);
+#endif
+}
+
+void bench_run(void)
+{
+    int host = bench_find_host();
+
+    printf("%s benchmark, %d cycles per run after %d to boot\n\n", VERSION_STR, BENCH_CYCLES, BENCH_WARMUP);
+    printf("%-32s %-10s %9s %9s %9s\n", "Model", "Workload", "MHz", "ns/cycle", "frames/s");
+    for (int w = 0; w < sizeof(bench_work) / sizeof(bench_work[0]) && !quitting; w++) {
+        const bench_work_t *work = bench_work + w;
+        if (work->need == BENCH_TUBE) {
+            int tube = bench_find_tube(work->tube_cpu);
+            if (host < 0 || tube < 0)
+                log_warn("bench: no model or tube to run %s on %s", work->name, work->tube_cpu);
+            else {
+                char label[16];
+                snprintf(label, sizeof(label), "%s-%s", work->name, work->tube_cpu);
+                bench_one(host, tube, work, label);
+            }
+        }
+        else {
+            for (int m = 0; m < model_count && !quitting; m++) {
+                if (!models[m].cfgsect)
+                    continue;
+                if (work->need == BENCH_DISC && models[m].fdc_type == FDC_NONE)
+                    continue;
+                // Models with their own tube start its language, not
+                // BASIC, so are just timed booting, once.
+                if (models[m].tube != -1) {
+                    if (w == 0)
+                        bench_one(m, -1, work, "boot");
+                    continue;
+                }
+                bench_one(m, -1, work, work->name);
+            }
+        }
+        fflush(stdout);
+    }
+    set_quit();
+}
@@ -0,0 +1,6 @@
+#ifndef __INC_BENCH_H
+#define __INC_BENCH_H
+
+void bench_run(void);
+
+#endif
@@ -6,6 +6,7 @@
 #include "config.h"
 #include "ddnoise.h"
 #include "disc.h"
+#include "hdimage.h"
 #include "keyboard.h"
 #include "main.h"
 #include "mem.h"
@@ -16,6 +17,7 @@
 #include "music5000.h"
 #include "ide.h"
 #include "midi.h"
+#include "rewind.h"
 #include "scsi.h"
 #include "sdf.h"
 #include "sn76489.h"
@@ -180,6 +182,7 @@ void config_load(ALLEGRO_PATH *path)
     defaultwriteprot = get_config_bool("disc", "defaultwriteprotect", 1);
 
     autopause        = get_config_bool(NULL, "autopause", false);
+    rewind_enabled   = get_config_bool(NULL, "rewind", false);
     if (hiresdisplay & BOOL_USE_CONFIG)
         hiresdisplay = get_config_bool(NULL, "hiresdisplay", hiresdisplay & 1);
 
@@ -188,6 +191,7 @@ void config_load(ALLEGRO_PATH *path)
 
     selecttube       = get_config_int(NULL, "tube",         -1);
     tube_speed_num   = get_config_int(NULL, "tubespeed",     0);
+    tube_threaded    = get_config_bool(NULL, "tubethread",   false);
 
     sound_internal   = get_config_bool("sound", "sndinternal",   true);
     sound_beebsid    = get_config_bool("sound", "sndbeebsid",    true);
@@ -239,6 +243,7 @@ void config_load(ALLEGRO_PATH *path)
     ide_enable       = get_config_bool("disc", "ideenable", 0);
     vdfs_enabled     = get_config_bool("disc", "vdfsenable", 0);
     vdfs_cfg_root    = get_config_string("disc", "vdfs_root", 0);
+    hdimage_overlay_dir = get_config_string("disc", "hd_overlay", 0);
 
     keyas            = get_config_bool(NULL, "key_as", 0);
     keypad           = get_config_bool(NULL, "keypad", false);
@@ -347,11 +352,13 @@ void config_save(void)
             al_remove_config_key(bem_cfg, "tape", "tape");
 
         set_config_bool(NULL, "autopause", autopause);
+        set_config_bool(NULL, "rewind", rewind_enabled);
         set_config_bool(NULL, "hiresdisplay", hiresdisplay);
 
         set_config_int(NULL, "model", curmodel);
         set_config_int(NULL, "tube", selecttube);
         set_config_int(NULL, "tubespeed", tube_speed_num);
+        set_config_bool(NULL, "tubethread", tube_threaded);
 
         set_config_bool("sound", "sndinternal", sound_internal);
         set_config_bool("sound", "sndbeebsid",  sound_beebsid);
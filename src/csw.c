@@ -1,22 +1,22 @@
 /*B-em v2.2 by Tom Walker
-  CSW cassette support*/
+  CSW cassette support
+  The pulses are inflated, if compressed, a block at a time and added
+  to the tape timeline, see tape.c, where they are decoded into bytes
+  as the tape plays.  A pulse longer than 255 samples, which is only
+  ever silence, is kept as 255.*/
 #include <stdio.h>
 #include <stdlib.h>
 #include <zlib.h>
 #include "b-em.h"
-#include "sysacia.h"
 #include "csw.h"
 #include "tape.h"
 
-int csw_toneon=0;
+#define CSW_BLOCK 65536
 
-static int csw_intone = 1, csw_indat = 0, csw_datbits = 0, csw_enddat = 0;
-static uint8_t *csw_dat = NULL;
-static int      csw_point;
-static uint8_t  csw_head[0x34];
-static int      csw_skip = 0;
-static int      csw_loop = 1;
-int csw_ena;
+typedef struct {
+    int     esc;                // bytes of a long pulse still to skip.
+    uint8_t out[CSW_BLOCK];
+} csw_rle_t;
 
 static void csw_read_failed(FILE *csw_f, const char *fn)
 {
@@ -26,292 +26,127 @@ static void csw_read_failed(FILE *csw_f, const char *fn)
         log_error("csw: premature EOF on '%s'", fn);
 }
 
-#define CSW_MAXLEN (8 * 1024 * 1024)
-
-void csw_load(const char *fn)
+static bool csw_pulses(csw_rle_t *rle, const uint8_t *in, size_t len)
 {
-    FILE *csw_f;
-    int end,c;
-    unsigned long destlen = CSW_MAXLEN;
-    uint8_t *tempin;
-
-    /*Allocate buffer*/
-    if (!csw_dat) {
-        if (!(csw_dat = malloc(CSW_MAXLEN))) {
-            log_error("csw: out of memory reading '%s'", fn);
-            return;
+    size_t n = 0;
+
+    while (len--) {
+        uint8_t dat = *in++;
+        if (rle->esc)
+            rle->esc--;
+        else if (dat)
+            rle->out[n++] = dat;
+        else {
+            rle->out[n++] = 0xff;
+            rle->esc = 4;
         }
     }
+    return tape_add_pulses(rle->out, n);
+}
 
-    /*Open file and get size*/
-    if (!(csw_f = fopen(fn,"rb"))) {
-        log_warn("csw: unable to open CSW file '%s': %s", fn, strerror(errno));
-        return;
+static bool csw_inflate(FILE *csw_f, const char *fn, csw_rle_t *rle, uint8_t *in)
+{
+    uint8_t *out = malloc(CSW_BLOCK);
+    z_stream zs;
+    size_t len;
+    int res = Z_OK;
+    bool ok = false;
+
+    if (!out) {
+        log_error("csw: out of memory reading '%s'", fn);
+        return false;
     }
-    fseek(csw_f, -1, SEEK_END);
-    end = ftell(csw_f);
-    fseek(csw_f, 0, SEEK_SET);
-
-    /*Read header*/
-    if (fread(csw_head, 0x34, 1, csw_f) == 1) {
-        for (c = 0; c < csw_head[0x23]; c++)
-            getc(csw_f);
-        /*Allocate temporary memory and read file into memory*/
-        end -= ftell(csw_f);
-        if ((tempin = malloc(end))) {
-            if (fread(tempin, end, 1, csw_f) == 1) {
-                fclose(csw_f);
-                if (2 == csw_head[0x21]) {
-                    /*Decompress*/
-                    uncompress(csw_dat, (unsigned long *)&destlen, tempin, end);
-                } else {
-                    if (end >= CSW_MAXLEN) {
-                        log_error("csw: out of memory reading '%s'", fn);
-                        return;
-                    }
-                    memcpy(csw_dat, tempin, end);
-                    destlen = end;
-                }
-                free(tempin);
-                /*Reset data pointer*/
-                csw_point = 0;
-                acia_dcdhigh(&sysacia);
-                tapellatch  = (1000000 / (1200 / 10)) / 64;
-                tapelcount  = 0;
-                tape_loaded = 1;
-                csw_ena     = 1;
-                return;
-            }
-            else {
-                csw_read_failed(csw_f, fn);
-                free(tempin);
+    memset(&zs, 0, sizeof(zs));
+    if (inflateInit(&zs) != Z_OK) {
+        log_error("csw: unable to decompress '%s'", fn);
+        free(out);
+        return false;
+    }
+    while (res != Z_STREAM_END && (len = fread(in, 1, CSW_BLOCK, csw_f)) > 0) {
+        zs.next_in = in;
+        zs.avail_in = len;
+        do {
+            zs.next_out = out;
+            zs.avail_out = CSW_BLOCK;
+            res = inflate(&zs, Z_NO_FLUSH);
+            if (res != Z_OK && res != Z_STREAM_END && res != Z_BUF_ERROR) {
+                log_error("csw: '%s' is corrupt: %s", fn, zs.msg ? zs.msg : "inflate failed");
+                goto done;
             }
-        }
-        else
-            log_error("csw: out of memory reading '%s'", fn);
+            if (!csw_pulses(rle, out, CSW_BLOCK - zs.avail_out))
+                goto done;
+        } while (!zs.avail_out && res == Z_OK);
     }
-    else
+    if (ferror(csw_f))
         csw_read_failed(csw_f, fn);
-    fclose(csw_f);
-}
-
-void csw_close()
-{
-    if (csw_dat) {
-        free(csw_dat);
-        csw_dat = NULL;
+    else {
+        if (res != Z_STREAM_END)
+            log_warn("csw: '%s' is truncated", fn);
+        ok = true;
     }
+done:
+    inflateEnd(&zs);
+    free(out);
+    return ok;
 }
 
-static int ffound, fdat;
-static int infilenames;
-static void csw_receive(uint8_t val)
-{
-        csw_toneon--;
-        if (infilenames)
-        {
-                ffound = 1;
-                fdat = val;
-        }
-        else
-           acia_receive(&sysacia, val);
-}
-
-void csw_poll()
+bool csw_load(const char *fn)
 {
-        int c;
-        uint8_t dat;
-        if (!csw_dat) return;
-
-        for (c = 0; c < 10; c++)
-        {
-                dat = csw_dat[csw_point++];
-
-                if (csw_point >= (8 * 1024 * 1024))
-                {
-                        csw_point = 0;
-                        csw_loop = 1;
-                }
-                if (csw_skip)
-                   csw_skip--;
-                else if (csw_intone && dat > 0xD) /*Not in tone any more - data start bit*/
-                {
-                        csw_point++; /*Skip next half of wave*/
-                        if (sysacia_tapespeed) csw_skip = 6;
-                        csw_intone = 0;
-                        csw_indat = 1;
-
-                        csw_datbits = csw_enddat = 0;
-                        acia_dcdlow(&sysacia);
-                        return;
-                }
-                else if (csw_indat && csw_datbits != -1 && csw_datbits != -2)
-                {
-                        csw_point++; /*Skip next half of wave*/
-                        if (sysacia_tapespeed) csw_skip = 6;
-                        csw_enddat >>= 1;
-
-                        if (dat <= 0xD)
-                        {
-                                csw_point += 2;
-                                if (sysacia_tapespeed) csw_skip += 6;
-                                csw_enddat |= 0x80;
-                        }
-                        csw_datbits++;
-                        if (csw_datbits == 8)
-                        {
-                                csw_receive(csw_enddat);
+    FILE *csw_f;
+    uint8_t head[0x34], *in;
+    csw_rle_t *rle;
+    size_t len;
+    bool ok = false;
+    int c;
 
-                                csw_datbits = -2;
-                                return;
-                        }
-                }
-                else if (csw_indat && csw_datbits == -2) /*Deal with stop bit*/
-                {
-                        csw_point++;
-                        if (sysacia_tapespeed) csw_skip = 6;
-                        if (dat <= 0xD)
-                        {
-                                csw_point += 2;
-                                if (sysacia_tapespeed) csw_skip += 6;
-                        }
-                        csw_datbits = -1;
-                }
-                else if (csw_indat && csw_datbits == -1)
-                {
-                        if (dat <= 0xD) /*Back in tone again*/
-                        {
-                                acia_dcdhigh(&sysacia);
-                                csw_toneon  = 2;
-                                csw_indat   = 0;
-                                csw_intone  = 1;
-                                csw_datbits = 0;
-                                return;
-                        }
-                        else /*Start bit*/
-                        {
-                                csw_point++; /*Skip next half of wave*/
-                                if (sysacia_tapespeed) csw_skip += 6;
-                                csw_datbits = 0;
-                                csw_enddat  = 0;
-                        }
-                }
+    /*Open file and read header*/
+    if (!(csw_f = fopen(fn,"rb"))) {
+        log_warn("csw: unable to open CSW file '%s': %s", fn, strerror(errno));
+        return false;
+    }
+    if (fread(head, 0x20, 1, csw_f) != 1) {
+        csw_read_failed(csw_f, fn);
+        fclose(csw_f);
+        return false;
+    }
+    if (memcmp(head, "Compressed Square Wave\x1a", 0x17)) {
+        log_error("csw: '%s' is not a CSW file", fn);
+        fclose(csw_f);
+        return false;
+    }
+    if (head[0x17] >= 2) {
+        if (fread(head + 0x20, 0x14, 1, csw_f) != 1) {
+            csw_read_failed(csw_f, fn);
+            fclose(csw_f);
+            return false;
         }
-}
-
-#define getcswbyte()            ffound = 0; \
-                                while (!ffound && !csw_loop) \
-                                { \
-                                        csw_poll(); \
-                                } \
-                                if (csw_loop) break;
-
-static uint8_t ffilename[16];
-void csw_findfilenames()
-{
-        int temp, temps, tempd, tempi, tempsk, tempspd;
-        uint8_t tb;
-        int c;
-        int fsize = 0;
-        char s[256];
-        uint32_t run, load;
-        uint8_t status;
-        int skip;
-        if (!csw_dat) return;
-        temp    = csw_point;
-        temps   = csw_indat;
-        tempi   = csw_intone;
-        tempd   = csw_datbits;
-        tempsk  = csw_skip;
-        tempspd = sysacia_tapespeed;
-        csw_point = 0;
-
-        csw_indat = csw_intone = csw_datbits = csw_skip = 0;
-        csw_intone = 1;
-        sysacia_tapespeed = 0;
-
-//        gzseek(csw,12,SEEK_SET);
-        csw_loop = 0;
-        infilenames = 1;
-        while (!csw_loop)
-        {
-//                log_debug("Start\n");
-                ffound = 0;
-                while (!ffound && !csw_loop)
-                {
-                        csw_poll();
-                }
-                if (csw_loop) break;
-//                log_debug("FDAT %02X csw_toneon %i\n",fdat,csw_toneon);
-                if (fdat == 0x2A && csw_toneon == 1)
-                {
-                        c = 0;
-                        do
-                        {
-                                ffound = 0;
-                                while (!ffound && !csw_loop)
-                                {
-                                        csw_poll();
-                                }
-                                if (csw_loop) break;
-                                ffilename[c++] = fdat;
-                        } while (fdat != 0x0 && c <= 10);
-                        if (csw_loop) break;
-                        c--;
-                        while (c < 13) ffilename[c++] = 32;
-                        ffilename[c] = 0;
-
-                                getcswbyte();
-                                tb = fdat;
-                                getcswbyte();
-                                load = tb | (fdat << 8);
-                                getcswbyte();
-                                tb = fdat;
-                                getcswbyte();
-                                load |= (tb | (fdat << 8)) << 16;
-
-                                getcswbyte();
-                                tb = fdat;
-                                getcswbyte();
-                                run = tb | (fdat << 8);
-                                getcswbyte();
-                                tb = fdat;
-                                getcswbyte();
-                                run |= (tb | (fdat << 8)) << 16;
-
-                                getcswbyte();
-                                getcswbyte();
-
-                                getcswbyte();
-                                tb = fdat;
-                                getcswbyte();
-                                skip = tb | (fdat << 8);
-
-                                fsize += skip;
-
-                                getcswbyte();
-                                status = fdat;
-
-//log_debug("Got block - %08X %08X %02X\n",load,run,status);
-                        if (status & 0x80)
-                        {
-                                sprintf(s, "%s Size %04X Load %08X Run %08X", ffilename, fsize, load, run);
-                                cataddname(s);
-                                fsize = 0;
-                        }
-                        for (c = 0; c < skip + 8; c++)
-                        {
-                                getcswbyte();
-                        }
-                }
+        for (c = 0; c < head[0x23]; c++)
+            getc(csw_f);
+    }
+    else
+        head[0x21] = head[0x1b];
+
+    /*Read the pulses a block at a time*/
+    in = malloc(CSW_BLOCK);
+    rle = malloc(sizeof(csw_rle_t));
+    if (!in || !rle)
+        log_error("csw: out of memory reading '%s'", fn);
+    else {
+        rle->esc = 0;
+        if (head[0x21] == 2)
+            ok = csw_inflate(csw_f, fn, rle, in);
+        else {
+            ok = true;
+            while (ok && (len = fread(in, 1, CSW_BLOCK, csw_f)) > 0)
+                ok = csw_pulses(rle, in, len);
+            if (ferror(csw_f)) {
+                csw_read_failed(csw_f, fn);
+                ok = false;
+            }
         }
-        infilenames = 0;
-        csw_indat   = temps;
-        csw_intone  = tempi;
-        csw_datbits = tempd;
-        csw_skip    = tempsk;
-        sysacia_tapespeed = tempspd;
-        csw_point   = temp;
-        csw_loop = 0;
+    }
+    free(in);
+    free(rle);
+    fclose(csw_f);
+    return ok;
 }
-
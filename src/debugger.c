@@ -15,7 +15,11 @@
 #include "mem.h"
 #include "model.h"
 #include "6502.h"
+#include "hostprof.h"
 #include "keyboard.h"
+#include "movie.h"
+#include "rewind.h"
+#include "tube.h"
 #include "debugger_symbols.h"
 
 #include <allegro5/allegro_primitives.h>
@@ -59,8 +63,111 @@ struct breakpoint {
     break_type type;
     int        num;
     uint8_t    shutdown_on_hit; /* TOHv3 */
+    char       *cond;           // condition that must be true, or NULL.
+    unsigned   hits;            // times hit with the condition true.
+    unsigned   count;           // hits needed before it takes effect.
 };
 
+/*
+ * So that an access to an address with no breakpoint costs only a bit
+ * test, each CPU with breakpoints has a bitmap, for each kind of
+ * access, of the pages which contain one.  Pages are hashed into the
+ * bitmap so a CPU with a large address space can share one of a fixed
+ * size; a collision only means the list is searched when it need not
+ * have been.
+ */
+
+typedef enum {
+    ACCESS_EXEC,
+    ACCESS_READ,
+    ACCESS_WRITE,
+    ACCESS_INPUT,
+    ACCESS_OUTPUT,
+    ACCESS_MAX
+} access_type;
+
+static const access_type break_access[] = {
+    ACCESS_EXEC,    // BREAK_EXEC
+    ACCESS_READ,    // BREAK_READ
+    ACCESS_WRITE,   // BREAK_WRITE
+    ACCESS_WRITE,   // BREAK_CHANGE
+    ACCESS_INPUT,   // BREAK_INPUT
+    ACCESS_OUTPUT,  // BREAK_OUTPUT
+    ACCESS_EXEC,    // WATCH_EXEC
+    ACCESS_READ,    // WATCH_READ
+    ACCESS_WRITE,   // WATCH_WRITE
+    ACCESS_WRITE,   // WATCH_CHANGE
+    ACCESS_INPUT,   // WATCH_INPUT
+    ACCESS_OUTPUT,  // WATCH_OUTPUT
+    ACCESS_EXEC     // TRACE_EXEC
+};
+
+#define BP_PAGE_SHIFT 8
+#define BP_MAP_SIZE   65536
+
+struct breakpoint_map {
+    uint32_t bits[ACCESS_MAX][BP_MAP_SIZE / 32];
+};
+
+static inline uint32_t bp_map_index(uint32_t page)
+{
+    // Keeps the bank number the 6502 puts in the top bits apart from
+    // the page within the bank.
+    return (page ^ (page >> 12)) & (BP_MAP_SIZE - 1);
+}
+
+static inline bool bp_maybe(cpu_debug_t *cpu, access_type access, uint32_t addr)
+{
+    breakpoint_map *map = cpu->bp_map;
+    if (!map)   // none set, or no memory for the map so search them all.
+        return cpu->breakpoints != NULL;
+    uint32_t ix = bp_map_index(addr >> BP_PAGE_SHIFT);
+    return map->bits[access][ix >> 5] & (1u << (ix & 31));
+}
+
+// Rebuild the map after breakpoints have been set or cleared.
+
+static void bp_map_update(cpu_debug_t *cpu)
+{
+    breakpoint_map *map = cpu->bp_map;
+    if (!cpu->breakpoints) {
+        if (map) {
+            free(map);
+            cpu->bp_map = NULL;
+        }
+        return;
+    }
+    if (!map) {
+        if (!(map = malloc(sizeof(breakpoint_map)))) {
+            log_error("debugger: out of memory for breakpoint map, checking every breakpoint on each access");
+            return;
+        }
+        cpu->bp_map = map;
+    }
+    memset(map, 0, sizeof(breakpoint_map));
+    for (breakpoint *bp = cpu->breakpoints; bp; bp = bp->next) {
+        uint32_t *bits = map->bits[break_access[bp->type]];
+        uint32_t first = bp->start >> BP_PAGE_SHIFT;
+        uint32_t last = bp->end >> BP_PAGE_SHIFT;
+        if (last - first >= BP_MAP_SIZE - 1)
+            memset(bits, 0xff, sizeof(map->bits[0]));
+        else {
+            uint32_t page = first;
+            do {
+                uint32_t ix = bp_map_index(page);
+                bits[ix >> 5] |= 1u << (ix & 31);
+            } while (page++ != last);
+        }
+    }
+}
+
+static void free_point(breakpoint *bp)
+{
+    if (bp->cond)
+        free(bp->cond);
+    free(bp);
+}
+
 int debug_core = 0;
 int debug_tube = 0;
 int debug_step = 0;
@@ -109,6 +216,7 @@ static void close_trace(const char *why)
 }
 
 static ALLEGRO_THREAD  *mem_thread;
+bool debug_memview = false; /* the 6502 only counts accesses while this is set */
 #define MEM_BITMAP_SIZE 256
 static int mem_disp_width, mem_disp_height;
 
@@ -195,6 +303,7 @@ mem_thread_close:   al_destroy_timer(mem_timer);
     }
     else
         log_error("debugger: unable to create display");
+    debug_memview = false;
     return NULL;
 }
 
@@ -203,6 +312,10 @@ static void debug_memview_open(void)
     if (!mem_thread) {
         if ((mem_thread = al_create_thread(mem_thread_proc, NULL))) {
             log_debug("debugger: memory view thread created");
+            memset(readc, 0, sizeof(readc));
+            memset(writec, 0, sizeof(writec));
+            memset(fetchc, 0, sizeof(fetchc));
+            debug_memview = true;
             al_start_thread(mem_thread);
         }
         else
@@ -213,6 +326,7 @@ static void debug_memview_open(void)
 static void debug_memview_close(void)
 {
     if (mem_thread) {
+        debug_memview = false;
         al_destroy_thread(mem_thread);
         mem_thread = NULL;
     }
@@ -349,6 +463,7 @@ static void enable_tube_debug(void)
 {
     if (curtube != -1)
     {
+        tube_thread_stop();
         debug_cons_open();
         debug_step = 1;
         debug_tube = 1;
@@ -463,6 +578,9 @@ static const char helptext[] =
     "    bclearw n  - clear write breakpoint n or write breakpoint at n\n"
     "    bcleari n  - clear input breakpoint n or input breakpoint at n\n"
     "    bclearo n  - clear output breakpoint n or output breakpoint at n\n"
+    "    bcond n c  - only stop at breakpoint n when condition c is true, e.g.\n"
+    "                 A==0D && ?70>=80, or clear the condition if c is omitted\n"
+    "    bcount n k - only stop at breakpoint n from the kth time it is hit\n"
     "    blist      - list current breakpoints\n"
     "    break n    - set a breakpoint at n\n"
     "    breakr n   - break on reads from address n\n"
@@ -487,6 +605,7 @@ static const char helptext[] =
     "    r vidproc  - print VIDPROC registers\n"
     "    r sound    - print Sound registers\n"
     "    reset      - reset emulated machine\n"
+    "    rewind [n] - step back n snapshots (or 1) when execution continues\n"
     "    rset r v   - set a CPU register\n"
     "    ruler [s [c]] - draw a ruler to help with hexdumps.\n"
     "                 starts at 's' for 'c' bytes\n"
@@ -515,7 +634,8 @@ static const char helptext[] =
     "    profile print         - show profiling stats\n"
     "    profile file <file>   - write profiling stats to <file>\n"
     "    profile reset         - reset profiling counters\n"
-    "    profile stop          - stop profiling and free memory\n";
+    "    profile stop          - stop profiling and free memory\n"
+    "    profile subsys [reset] - show host time by subsystem, optionally resetting\n";
 
 static char xdigs[] = "0123456789ABCDEF";
 
@@ -653,6 +773,158 @@ static void list_syms(cpu_debug_t *cpu, const char *arg) {
     symbol_list(cpu->symbols, cpu, &debug_outf);
 }
 
+/*
+ * Breakpoint conditions are kept as text.  bcond parses one only to
+ * check its syntax; it is evaluated by parsing it again each time the
+ * breakpoint is hit, so it costs nothing otherwise.  The syntax is:
+ *
+ *   cond  := and { "||" and }
+ *   and   := rel { "&&" rel }
+ *   rel   := value [ ( "==" | "!=" | "<" | "<=" | ">" | ">=" ) value ]
+ *   value := term { "&" term }
+ *   term  := "?" term | "(" cond ")" | register | address or symbol
+ *
+ * where ?n is the contents of memory at n, as in BBC BASIC.  Register
+ * names take precedence over hex numbers so A is the accumulator and
+ * 0A the number.
+ */
+
+typedef struct {
+    cpu_debug_t *cpu;
+    const char  *ptr;
+    bool        eval;   // false when only checking the syntax.
+    bool        error;
+} cond_state;
+
+static uint32_t cond_or(cond_state *cs);
+
+static int cond_peek(cond_state *cs)
+{
+    while (*cs->ptr == ' ' || *cs->ptr == '\t')
+        cs->ptr++;
+    return *cs->ptr;
+}
+
+static uint32_t cond_term(cond_state *cs)
+{
+    int ch = cond_peek(cs);
+    if (ch == '?') {
+        cs->ptr++;
+        uint32_t addr = cond_term(cs);
+        return cs->eval ? cs->cpu->memread(addr) : 0;
+    }
+    if (ch == '(') {
+        cs->ptr++;
+        uint32_t value = cond_or(cs);
+        if (cond_peek(cs) == ')')
+            cs->ptr++;
+        else
+            cs->error = true;
+        return value;
+    }
+    const char *end = cs->ptr;
+    while (isalnum(*end) || *end == '_')
+        end++;
+    size_t len = end - cs->ptr;
+    if (len) {
+        const char **np = cs->cpu->reg_names;
+        for (int r = 0; np[r]; r++) {
+            if (strlen(np[r]) == len && !strncasecmp(np[r], cs->ptr, len)) {
+                cs->ptr = end;
+                return cs->eval ? cs->cpu->reg_get(r) : 0;
+            }
+        }
+    }
+    uint32_t value = parse_address_or_symbol(cs->cpu, cs->ptr, &end);
+    if (end > cs->ptr)
+        cs->ptr = end;
+    else
+        cs->error = true;
+    return value;
+}
+
+static uint32_t cond_value(cond_state *cs)
+{
+    uint32_t value = cond_term(cs);
+    while (cond_peek(cs) == '&' && cs->ptr[1] != '&') {
+        cs->ptr++;
+        value &= cond_term(cs);
+    }
+    return value;
+}
+
+static uint32_t cond_rel(cond_state *cs)
+{
+    uint32_t a = cond_value(cs);
+    int ch = cond_peek(cs);
+    const char *op = cs->ptr;
+    if ((ch == '=' || ch == '!') && op[1] == '=')
+        cs->ptr += 2;
+    else if (ch == '<' || ch == '>')
+        cs->ptr += (op[1] == '=') ? 2 : 1;
+    else
+        return a;
+    uint32_t b = cond_value(cs);
+    switch (ch) {
+        case '=':
+            return a == b;
+        case '!':
+            return a != b;
+        case '<':
+            return op[1] == '=' ? a <= b : a < b;
+        default:
+            return op[1] == '=' ? a >= b : a > b;
+    }
+}
+
+static uint32_t cond_and(cond_state *cs)
+{
+    uint32_t value = cond_rel(cs);
+    while (cond_peek(cs) == '&' && cs->ptr[1] == '&') {
+        cs->ptr += 2;
+        uint32_t rhs = cond_rel(cs);
+        value = value && rhs;
+    }
+    return value;
+}
+
+static uint32_t cond_or(cond_state *cs)
+{
+    uint32_t value = cond_and(cs);
+    while (cond_peek(cs) == '|' && cs->ptr[1] == '|') {
+        cs->ptr += 2;
+        uint32_t rhs = cond_and(cs);
+        value = value || rhs;
+    }
+    return value;
+}
+
+static bool cond_parse(cpu_debug_t *cpu, const char *cond, bool eval, uint32_t *result)
+{
+    cond_state cs = { cpu, cond, eval, false };
+    *result = cond_or(&cs);
+    return !cs.error && !cond_peek(&cs);
+}
+
+/*
+ * Called when an access matches a breakpoint to see whether it should
+ * take effect, i.e. its condition is true and it has been hit enough.
+ */
+
+static bool point_fires(cpu_debug_t *cpu, breakpoint *bp)
+{
+    if (bp->cond) {
+        uint32_t result;
+        if (!cond_parse(cpu, bp->cond, true, &result)) {
+            debug_outf("cpu %s: bad condition on breakpoint %i\n", cpu->cpu_name, bp->num);
+            return true;
+        }
+        if (!result)
+            return false;
+    }
+    return ++bp->hits >= bp->count;
+}
+
 static void print_point(cpu_debug_t *cpu, const breakpoint *bp, const char *desc, const char *tail)
 {
     char start_buf[17 + SYM_MAX];
@@ -663,12 +935,19 @@ static void print_point(cpu_debug_t *cpu, const breakpoint *bp, const char *desc
     }
     cpu->print_addr(cpu, bp->start, start_buf, sizeof(start_buf), true);
     if (bp->start == bp->end)
-        debug_outf("    %s %i at %s%s%s\n", desc, bp->num, start_buf, tail, bx_msg);
+        debug_outf("    %s %i at %s%s%s", desc, bp->num, start_buf, tail, bx_msg);
     else {
         char end_buf[17 + SYM_MAX];
         cpu->print_addr(cpu, bp->end, end_buf, sizeof(end_buf), true);
-        debug_outf("    %s %i %s to %s%s%s\n", desc, bp->num, start_buf, end_buf, tail, bx_msg);
+        debug_outf("    %s %i %s to %s%s%s", desc, bp->num, start_buf, end_buf, tail, bx_msg);
     }
+    if (bp->cond)
+        debug_outf(" if %s", bp->cond);
+    if (bp->count)
+        debug_outf(", hit %u of %u", bp->hits, bp->count);
+    else if (bp->cond)
+        debug_outf(", hit %u", bp->hits);
+    debug_out("\n", 1);
 }
 
 static void set_point(cpu_debug_t *cpu, break_type type, const char *desc, uint32_t start, uint32_t end)
@@ -691,7 +970,11 @@ static void set_point(cpu_debug_t *cpu, break_type type, const char *desc, uint3
         bp->type = type;
         bp->num = breakpseq++;
         bp->shutdown_on_hit = 0; /* TOHv3 */
+        bp->cond = NULL;
+        bp->hits = 0;
+        bp->count = 0;
         cpu->breakpoints = bp;
+        bp_map_update(cpu);
         print_point(cpu, bp, desc, " set");
     }
     else
@@ -734,8 +1017,9 @@ static void parse_clrpnt(cpu_debug_t *cpu, break_type type, char *arg, const cha
             prev->next = found->next;
         else
             cpu->breakpoints = found->next;
+        bp_map_update(cpu);
         print_point(cpu, found, desc, " cleared");
-        free(found);
+        free_point(found);
     }
 }
 
@@ -781,6 +1065,57 @@ static uint8_t find_breakpoint_by_address_or_index (cpu_debug_t *cpu,
     return 1; /* OK */
 }
 
+// Split the breakpoint number or address from what follows it.
+
+static char *split_point_arg(char *arg)
+{
+    char *rest = arg;
+    while (*rest && !isspace(*rest))
+        rest++;
+    if (*rest) {
+        *rest++ = '\0';
+        while (isspace(*rest))
+            rest++;
+    }
+    return rest;
+}
+
+static void debugger_bcond(cpu_debug_t *cpu, char *iptr)
+{
+    breakpoint *bp, *prev;
+    char *cond = split_point_arg(iptr);
+    if (find_breakpoint_by_address_or_index(cpu, 1, BREAK_EXEC, iptr, &bp, &prev)) {
+        char *copy = NULL;
+        if (*cond) {
+            uint32_t result;
+            if (!cond_parse(cpu, cond, false, &result)) {
+                debug_outf("    '%s' is not a valid condition\n", cond);
+                return;
+            }
+            if (!(copy = strdup(cond))) {
+                debug_outf("    unable to set condition, out of memory\n");
+                return;
+            }
+        }
+        if (bp->cond)
+            free(bp->cond);
+        bp->cond = copy;
+        bp->hits = 0;
+        print_point(cpu, bp, break_names[bp->type], "");
+    }
+}
+
+static void debugger_bcount(cpu_debug_t *cpu, char *iptr)
+{
+    breakpoint *bp, *prev;
+    char *count = split_point_arg(iptr);
+    if (find_breakpoint_by_address_or_index(cpu, 1, BREAK_EXEC, iptr, &bp, &prev)) {
+        bp->count = strtoul(count, NULL, 10);
+        bp->hits = 0;
+        print_point(cpu, bp, break_names[bp->type], "");
+    }
+}
+
 static void list_points(cpu_debug_t *cpu, break_type type, const char *desc)
 {
     for (breakpoint *bp = cpu->breakpoints; bp; bp = bp->next)
@@ -843,6 +1178,11 @@ static void debugger_save(cpu_debug_t *cpu, char *iptr)
                     cpu->print_addr(cpu, bp->end, end_buf, sizeof(end_buf), true);
                     fprintf(sfp, "%s %s %s\n", break_names[bp->type], start_buf, end_buf);
                 }
+                // The point just set is found first by its address.
+                if (bp->cond)
+                    fprintf(sfp, "bcond %s %s\n", start_buf, bp->cond);
+                if (bp->count)
+                    fprintf(sfp, "bcount %s %u\n", start_buf, bp->count);
                 bp = bp->next;
             }
             while (bp);
@@ -1122,6 +1462,17 @@ static prof_pair *debugger_profcount(cpu_debug_t *cpu, unsigned *nitem)
 
 static void debugger_profile(cpu_debug_t *cpu, const char *iptr)
 {
+    if (!strncasecmp(iptr, "subsys", 6)) {
+        iptr += 6;
+        while (isspace(*iptr))
+            ++iptr;
+        hostprof_print(debug_outf);
+        if (!strcasecmp(iptr, "reset")) {
+            hostprof_reset();
+            debug_outf("subsystem counters reset\n");
+        }
+        return;
+    }
     if (cpu->prof_counts) {
         if (!strcasecmp(iptr, "stop")) {
             free(cpu->prof_counts);
@@ -1374,7 +1725,8 @@ static void debug_trange(cpu_debug_t *cpu, char *iptr)
                 prev->next = found->next;
             else
                 cpu->breakpoints = found->next;
-            free(found);
+            free_point(found);
+            bp_map_update(cpu);
         }
         parse_setpnt(cpu, TRACE_EXEC, iptr, "execution trace");
     }
@@ -1382,7 +1734,7 @@ static void debug_trange(cpu_debug_t *cpu, char *iptr)
         debug_outf("missing address");
 }
 
-void debugger_do(cpu_debug_t *cpu, uint32_t addr)
+static void debugger_loop(cpu_debug_t *cpu, uint32_t addr)
 {
     uint32_t next_addr;
     char ins[256];
@@ -1486,7 +1838,12 @@ void debugger_do(cpu_debug_t *cpu, uint32_t addr)
                     if (find_breakpoint_by_address_or_index (cpu, 1, BREAK_EXEC, iptr, &bp_found, &bp_prev)) {
                         bp_found->shutdown_on_hit = 1;
                     }
-                } else
+                }
+                else if (!strncmp(cmd, "bcond", cmdlen))
+                    debugger_bcond(cpu, iptr);
+                else if (!strncmp(cmd, "bcount", cmdlen))
+                    debugger_bcount(cpu, iptr);
+                else
                     badcmd = true;
                 break;
 
@@ -1555,9 +1912,9 @@ void debugger_do(cpu_debug_t *cpu, uint32_t addr)
 
             case 'p':
                 if (!strncmp(cmd, "paste", cmdlen))
-                    debug_paste(iptr, os_paste_start);
+                    debug_paste(iptr, movie_paste_os);
                 else if (!strncmp(cmd, "pastek", cmdlen))
-                    debug_paste(iptr, key_paste_start);
+                    debug_paste(iptr, movie_paste_kbd);
                 else if (!strncmp(cmd, "profile", cmdlen))
                     debugger_profile(cpu, iptr);
                 else
@@ -1569,6 +1926,15 @@ void debugger_do(cpu_debug_t *cpu, uint32_t addr)
                     main_reset();
                     debug_outf("Emulator reset\n");
                 }
+                else if (cmdlen >= 3 && !strncmp(cmd, "rewind", cmdlen)) {
+                    int steps = *iptr ? atoi(iptr) : 1;
+                    if (steps > 0) {
+                        rewind_step(steps);
+                        debug_outf("Will rewind %d snapshot(s) when execution continues\n", steps);
+                    }
+                    else
+                        debug_outf("Invalid number of snapshots\n");
+                }
                 else if (cmdlen >= 2 && !strncmp(cmd, "rset", cmdlen))
                     debugger_rset(cpu, iptr);
                 else if (cmdlen >= 2 && !strncmp(cmd, "ruler", cmdlen))
@@ -1744,6 +2110,16 @@ void debugger_do(cpu_debug_t *cpu, uint32_t addr)
     }
 }
 
+// Time spent waiting for debugger commands is not charged to the
+// subsystem which happened to hit the breakpoint.
+
+void debugger_do(cpu_debug_t *cpu, uint32_t addr)
+{
+    hostprof_t hostprof_prev = hostprof_enter(HOSTPROF_NONE);
+    debugger_loop(cpu, addr);
+    hostprof_leave(hostprof_prev);
+}
+
 static void hit_point(cpu_debug_t *cpu, uint32_t addr, uint32_t value, const char *enter, const char *desc)
 {
         char addr_str[20 + SYM_MAX], iaddr_str[20 + SYM_MAX];
@@ -1760,8 +2136,10 @@ static void check_points(cpu_debug_t *cpu, uint32_t addr, uint32_t value, uint8_
     bool found = false;
     const char *enter = "";
 
+    if (!bp_maybe(cpu, break_access[btype], addr))
+        return;
     for (breakpoint *bp = cpu->breakpoints; bp; bp = bp->next) {
-        if (addr >= bp->start && addr <= bp->end) {
+        if (addr >= bp->start && addr <= bp->end && (bp->type == btype || bp->type == wtype) && point_fires(cpu, bp)) {
             if (bp->type == btype) {
                 found = true;
                 enter = "break on";
@@ -1787,15 +2165,20 @@ void debug_memwrite(cpu_debug_t *cpu, uint32_t addr, uint32_t value, uint8_t siz
     const char *desc = "write to";
     const char *enter = "";
 
+    if (!bp_maybe(cpu, ACCESS_WRITE, addr))
+        return;
     for (breakpoint *bp = cpu->breakpoints; bp; bp = bp->next) {
-        if (addr >= bp->start && addr <= bp->end) {
+        if (addr >= bp->start && addr <= bp->end && break_access[bp->type] == ACCESS_WRITE) {
+            bool changed = (bp->type == BREAK_CHANGE || bp->type == WATCH_CHANGE) && cpu->memread(addr) != value;
+            if ((bp->type == BREAK_WRITE || bp->type == WATCH_WRITE || changed) && !point_fires(cpu, bp))
+                continue;
             if (bp->type == BREAK_WRITE) {
                 found = true;
                 enter = "break on";
                 break;
             }
             else if (bp->type == BREAK_CHANGE) {
-                if (cpu->memread(addr) != value) {
+                if (changed) {
                     found = true;
                     enter = "break on";
                     desc = "change of";
@@ -1807,7 +2190,7 @@ void debug_memwrite(cpu_debug_t *cpu, uint32_t addr, uint32_t value, uint8_t siz
                 break;
             }
             else if (bp->type == WATCH_CHANGE) {
-                if (cpu->memread(addr) != value) {
+                if (changed) {
                     found = true;
                     desc = "change of";
                     break;
@@ -1894,8 +2277,12 @@ void debug_preexec(cpu_debug_t *cpu, uint32_t addr)
 
     shut_it_down = 0; /* TOHv3 */
 
-    for (breakpoint *bp = cpu->breakpoints; bp; bp = bp->next) {
-        if (addr >= bp->start && addr <= bp->end) {
+    // Only search the list if there may be a point at this address.
+    breakpoint *first = bp_maybe(cpu, ACCESS_EXEC, addr) ? cpu->breakpoints : NULL;
+    for (breakpoint *bp = first; bp; bp = bp->next) {
+        if (addr >= bp->start && addr <= bp->end && break_access[bp->type] == ACCESS_EXEC) {
+            if (!point_fires(cpu, bp))
+                continue;
             if (bp->type == BREAK_EXEC) {
                 char addr_str[16+SYM_MAX];
                 cpu->print_addr(cpu, addr, addr_str, sizeof(addr_str), true);
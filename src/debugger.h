@@ -9,6 +9,7 @@ extern void debug_toggle_tube(void);
 extern void debug_paste(const char *str, void (*paste_start)(char *str));
 
 extern int readc[65536], writec[65536], fetchc[65536];
+extern bool debug_memview;
 
 extern int debug_core,debug_tube,debug_step;
 
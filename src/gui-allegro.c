@@ -17,9 +17,11 @@
 #include "mmb.h"
 #include "model.h"
 #include "mouse.h"
+#include "movie.h"
 #include "music5000.h"
 #include "mmccard.h"
 #include "paula.h"
+#include "rewind.h"
 #include "savestate.h"
 #include "sid_b-em.h"
 #include "scsi.h"
@@ -120,6 +122,10 @@ static ALLEGRO_MENU *create_file_menu(void)
     al_append_menu_item(menu, "Hard Reset", IDM_FILE_RESET, 0, NULL, NULL);
     al_append_menu_item(menu, "Load state...", IDM_FILE_LOAD_STATE, 0, NULL, NULL);
     al_append_menu_item(menu, "Save State...", IDM_FILE_SAVE_STATE, 0, NULL, NULL);
+    al_append_menu_item(menu, "Rewind", IDM_FILE_REWIND, 0, NULL, NULL);
+    al_append_menu_item(menu, "Record movie...", IDM_FILE_MOVIE_RECORD, 0, NULL, NULL);
+    al_append_menu_item(menu, "Replay movie...", IDM_FILE_MOVIE_REPLAY, 0, NULL, NULL);
+    al_append_menu_item(menu, "Stop movie", IDM_FILE_MOVIE_STOP, 0, NULL, NULL);
     al_append_menu_item(menu, "Save Screenshot...", IDM_FILE_SCREEN_SHOT, 0, NULL, NULL);
     al_append_menu_item(menu, "Save Screen as Text...", IDM_FILE_SCREEN_TEXT, 0, NULL, NULL);
     al_append_menu_item(menu, "Printing...", 0, 0, NULL, create_print_menu());
@@ -189,6 +195,8 @@ static ALLEGRO_MENU *create_disc_menu(void)
 void gui_allegro_set_eject_text(int drive, ALLEGRO_PATH *path)
 {
     char temp[256];
+    if (!disc_menu)
+        return; // headless, no menus.
     if (path)
         snprintf(temp, sizeof temp, "Eject drive %s: %s", drive ? "1/3" : "0/2", al_get_path_filename(path));
     else
@@ -203,6 +211,8 @@ static ALLEGRO_MENU *create_tape_menu(void)
     int nflags, fflags;
     al_append_menu_item(menu, "Load tape...", IDM_TAPE_LOAD, 0, NULL, NULL);
     al_append_menu_item(menu, "Rewind tape", IDM_TAPE_REWIND, 0, NULL, NULL);
+    al_append_menu_item(menu, "Next file", IDM_TAPE_NEXT, 0, NULL, NULL);
+    al_append_menu_item(menu, "Previous file", IDM_TAPE_PREV, 0, NULL, NULL);
     al_append_menu_item(menu, "Eject tape", IDM_TAPE_EJECT, 0, NULL, NULL);
     al_append_menu_item(menu, "Catalogue tape", IDM_TAPE_CAT, 0, NULL, NULL);
     if (fasttape) {
@@ -343,6 +353,7 @@ static ALLEGRO_MENU *create_tube_menu(void)
         for (int i = 0; i < NUM_TUBE_SPEEDS; i++)
             add_radio_item(sub, tube_speeds[i].name, IDM_TUBE_SPEED, i, tube_speed_num);
         al_append_menu_item(menu, "Tube speed", 0, 0, NULL, sub);
+        add_checkbox_item(menu, "Run on own thread", IDM_TUBE_THREAD, tube_threaded);
         return menu;
     }
     else {
@@ -589,6 +600,7 @@ static ALLEGRO_MENU *create_settings_menu(void)
     al_append_menu_item(menu, "Keyboard", 0, 0, NULL, create_keyboard_menu());
     al_append_menu_item(menu, "Jim Memory", 0, 0, NULL, create_jim_menu());
     add_checkbox_item(menu, "Auto-Pause", IDM_AUTO_PAUSE, autopause);
+    add_checkbox_item(menu, "Rewind Snapshots", IDM_REWIND_ENABLE, rewind_enabled);
     add_checkbox_item(menu, "Mouse (AMX)", IDM_MOUSE_AMX, mouse_amx);
     if (joystick_count > 0)
         al_append_menu_item(menu, "Joysticks", 0, 0, NULL, create_joysticks_menu());
@@ -789,7 +801,8 @@ static void edit_print_clip(ALLEGRO_EVENT *event)
 
 void gui_set_disc_wprot(int drive, bool enabled)
 {
-    al_set_menu_item_flags(disc_menu, menu_id_num(IDM_DISC_WPROT, drive), enabled ? ALLEGRO_MENU_ITEM_CHECKBOX|ALLEGRO_MENU_ITEM_CHECKED : ALLEGRO_MENU_ITEM_CHECKBOX);
+    if (disc_menu)
+        al_set_menu_item_flags(disc_menu, menu_id_num(IDM_DISC_WPROT, drive), enabled ? ALLEGRO_MENU_ITEM_CHECKBOX|ALLEGRO_MENU_ITEM_CHECKED : ALLEGRO_MENU_ITEM_CHECKBOX);
 }
 
 static void disc_choose_new(ALLEGRO_EVENT *event, const char *ext)
@@ -1008,12 +1021,6 @@ static void tape_load_ui(ALLEGRO_EVENT *event)
     }
 }
 
-static void tape_rewind(void)
-{
-    tape_close();
-    tape_load(tape_fn);
-}
-
 static void tape_eject(void)
 {
     tape_close();
@@ -1193,6 +1200,18 @@ void gui_allegro_event(ALLEGRO_EVENT *event)
         case IDM_FILE_SAVE_STATE:
             file_chooser_generic(event, savestate_name, "Save state to file", "*.snp", ALLEGRO_FILECHOOSER_SAVE, savestate_save);
             break;
+        case IDM_FILE_REWIND:
+            rewind_step(1);
+            break;
+        case IDM_FILE_MOVIE_RECORD:
+            file_chooser_generic(event, savestate_name, "Record movie to file", "*.bmv", ALLEGRO_FILECHOOSER_SAVE, movie_record);
+            break;
+        case IDM_FILE_MOVIE_REPLAY:
+            file_chooser_generic(event, savestate_name, "Replay movie from file", "*.bmv", ALLEGRO_FILECHOOSER_FILE_MUST_EXIST, movie_replay);
+            break;
+        case IDM_FILE_MOVIE_STOP:
+            movie_stop();
+            break;
         case IDM_FILE_SCREEN_SHOT:
             file_chooser_generic(event, vid_scrshotname, "Save screenshot to file", "*.bmp;*.pcx;*.tga;*.png;*.jpg", ALLEGRO_FILECHOOSER_SAVE, file_save_scrshot);
             break;
@@ -1218,10 +1237,10 @@ void gui_allegro_event(ALLEGRO_EVENT *event)
             set_quit();
             break;
         case IDM_EDIT_PASTE_OS:
-            edit_paste_start(event, os_paste_start);
+            edit_paste_start(event, movie_paste_os);
             break;
         case IDM_EDIT_PASTE_KB:
-            edit_paste_start(event, key_paste_start);
+            edit_paste_start(event, movie_paste_kbd);
             break;
         case IDM_EDIT_COPY:
             edit_print_clip(event);
@@ -1298,6 +1317,12 @@ void gui_allegro_event(ALLEGRO_EVENT *event)
         case IDM_TAPE_REWIND:
             tape_rewind();
             break;
+        case IDM_TAPE_NEXT:
+            tape_seek_file(1);
+            break;
+        case IDM_TAPE_PREV:
+            tape_seek_file(-1);
+            break;
         case IDM_TAPE_EJECT:
             tape_eject();
             break;
@@ -1328,6 +1353,9 @@ void gui_allegro_event(ALLEGRO_EVENT *event)
         case IDM_TUBE_SPEED:
             change_tube_speed(event);
             break;
+        case IDM_TUBE_THREAD:
+            tube_threaded = !tube_threaded;
+            break;
         case IDM_VIDEO_DISPTYPE:
             video_set_disptype(radio_event_simple(event, vid_dtype_user));
             break;
@@ -1477,6 +1505,11 @@ void gui_allegro_event(ALLEGRO_EVENT *event)
         case IDM_AUTO_PAUSE:
             autopause = !autopause;
             break;
+        case IDM_REWIND_ENABLE:
+            rewind_enabled = !rewind_enabled;
+            if (!rewind_enabled)
+                rewind_clear();
+            break;
         case IDM_MOUSE_AMX:
             mouse_amx = !mouse_amx;
             break;
@@ -6,6 +6,10 @@ typedef enum {
     IDM_FILE_RESET,
     IDM_FILE_LOAD_STATE,
     IDM_FILE_SAVE_STATE,
+    IDM_FILE_REWIND,
+    IDM_FILE_MOVIE_RECORD,
+    IDM_FILE_MOVIE_REPLAY,
+    IDM_FILE_MOVIE_STOP,
     IDM_FILE_SCREEN_SHOT,
     IDM_FILE_SCREEN_TEXT,
     IDM_FILE_PRINT,
@@ -45,6 +49,8 @@ typedef enum {
     IDM_DISC_VDFS_ROOT,
     IDM_TAPE_LOAD,
     IDM_TAPE_REWIND,
+    IDM_TAPE_NEXT,
+    IDM_TAPE_PREV,
     IDM_TAPE_EJECT,
     IDM_TAPE_CAT,
     IDM_TAPE_SPEED_NORMAL,
@@ -55,6 +61,7 @@ typedef enum {
     IDM_MODEL,
     IDM_TUBE,
     IDM_TUBE_SPEED,
+    IDM_TUBE_THREAD,
     IDM_VIDEO_DISPTYPE,
     IDM_VIDEO_COLTYPE,
     IDM_VIDEO_BORDERS,
@@ -102,6 +109,7 @@ typedef enum {
     IDM_KEY_PAD,
     IDM_JIM_SIZE,
     IDM_AUTO_PAUSE,
+    IDM_REWIND_ENABLE,
     IDM_MOUSE_AMX,
     IDM_TRIACK_SEGA_ADAPTER,
     IDM_MOUSE_STICK,
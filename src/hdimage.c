@@ -0,0 +1,348 @@
+/*B-em hard disc image access
+  Shared by the SCSI and IDE emulation.  Where the host allows it the
+  image is mapped into memory so a sector is read or written by copying
+  it rather than by a seek and a system call, and the host writes
+  changes back to the file in its own time.
+
+  If an overlay directory is configured the image itself is only read
+  and each sector written goes instead to an overlay file in that
+  directory, named after the image with the extension .ovl, so several
+  copies of the emulator can share one master image.  The overlay is a
+  header followed by records, each a sector number and the contents of
+  that sector, in the order sectors were first written.*/
+
+#include <errno.h>
+#include "b-em.h"
+#include "hdimage.h"
+
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MMAP)
+#define HDIMAGE_MMAP
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define HD_BLOCK      256
+#define HD_MAP_CHUNK  (64 * 1024 * 1024)    // address space mapped at a time.
+
+#define OVL_MAGIC     "BEMOVL01"
+#define OVL_HEADER    12                    // magic and flags.
+#define OVL_RECORD    (4 + HD_BLOCK)        // sector number and contents.
+#define OVL_NO_IMAGE  0x01                  // formatted, ignore the image.
+
+const char *hdimage_overlay_dir = NULL;
+
+struct hdimage {
+    FILE *fp;           // the image, or NULL if it is not used.
+    size_t base;        // bytes of the image file.
+    size_t size;        // bytes of the image including the overlay.
+    uint8_t *map;       // the image mapped into memory, or NULL.
+    size_t maplen;
+    FILE *ofp;          // the overlay, or NULL.
+    uint32_t *index;    // overlay record + 1 for each sector, 0 if none.
+    size_t nindex;
+    uint32_t records;
+};
+
+#ifdef HDIMAGE_MMAP
+
+/*
+ * Map more than the file currently holds so it can grow, as a format
+ * does, without having to be mapped again each time.
+ */
+
+static bool hdimage_map(hdimage_t *hd, size_t need, bool writable)
+{
+    size_t len = (need / HD_MAP_CHUNK + 1) * HD_MAP_CHUNK;
+    void *map = mmap(NULL, len, writable ? PROT_READ|PROT_WRITE : PROT_READ, MAP_SHARED, fileno(hd->fp), 0);
+    if (map == MAP_FAILED) {
+        log_warn("hdimage: unable to map image, using file access: %s", strerror(errno));
+        return false;
+    }
+    if (hd->map)
+        munmap(hd->map, hd->maplen);
+    hd->map = map;
+    hd->maplen = len;
+    return true;
+}
+
+static void hdimage_unmap(hdimage_t *hd)
+{
+    if (hd->map) {
+        msync(hd->map, hd->base, MS_SYNC);
+        munmap(hd->map, hd->maplen);
+        hd->map = NULL;
+    }
+}
+
+#endif
+
+static bool image_read(hdimage_t *hd, size_t pos, uint8_t *dest, size_t len)
+{
+    size_t avail = pos < hd->base ? hd->base - pos : 0;
+    if (avail > len)
+        avail = len;
+    if (avail) {
+        if (hd->map)
+            memcpy(dest, hd->map + pos, avail);
+        else if (fseek(hd->fp, pos, SEEK_SET) || fread(dest, avail, 1, hd->fp) != 1) {
+            log_warn("hdimage: read error: %s", strerror(errno));
+            return false;
+        }
+    }
+    // Beyond the end of the image reads as zeros.
+    memset(dest + avail, 0, len - avail);
+    return true;
+}
+
+static bool image_write(hdimage_t *hd, size_t pos, const uint8_t *src, size_t len)
+{
+    size_t end = pos + len;
+#ifdef HDIMAGE_MMAP
+    if (hd->map) {
+        if (end > hd->base) {
+            if (ftruncate(fileno(hd->fp), end)) {
+                log_warn("hdimage: unable to extend image: %s", strerror(errno));
+                return false;
+            }
+            hd->base = end;
+            if (end > hd->maplen && !hdimage_map(hd, end, true))
+                hdimage_unmap(hd);
+        }
+        if (hd->map) {
+            memcpy(hd->map + pos, src, len);
+            return true;
+        }
+    }
+#endif
+    if (fseek(hd->fp, pos, SEEK_SET) || fwrite(src, len, 1, hd->fp) != 1) {
+        log_warn("hdimage: write error: %s", strerror(errno));
+        return false;
+    }
+    if (end > hd->base)
+        hd->base = end;
+    return true;
+}
+
+static bool overlay_index(hdimage_t *hd, size_t sector)
+{
+    if (sector >= hd->nindex) {
+        size_t nindex = hd->nindex ? hd->nindex : 4096;
+        while (nindex <= sector)
+            nindex *= 2;
+        uint32_t *index = realloc(hd->index, nindex * sizeof(uint32_t));
+        if (!index) {
+            log_error("hdimage: out of memory for overlay index");
+            return false;
+        }
+        memset(index + hd->nindex, 0, (nindex - hd->nindex) * sizeof(uint32_t));
+        hd->index = index;
+        hd->nindex = nindex;
+    }
+    return true;
+}
+
+static bool overlay_read(hdimage_t *hd, uint32_t rec, size_t off, uint8_t *dest, size_t len)
+{
+    if (fseek(hd->ofp, OVL_HEADER + (long)rec * OVL_RECORD + 4 + off, SEEK_SET) || fread(dest, len, 1, hd->ofp) != 1) {
+        log_warn("hdimage: overlay read error: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+static bool overlay_write(hdimage_t *hd, size_t sector, size_t off, const uint8_t *src, size_t len)
+{
+    uint32_t rec;
+    if (!overlay_index(hd, sector))
+        return false;
+    if ((rec = hd->index[sector])) {
+        if (fseek(hd->ofp, OVL_HEADER + (long)(rec - 1) * OVL_RECORD + 4 + off, SEEK_SET) || fwrite(src, len, 1, hd->ofp) != 1) {
+            log_warn("hdimage: overlay write error: %s", strerror(errno));
+            return false;
+        }
+    }
+    else {
+        // First write to this sector, start from what the image holds.
+        uint8_t record[OVL_RECORD];
+        record[0] = sector;
+        record[1] = sector >> 8;
+        record[2] = sector >> 16;
+        record[3] = sector >> 24;
+        if (len < HD_BLOCK && !image_read(hd, sector * HD_BLOCK, record + 4, HD_BLOCK))
+            return false;
+        memcpy(record + 4 + off, src, len);
+        if (fseek(hd->ofp, OVL_HEADER + (long)hd->records * OVL_RECORD, SEEK_SET) || fwrite(record, OVL_RECORD, 1, hd->ofp) != 1) {
+            log_warn("hdimage: overlay write error: %s", strerror(errno));
+            return false;
+        }
+        hd->index[sector] = ++hd->records;
+    }
+    return true;
+}
+
+static bool overlay_open(hdimage_t *hd, const char *fn, bool create, bool *use_image)
+{
+    ALLEGRO_PATH *path = al_create_path_for_directory(hdimage_overlay_dir);
+    ALLEGRO_PATH *image = al_create_path(fn);
+    al_set_path_filename(path, al_get_path_filename(image));
+    al_set_path_extension(path, ".ovl");
+    al_destroy_path(image);
+    const char *cpath = al_path_cstr(path, ALLEGRO_NATIVE_PATH_SEP);
+    unsigned char hdr[OVL_HEADER];
+    uint8_t record[OVL_RECORD];
+    bool ok = false;
+
+    if (!create && (hd->ofp = fopen(cpath, "rb+"))) {
+        if (fread(hdr, sizeof(hdr), 1, hd->ofp) != 1 || memcmp(hdr, OVL_MAGIC, 8))
+            log_error("hdimage: %s is not an overlay file", cpath);
+        else {
+            // A record cut short, by a crash say, is overwritten by the next.
+            while (fread(record, OVL_RECORD, 1, hd->ofp) == 1) {
+                size_t sector = record[0] | (record[1] << 8) | (record[2] << 16) | ((size_t)record[3] << 24);
+                if (!overlay_index(hd, sector))
+                    break;
+                hd->index[sector] = ++hd->records;
+                if ((sector + 1) * HD_BLOCK > hd->size)
+                    hd->size = (sector + 1) * HD_BLOCK;
+            }
+            *use_image = !(hdr[8] & OVL_NO_IMAGE);
+            ok = true;
+        }
+    }
+    else if ((hd->ofp = fopen(cpath, "wb+"))) {
+        memcpy(hdr, OVL_MAGIC, 8);
+        hdr[8] = create ? OVL_NO_IMAGE : 0;
+        hdr[9] = hdr[10] = hdr[11] = 0;
+        if (fwrite(hdr, sizeof(hdr), 1, hd->ofp) == 1) {
+            *use_image = !create;
+            ok = true;
+        }
+        else
+            log_error("hdimage: unable to write overlay %s: %s", cpath, strerror(errno));
+    }
+    else
+        log_error("hdimage: unable to open overlay %s: %s", cpath, strerror(errno));
+    if (ok)
+        log_info("hdimage: writes to %s go to overlay %s", fn, cpath);
+    al_destroy_path(path);
+    return ok;
+}
+
+hdimage_t *hdimage_open(const char *fn, bool create)
+{
+    hdimage_t *hd = calloc(1, sizeof(*hd));
+    if (!hd) {
+        log_error("hdimage: out of memory opening %s", fn);
+        return NULL;
+    }
+    if (hdimage_overlay_dir) {
+        bool use_image = false;
+        if (!overlay_open(hd, fn, create, &use_image)) {
+            hdimage_close(hd);
+            return NULL;
+        }
+        if (use_image && !(hd->fp = fopen(fn, "rb")))
+            log_warn("hdimage: unable to open image %s, starting blank: %s", fn, strerror(errno));
+    }
+    else if (!(hd->fp = fopen(fn, create ? "wb+" : "rb+"))) {
+        log_error("hdimage: unable to open hard disc image %s: %s", fn, strerror(errno));
+        free(hd);
+        return NULL;
+    }
+    if (hd->fp) {
+        fseek(hd->fp, 0, SEEK_END);
+        hd->base = ftell(hd->fp);
+#ifdef HDIMAGE_MMAP
+        hdimage_map(hd, hd->base, !hd->ofp);
+#endif
+    }
+    if (hd->base > hd->size)
+        hd->size = hd->base;
+    return hd;
+}
+
+void hdimage_close(hdimage_t *hd)
+{
+    if (hd) {
+#ifdef HDIMAGE_MMAP
+        hdimage_unmap(hd);
+#endif
+        if (hd->fp)
+            fclose(hd->fp);
+        if (hd->ofp)
+            fclose(hd->ofp);
+        free(hd->index);
+        free(hd);
+    }
+}
+
+size_t hdimage_size(hdimage_t *hd)
+{
+    return hd->size;
+}
+
+bool hdimage_read(hdimage_t *hd, size_t pos, void *buf, size_t len)
+{
+    uint8_t *dest = buf;
+
+    if (!hd->ofp)
+        return image_read(hd, pos, dest, len);
+    while (len) {
+        size_t sector = pos / HD_BLOCK;
+        size_t off = pos % HD_BLOCK;
+        size_t chunk = HD_BLOCK - off;
+        if (chunk > len)
+            chunk = len;
+        uint32_t rec = sector < hd->nindex ? hd->index[sector] : 0;
+        if (rec) {
+            if (!overlay_read(hd, rec - 1, off, dest, chunk))
+                return false;
+        }
+        else if (!image_read(hd, pos, dest, chunk))
+            return false;
+        pos += chunk;
+        dest += chunk;
+        len -= chunk;
+    }
+    return true;
+}
+
+bool hdimage_write(hdimage_t *hd, size_t pos, const void *buf, size_t len)
+{
+    const uint8_t *src = buf;
+
+    if (pos + len > hd->size)
+        hd->size = pos + len;
+    if (!hd->ofp)
+        return image_write(hd, pos, src, len);
+    while (len) {
+        size_t sector = pos / HD_BLOCK;
+        size_t off = pos % HD_BLOCK;
+        size_t chunk = HD_BLOCK - off;
+        if (chunk > len)
+            chunk = len;
+        if (!overlay_write(hd, sector, off, src, chunk))
+            return false;
+        pos += chunk;
+        src += chunk;
+        len -= chunk;
+    }
+    return true;
+}
+
+/*
+ * Start writing changes back without waiting for them, as when the
+ * drive is stopped.  Closing the image waits for them.
+ */
+
+void hdimage_flush(hdimage_t *hd)
+{
+#ifdef HDIMAGE_MMAP
+    if (hd->map)
+        msync(hd->map, hd->base, MS_ASYNC);
+#endif
+    if (hd->fp)
+        fflush(hd->fp);
+    if (hd->ofp)
+        fflush(hd->ofp);
+}
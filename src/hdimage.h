@@ -0,0 +1,15 @@
+#ifndef __INC_HDIMAGE_H
+#define __INC_HDIMAGE_H
+
+typedef struct hdimage hdimage_t;
+
+extern const char *hdimage_overlay_dir;
+
+hdimage_t *hdimage_open(const char *fn, bool create);
+void hdimage_close(hdimage_t *hd);
+size_t hdimage_size(hdimage_t *hd);
+bool hdimage_read(hdimage_t *hd, size_t pos, void *buf, size_t len);
+bool hdimage_write(hdimage_t *hd, size_t pos, const void *buf, size_t len);
+void hdimage_flush(hdimage_t *hd);
+
+#endif
@@ -249,6 +249,12 @@ struct hfe_poll_state
 
 };
 
+/* A track decoded from the file, ready for get_next_bit(). */
+struct hfe_track
+{
+  unsigned char *data;
+  size_t bytes;
+};
 
 struct hfe_info
 {
@@ -263,6 +269,13 @@ struct hfe_info
   unsigned char *track_data;
   size_t track_data_bytes;
 
+  /* Decoded tracks, indexed by track * 2 + side.  Each is filled in
+     the first time the head visits it so stepping back to it later
+     does not read and decode the file again.  track_data points into
+     here.  Write operations are not supported so these never need
+     writing back. */
+  struct hfe_track *tracks;
+
   /* b-em calls our poll function every 16 clock cycles.  With a 2MHz
      clock that's 1.25e5 Hz (i.e. every 8 microseconds).  The floppy
      revolves at 300 RPM.  The total number of poll calls per
@@ -491,13 +504,16 @@ static void hfe_close(int drive)
           clear_op_state(&hfe_info[drive]->state);
         }
       hfe_info[drive]->current_track = NO_TRACK;
-      if (hfe_info[drive]->track_data)
+      hfe_info[drive]->track_data = NULL;
+      hfe_info[drive]->track_data_bytes = 0;
+      if (hfe_info[drive]->tracks)
         {
-          free(hfe_info[drive]->track_data);
-          hfe_info[drive]->track_data = NULL;
-
+          int i;
+          for (i = 0; i < hfe_info[drive]->header.number_of_track * 2; ++i)
+            free(hfe_info[drive]->tracks[i].data);
+          free(hfe_info[drive]->tracks);
+          hfe_info[drive]->tracks = NULL;
         }
-      hfe_info[drive]->track_data_bytes = 0;
       hfe_info[drive]->poll_calls_per_bit = 1;
       free(hfe_info[drive]);
       log_debug("hfe: drive %d: hfe_close setting hfe_info[%d] to NULL", drive, drive);
@@ -788,8 +804,10 @@ static bool hfe_read_track_data(int drive, int track, int side,
     }
   if (!hfe_read_at_pos(hfe_info[drive]->fp, pos, len, in, err))
     {
-      if (!err)
+      if (!*err)
         log_error("hfe: short read on track data for drive %d track %d", drive, track);
+      free(in);
+      free(out);
       return false;
     }
   hfe_reverse_bit_order(in, len);
@@ -802,6 +820,7 @@ static bool hfe_read_track_data(int drive, int track, int side,
                                      encoding, drive, track,
                                      in + begin, 256, out + (*bytes_read));
     }
+  free(in);
   *result = out;
   return true;
 }
@@ -820,8 +839,7 @@ static void hfe_seek(int drive, int track)
   int err = 0;
   const int side = 0;           /* XXX: how are sides selected? */
   struct track_data_pos where;
-  unsigned char *trackbits = NULL;
-  size_t track_len = 0;
+  struct hfe_track *cached;
 
   log_info("hfe: drive %d seek to track %d", drive, track);
   if (NULL == hfe_info[drive]->fp)
@@ -843,33 +861,33 @@ static void hfe_seek(int drive, int track)
     }
 
   log_debug("hfe: drive %d: seek to track %d", drive, track);
-  if (!hfe_locate_track_data(drive, track, &where, &err))
-    {
-      hfe_track_load_failed(drive, track, err);
-      hfe_undiagnosed_failure(drive);
-      return;
-    }
-  log_debug("hfe: drive %d: track %d data: %lu bytes at %lu", drive, track, where.len, where.pos);
   const unsigned char encoding = encoding_of_track(drive, side, track);
-  if (!hfe_read_track_data(drive, track, side, where.pos, where.len,
-                           encoding, &trackbits, &track_len, &err))
+  cached = &hfe_info[drive]->tracks[track * 2 + side];
+  if (!cached->data)
     {
-      hfe_track_load_failed(drive, track, err);
-      hfe_undiagnosed_failure(drive);
-      return;
-    }
+      if (!hfe_locate_track_data(drive, track, &where, &err))
+        {
+          hfe_track_load_failed(drive, track, err);
+          hfe_undiagnosed_failure(drive);
+          return;
+        }
+      log_debug("hfe: drive %d: track %d data: %lu bytes at %lu", drive, track, where.len, where.pos);
+      if (!hfe_read_track_data(drive, track, side, where.pos, where.len,
+                               encoding, &cached->data, &cached->bytes, &err))
+        {
+          cached->data = NULL;
+          hfe_track_load_failed(drive, track, err);
+          hfe_undiagnosed_failure(drive);
+          return;
+        }
 #ifdef DUMP_TRACK
-  log_dump("hfe: track", trackbits, track_len);
+      log_dump("hfe: track", cached->data, cached->bytes);
 #endif
-  if (hfe_info[drive]->track_data)
-    {
-      free(hfe_info[drive]->track_data);
-      hfe_info[drive]->track_data = NULL;
     }
 
   hfe_info[drive]->current_track = track;
-  hfe_info[drive]->track_data = trackbits;
-  hfe_info[drive]->track_data_bytes = track_len;
+  hfe_info[drive]->track_data = cached->data;
+  hfe_info[drive]->track_data_bytes = cached->bytes;
   hfe_info[drive]->poll_calls_per_bit = encoding ? 1 : 2;
   log_debug("hfe: seek: loaded %lu bytes of data for drive %d track %d at %p",
             (unsigned long)hfe_info[drive]->track_data_bytes,
@@ -1707,6 +1725,7 @@ static void init_hfe_info(struct hfe_info *p, FILE *f)
   p->current_track = NO_TRACK;
   p->track_data = NULL;
   p->track_data_bytes = 0;
+  p->tracks = NULL;
   p->fp = f;
   init_hfe_poll_state(&p->state, p->poll_calls_per_bit);
 }
@@ -1774,13 +1793,23 @@ int hfe_load(int drive, const char *fn)
     {
       log_error("hfe: HFE disc image '%s' has an invalid header", fn);
       /* unwind the initialization. */
-      free(hfe_info[drive]);
       fclose(hfe_info[drive]->fp);
+      free(hfe_info[drive]);
       log_warn("hfe: drive %d: hfe_load setting hfe_info[%d] to NULL (after failing to load %s)",
                drive, drive, fn);
       hfe_info[drive] = NULL;
       return -1;
     }
+  hfe_info[drive]->tracks = calloc(hfe_info[drive]->header.number_of_track * 2,
+                                   sizeof(*hfe_info[drive]->tracks));
+  if (!hfe_info[drive]->tracks)
+    {
+      log_error("hfe: out of memory for track cache of '%s'", fn);
+      fclose(hfe_info[drive]->fp);
+      free(hfe_info[drive]);
+      hfe_info[drive] = NULL;
+      return -1;
+    }
   drives[drive].close       = hfe_close;
   drives[drive].seek        = hfe_seek;
   drives[drive].readsector  = hfe_readsector;
@@ -0,0 +1,57 @@
+/*B-em host time profiling by subsystem
+  See hostprof.h for how time is charged.*/
+
+#include <inttypes.h>
+#include "b-em.h"
+#include "hostprof.h"
+
+#ifdef BEM_PROFILE
+
+static const char *const hostprof_names[HOSTPROF_MAX] = {
+    "none", "6502", "video", "via", "sound", "sid", "music5000", "disc", "other", "tube"
+};
+
+hostprof_t hostprof_cur;
+uint64_t hostprof_mark;
+uint64_t hostprof_ticks[HOSTPROF_MAX];
+uint64_t hostprof_calls[HOSTPROF_MAX];
+
+void hostprof_reset(void)
+{
+    memset(hostprof_ticks, 0, sizeof(hostprof_ticks));
+    memset(hostprof_calls, 0, sizeof(hostprof_calls));
+    hostprof_mark = hostprof_now();
+}
+
+void hostprof_print(hostprof_outf_t outf)
+{
+    uint64_t total = 0;
+
+    // Bring the running subsystem up to date so nothing is missed.
+    hostprof_t cur = hostprof_cur;
+    hostprof_leave(cur);
+    hostprof_cur = cur;
+
+    for (int sub = HOSTPROF_CPU; sub < HOSTPROF_MAX; sub++)
+        total += hostprof_ticks[sub];
+    if (!total) {
+        outf("    no emulation time recorded\n");
+        return;
+    }
+    outf("    %-10s %16s %6s %14s\n", "subsystem", HOSTPROF_UNIT, "%", "calls");
+    for (int sub = HOSTPROF_CPU; sub < HOSTPROF_MAX; sub++)
+        if (hostprof_ticks[sub])
+            outf("    %-10s %16" PRIu64 " %6.2f %14" PRIu64 "\n", hostprof_names[sub], hostprof_ticks[sub], hostprof_ticks[sub] * 100.0 / total, hostprof_calls[sub]);
+    outf("    %-10s %16" PRIu64 "\n", "total", total);
+}
+
+#else
+
+void hostprof_reset(void) {}
+
+void hostprof_print(hostprof_outf_t outf)
+{
+    outf("    subsystem profiling not compiled in, configure with --enable-profile\n");
+}
+
+#endif
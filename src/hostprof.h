@@ -0,0 +1,90 @@
+#ifndef __INC_HOSTPROF_H
+#define __INC_HOSTPROF_H
+
+/*
+ * Host time profiling by subsystem.  Time is charged to whichever
+ * subsystem was entered most recently so nested calls, for example the
+ * SID being filled from the sound poll, are not counted twice.  This
+ * is only compiled in with BEM_PROFILE defined (configure with
+ * --enable-profile); otherwise the wrappers cost nothing.
+ */
+
+typedef enum {
+    HOSTPROF_NONE,      // not emulating, e.g. between slices or in the debugger.
+    HOSTPROF_CPU,       // 6502 core, memory and I/O dispatch.
+    HOSTPROF_VIDEO,
+    HOSTPROF_VIA,
+    HOSTPROF_SOUND,
+    HOSTPROF_SID,
+    HOSTPROF_M5000,
+    HOSTPROF_DISC,
+    HOSTPROF_OTHER,     // ACIA, tape, IDE, ADC and mouse.
+    HOSTPROF_TUBE,
+    HOSTPROF_MAX
+} hostprof_t;
+
+typedef void (*hostprof_outf_t)(const char *fmt, ...);
+
+#ifdef BEM_PROFILE
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define HOSTPROF_UNIT "TSC ticks"
+static inline uint64_t hostprof_now(void)
+{
+    return __rdtsc();
+}
+#else
+#include <time.h>
+#define HOSTPROF_UNIT "ns"
+static inline uint64_t hostprof_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+#endif
+
+extern hostprof_t hostprof_cur;
+extern uint64_t hostprof_mark;
+extern uint64_t hostprof_ticks[HOSTPROF_MAX];
+extern uint64_t hostprof_calls[HOSTPROF_MAX];
+
+static inline hostprof_t hostprof_enter(hostprof_t sub)
+{
+    uint64_t now = hostprof_now();
+    hostprof_t prev = hostprof_cur;
+    hostprof_ticks[prev] += now - hostprof_mark;
+    hostprof_mark = now;
+    hostprof_cur = sub;
+    hostprof_calls[sub]++;
+    return prev;
+}
+
+static inline void hostprof_leave(hostprof_t prev)
+{
+    uint64_t now = hostprof_now();
+    hostprof_ticks[hostprof_cur] += now - hostprof_mark;
+    hostprof_mark = now;
+    hostprof_cur = prev;
+}
+
+#define HOSTPROF(sub, stmt) do { hostprof_t hostprof_prev = hostprof_enter(sub); stmt; hostprof_leave(hostprof_prev); } while (0)
+
+#else
+
+static inline hostprof_t hostprof_enter(hostprof_t sub) { return sub; }
+static inline void hostprof_leave(hostprof_t prev) {}
+
+#define HOSTPROF(sub, stmt) stmt
+
+#endif
+
+void hostprof_reset(void);
+void hostprof_print(hostprof_outf_t outf);
+
+#endif
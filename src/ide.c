@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include "b-em.h"
 #include "ide.h"
+#include "hdimage.h"
 #include "led.h"
 
 bool ide_enable;
@@ -22,33 +23,29 @@ static struct
 static uint16_t ide_buffer[256];
 static uint8_t *ide_bufferb;
 static uint8_t  ide_buffer2[256];
-static FILE *hdfile[2] = {NULL, NULL};
+static hdimage_t *hdfile[2] = {NULL, NULL};
 
 void ide_close()
 {
-        if (hdfile[0]) fclose(hdfile[0]);
-        if (hdfile[1]) fclose(hdfile[1]);
+        hdimage_close(hdfile[0]);
+        hdimage_close(hdfile[1]);
+        hdfile[0] = hdfile[1] = NULL;
 }
 
 static void ide_open_hd(int i, const char *name) {
-    FILE *f;
     ALLEGRO_PATH *path;
     const char *cpath;
 
     if (!hdfile[i]) {
         if ((path = find_cfg_file(name, ".hdf"))) {
             cpath = al_path_cstr(path, ALLEGRO_NATIVE_PATH_SEP);
-            if ((f = fopen(cpath, "rb+")))
-                hdfile[i] = f;
-            else
-                log_error("ide: unable to open hard disk file %s: %s", cpath, strerror(errno));
+            if (!(hdfile[i] = hdimage_open(cpath, false)))
+                log_error("ide: unable to open hard disk file %s", cpath);
             al_destroy_path(path);
         } else if ((path = find_cfg_dest(name, ".hdf"))) {
             cpath = al_path_cstr(path, ALLEGRO_NATIVE_PATH_SEP);
-            if ((f = fopen(cpath, "wb+")))
-                hdfile[i] = f;
-            else
-                log_error("ide: unable to open hard disk file %s: %s", cpath, strerror(errno));
+            if (!(hdfile[i] = hdimage_open(cpath, true)))
+                log_error("ide: unable to open hard disk file %s", cpath);
             al_destroy_path(path);
         }
     }
@@ -246,9 +243,8 @@ void ide_callback()
             case 0x20: /*Read sectors*/
                 addr = ((((ide.cylinder * ide.hpc) + ide.head) * ide.spt) + (ide.sector)) * 256;
                 log_debug("ide: read sector, cylinder=%u, hpc=%u, head=%u, spt=%u, sector=%u, addr=%u", ide.cylinder, ide.hpc, ide.head, ide.spt, ide.sector, addr);
-                fseek(hdfile[ide.drive], addr, SEEK_SET);
                 memset(ide_buffer, 0, 512);
-                if (fread(ide_buffer2, 256, 1, hdfile[ide.drive]) != 1 && ferror(hdfile[ide.drive])) {
+                if (!hdfile[ide.drive] || !hdimage_read(hdfile[ide.drive], addr, ide_buffer2, 256)) {
                     ide.error = 0x40;
                     ide.atastat = 0x51;
                 }
@@ -262,9 +258,9 @@ void ide_callback()
             case 0x30: /*Write sector*/
                 addr = ((((ide.cylinder * ide.hpc) + ide.head) * ide.spt) + (ide.sector)) * 256;
                 log_debug("ide: write sector, cylinder=%u, hpc=%u, head=%u, spt=%u, sector=%u, addr=%u", ide.cylinder, ide.hpc, ide.head, ide.spt, ide.sector, addr);
-                fseek(hdfile[ide.drive], addr, SEEK_SET);
                 for (c = 0; c < 256; c++) ide_buffer2[c] = ide_bufferb[c << 1];
-                fwrite(ide_buffer2, 256, 1, hdfile[ide.drive]);
+                if (hdfile[ide.drive])
+                        hdimage_write(hdfile[ide.drive], addr, ide_buffer2, 256);
                 ide.secount--;
                 if (ide.secount)
                 {
@@ -291,11 +287,10 @@ void ide_callback()
                 return;
             case 0x50: /*Format track*/
                 addr = (((ide.cylinder * ide.hpc) + ide.head) * ide.spt) * 256;
-                fseek(hdfile[ide.drive], addr, SEEK_SET);
                 memset(ide_bufferb, 0, 512);
-                for (c = 0; c < ide.secount; c++)
+                for (c = 0; c < ide.secount && hdfile[ide.drive]; c++)
                 {
-                        fwrite(ide_buffer, 256, 1, hdfile[ide.drive]);
+                        hdimage_write(hdfile[ide.drive], addr + c * 256, ide_buffer, 256);
                 }
                 ide.atastat = 0x40;
                 return;
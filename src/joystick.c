@@ -9,6 +9,7 @@
 #include "joystick.h"
 #include "keyboard.h"
 #include "keydef-allegro.h"
+#include "movie.h"
 #include <ctype.h>
 
 typedef struct {
@@ -374,21 +375,13 @@ void joystick_axis(ALLEGRO_EVENT *event)
                     else if (value > 1.0)
                         value = 1.0;
                     if (axis->js_adc_chan)
-                        joyaxes[axis->js_adc_chan-1] = value;
+                        movie_joy_axis(axis->js_adc_chan-1, value);
                     else
                         log_debug("joystick: unmapped axis %d", event->joystick.axis);
-                    if (axis->js_nkey) {
-                        if (value < -0.5)
-                            key_down(axis->js_nkey);
-                        else
-                            key_up(axis->js_nkey);
-                    }
-                    if (axis->js_pkey) {
-                        if (value > 0.5)
-                            key_down(axis->js_pkey);
-                        else
-                            key_up(axis->js_pkey);
-                    }
+                    if (axis->js_nkey)
+                        movie_bbc_key(axis->js_nkey, value < -0.5);
+                    if (axis->js_pkey)
+                        movie_bbc_key(axis->js_pkey, value > 0.5);
                 }
                 else
                     log_debug("joystick: axis num %d out of range", event->joystick.axis);
@@ -400,7 +393,7 @@ void joystick_axis(ALLEGRO_EVENT *event)
     }
 }
 
-static void joystick_button(ALLEGRO_EVENT *event, bool value, void (*key_func)(uint8_t bbckey))
+static void joystick_button(ALLEGRO_EVENT *event, bool value)
 {
     joystick_map_t *js;
     js_btn_map_t *btn;
@@ -412,9 +405,9 @@ static void joystick_button(ALLEGRO_EVENT *event, bool value, void (*key_func)(u
                 if (event->joystick.button < js->num_butn) {
                     btn += event->joystick.button;
                     if (btn->js_button)
-                        joybutton[btn->js_button-1] = value;
+                        movie_joy_button(btn->js_button-1, value);
                     if (btn->js_key)
-                        key_func(btn->js_key);
+                        movie_bbc_key(btn->js_key, value);
                 }
             }
         }
@@ -423,10 +416,10 @@ static void joystick_button(ALLEGRO_EVENT *event, bool value, void (*key_func)(u
 
 void joystick_button_down(ALLEGRO_EVENT *event)
 {
-    joystick_button(event, true, key_down);
+    joystick_button(event, true);
 }
 
 void joystick_button_up(ALLEGRO_EVENT *event)
 {
-    joystick_button(event, false, key_up);
+    joystick_button(event, false);
 }
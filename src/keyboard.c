@@ -4,6 +4,7 @@
 #include "sysvia.h"
 #include "keyboard.h"
 #include "model.h"
+#include "movie.h"
 #include "6502.h"
 #include "fullscreen.h"
 #include <ctype.h>
@@ -1088,6 +1089,16 @@ void key_down_event(const ALLEGRO_EVENT *event)
     }
 }
 
+/*
+ * When replaying a movie only Break acts on the emulated machine, the
+ * other actions are for the host and may not make sense headless.
+ */
+
+static bool key_action_live(int act)
+{
+    return movie_mode != MOVIE_REPLAY || keyact_const[act].downfunc == main_key_break;
+}
+
 static int map_keypad_intern(int keycode, int unichar)
 {
     if (keypad || key_mode != BKM_PHYSICAL) {
@@ -1125,7 +1136,8 @@ void key_char_event(const ALLEGRO_EVENT *event)
         for (int act = 0; act < KEY_ACTION_MAX; act++) {
             log_debug("keyboard: checking key action %d:%s codes %d<>%d, alt %d<>%d", act, keyact_const[act].name, keycode, keyactions[act].keycode, hostalt, keyactions[act].altstate);
             if (keycode == keyactions[act].keycode && keyactions[act].altstate == hostalt) {
-                keyact_const[act].downfunc();
+                if (key_action_live(act))
+                    keyact_const[act].downfunc();
                 return;
             }
         }
@@ -1175,7 +1187,8 @@ void key_up_event(const ALLEGRO_EVENT *event)
             for (int act = 0; act < KEY_ACTION_MAX; act++) {
                 log_debug("keyboard: checking key action %d:%s codes %d<>%d, alt %d<>%d", act, keyact_const[act].name, keycode, keyactions[act].keycode, hostalt, keyactions[act].altstate);
                 if (keycode == keyactions[act].keycode && keyactions[act].altstate == hostalt) {
-                    keyact_const[act].upfunc();
+                    if (key_action_live(act))
+                        keyact_const[act].upfunc();
                     return;
                 }
             }
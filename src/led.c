@@ -16,6 +16,7 @@ ALLEGRO_BITMAP *led_bitmap;
 
 static ALLEGRO_FONT *font;
 static ALLEGRO_COLOR black;
+static uint32_t led_drawn;
 
 typedef struct {
     const char *label;
@@ -118,7 +119,6 @@ void led_update(led_name_t led_name, bool b, int ticks)
 {
     if (vid_ledlocation > LED_LOC_NONE && led_name < LED_MAX) {
         if (b != led_details[led_name].state) {
-            draw_led(&led_details[led_name], b);
             last_led_update_at = framesrun;
             led_details[led_name].state = b;
         }
@@ -139,11 +139,6 @@ void led_timer_fired(void)
             if (led_details[i].turn_off_at != 0) {
                 if (framesrun >= led_details[i].turn_off_at) {
                     led_update(i, false, 0);
-                    if (led_details[i].state != false) {
-                        last_led_update_at = framesrun;
-                        led_details[i].state = false;
-                        draw_led(&led_details[i], false);
-                    }
                     led_details[i].turn_off_at = 0;
                 }
                 else {
@@ -164,3 +159,27 @@ bool led_any_transient_led_on(void)
             return true;
     return false;
 }
+
+/*
+ * The LEDs are changed by the emulation but drawn by the render thread,
+ * which is the only one that may draw into led_bitmap once it starts,
+ * so each frame carries the state as a mask of LEDs lit.
+ */
+
+uint32_t led_state(void)
+{
+    uint32_t mask = 0;
+    for (int i = 0; i < sizeof(led_details)/sizeof(led_details[0]); i++)
+        if (led_details[i].state)
+            mask |= 1 << i;
+    return mask;
+}
+
+void led_render(uint32_t mask)
+{
+    uint32_t changed = mask ^ led_drawn;
+    for (int i = 0; changed; i++, changed >>= 1)
+        if (changed & 1)
+            draw_led(&led_details[i], mask & (1 << i));
+    led_drawn = mask;
+}
@@ -40,5 +40,7 @@ void led_close(void);
 void led_update(led_name_t led_name, bool b, int ticks);
 void led_timer_fired(void);
 bool led_any_transient_led_on(void);
+uint32_t led_state(void);
+void led_render(uint32_t mask);
 
 #endif
@@ -3,6 +3,7 @@
 
 #include "b-em.h"
 #include "config.h"
+#include "main.h"
 
 #include <allegro5/allegro_native_dialog.h>
 #include <errno.h>
@@ -314,7 +315,7 @@ void log_open(const char *log_fn)
         }
         if (contains(to_stderr, ll->name))
             new_opt |= (LOG_DEST_STDERR << ll->shift);
-        if (contains(to_msgbox, ll->name))
+        if (contains(to_msgbox, ll->name) && !headless)
             new_opt |= (LOG_DEST_MSGBOX << ll->shift);
     }
     log_options = new_opt;
@@ -11,14 +11,15 @@
 
 #include "6502.h"
 #include "adc.h"
+#include "bench.h"
 #include "model.h"
 #include "cmos.h"
 #include "config.h"
-#include "csw.h"
 #include "ddnoise.h"
 #include "debugger.h"
 #include "disc.h"
 #include "fdi.h"
+#include "hdimage.h"
 #include "hfe.h"
 #include "gui-allegro.h"
 #include "i8271.h"
@@ -32,12 +33,14 @@
 #include "mem.h"
 #include "mmb.h"
 #include "mouse.h"
+#include "movie.h"
 #include "midi.h"
 #include "music4000.h"
 #include "music5000.h"
 #include "mmccard.h"
 #include "paula.h"
 #include "pal.h"
+#include "rewind.h"
 #include "savestate.h"
 #include "scsi.h"
 #include "sdf.h"
@@ -51,7 +54,6 @@
 #include "tube.h"
 #include "via.h"
 #include "sysvia.h"
-#include "uef.h"
 #include "uservia.h"
 #include "vdfs.h"
 #include "video.h"
@@ -84,6 +86,8 @@ int joybutton[4];
 float joyaxes[4];
 int emuspeed = 4;
 bool tricky_sega_adapter = false;
+bool headless = false;
+static bool bench = false;
 /* TOHv3: although C exit code is an int, Unix shells don't safely allow
    you to use values > 125, so this is limited to a signed 8-bit value >:( */
 int8_t shutdown_exit_code = SHUTDOWN_OK;
@@ -105,6 +109,7 @@ static double time_limit;
 static int fcount = 0;
 static fspeed_type_t fullspeed = FSPEED_NONE;
 static bool bempause  = false;
+static uint64_t expire_cycles = 0;
 
 #define NUM_DEFAULT_SPEEDS 10
 
@@ -142,6 +147,7 @@ void main_reset()
     music5000_reset();
     paula_reset();
     sn_init();
+    tube_thread_stop();  // the parasite must not be running while it is reset.
     if (curtube != -1) tubes[curtube].cpu->reset();
     else               tube_exec = NULL;
     tube_reset();
@@ -177,7 +183,13 @@ static const char helptext[] =
     "-printcmd c     - printer output via command as text\n"
     "-printcmdbin c  - printer output via command as binary\n"
     "-vroot host-dir - set the VDFS root\n"
-    "-vdir guest-dir - set the initial (boot) dir in VDFS\n\n";
+    "-hdoverlay dir  - write hard disc changes to overlay files in dir\n"
+    "-vdir guest-dir - set the initial (boot) dir in VDFS\n"
+    "-headless       - run without display or sound, as fast as possible\n"
+    "-expire cycles  - exit after the given number of emulated cycles\n"
+    "-record file    - record input to a movie file\n"
+    "-replay file    - replay a movie file, exiting at its end if headless\n"
+    "-bench          - run the throughput benchmark suite headless and exit\n\n";
 
 static double main_calc_timer(int speed)
 {
@@ -251,9 +263,13 @@ typedef enum {
     OPT_EXEC,
     OPT_VDFS_ROOT,
     OPT_VDFS_DIR,
+    OPT_HD_OVERLAY,
     OPT_PASTE_OS,
     OPT_PASTE_KBD,
     OPT_PRINT,
+    OPT_EXPIRE,
+    OPT_MOVIE_RECORD,
+    OPT_MOVIE_REPLAY,
     OPT_GROUND,
 } opt_state;
 
@@ -268,7 +284,7 @@ void main_init(int argc, char *argv[])
     ALLEGRO_PATH *snap_fn = NULL;
     ALLEGRO_PATH *cfg_fn = NULL;
     const char *ext, *exec_fn = NULL, *log_file = NULL;
-    const char *vroot = NULL, *vdir = NULL;
+    const char *vroot = NULL, *vdir = NULL, *hdoverlay = NULL;
 
     while (--argc) {
         char *arg = *++argv;
@@ -323,6 +339,8 @@ void main_init(int argc, char *argv[])
                         state = OPT_VDFS_ROOT;
                     else if (!strcasecmp(arg, "vdir"))
                         state = OPT_VDFS_DIR;
+                    else if (!strcasecmp(arg, "hdoverlay"))
+                        state = OPT_HD_OVERLAY;
                     else if (!strcasecmp(arg, "paste"))
                         state = OPT_PASTE_OS;
                     else if (!strcasecmp(arg, "pastek"))
@@ -349,6 +367,16 @@ void main_init(int argc, char *argv[])
                         hiresdisplay = true;
                     else if (!strcasecmp(arg, "lores"))
                         hiresdisplay = false;
+                    else if (!strcasecmp(arg, "headless"))
+                        headless = true;
+                    else if (!strcasecmp(arg, "bench"))
+                        headless = bench = true;
+                    else if (!strcasecmp(arg, "expire"))
+                        state = OPT_EXPIRE;
+                    else if (!strcasecmp(arg, "record"))
+                        state = OPT_MOVIE_RECORD;
+                    else if (!strcasecmp(arg, "replay"))
+                        state = OPT_MOVIE_REPLAY;
                     else {
                         if (*arg != 'h' && *arg != '?')
                             fprintf(stderr, "b-em: unrecognised option '-%s'\n", arg);
@@ -405,6 +433,9 @@ void main_init(int argc, char *argv[])
             case OPT_VDFS_DIR:
                 vdir = arg;
                 break;
+            case OPT_HD_OVERLAY:
+                hdoverlay = arg;
+                break;
             case OPT_PASTE_OS:
                 debug_paste(arg, os_paste_start);
                 break;
@@ -414,6 +445,15 @@ void main_init(int argc, char *argv[])
             case OPT_PRINT:
                 print_filename = arg;
                 print_filename_alloc = false;
+                break;
+            case OPT_EXPIRE:
+                expire_cycles = strtoull(arg, NULL, 0);
+                break;
+            case OPT_MOVIE_RECORD:
+                movie_record(arg);
+                break;
+            case OPT_MOVIE_REPLAY:
+                movie_replay(arg);
         }
         state = OPT_GROUND;
     }
@@ -422,15 +462,19 @@ void main_init(int argc, char *argv[])
         exit(1);
     }
 
-    al_init_native_dialog_addon();
-    al_set_new_window_title(VERSION_STR);
-    al_init_primitives_addon();
-    if (!al_install_keyboard()) {
-        log_fatal("main: unable to install keyboard");
-        exit(1);
+    if (!headless) {
+        al_init_native_dialog_addon();
+        al_set_new_window_title(VERSION_STR);
+        al_init_primitives_addon();
+        if (!al_install_keyboard()) {
+            log_fatal("main: unable to install keyboard");
+            exit(1);
+        }
     }
     key_init();
     config_load(cfg_fn);
+    if (hdoverlay)
+        hdimage_overlay_dir = hdoverlay;
     log_open(log_file);
     log_info("main: starting %s", VERSION_STR);
 
@@ -448,28 +492,33 @@ void main_init(int argc, char *argv[])
         log_fatal("main: unable to create event queue");
         exit(1);
     }
-    al_register_event_source(queue, al_get_display_event_source(display));
 
-    if (!al_install_audio()) {
-        log_fatal("main: unable to initialise audio");
-        exit(1);
-    }
-    if (!al_reserve_samples(3)) {
-        log_fatal("main: unable to reserve audio samples");
-        exit(1);
-    }
-    if (!al_init_acodec_addon()) {
-        log_fatal("main: unable to initialise audio codecs");
-        exit(1);
-    }
+    if (!headless) {
+        al_register_event_source(queue, al_get_display_event_source(display));
 
-    sound_init();
+        if (!al_install_audio()) {
+            log_fatal("main: unable to initialise audio");
+            exit(1);
+        }
+        if (!al_reserve_samples(3)) {
+            log_fatal("main: unable to reserve audio samples");
+            exit(1);
+        }
+        if (!al_init_acodec_addon()) {
+            log_fatal("main: unable to initialise audio codecs");
+            exit(1);
+        }
+        sound_init();
+    }
     sid_init();
     sid_settype(sidmethod, cursid);
-    music5000_init(emu_speed_normal);
+    if (!headless)
+        music5000_init(emu_speed_normal);
     paula_init();
-    ddnoise_init();
-    tapenoise_init(queue);
+    if (!headless) {
+        ddnoise_init();
+        tapenoise_init(queue);
+    }
 
     adc_init();
     pal_init();
@@ -486,11 +535,13 @@ void main_init(int argc, char *argv[])
     midi_init();
     main_reset();
 
-    joystick_init(queue);
-
     tmp_display = display;
 
-    gui_allegro_init(queue, display);
+    if (!headless) {
+        joystick_init(queue);
+        gui_allegro_init(queue, display);
+        video_render_start(display);
+    }
 
     if (!(timer = al_create_timer(main_calc_timer(emu_speed_normal)))) {
         log_fatal("main: unable to create timer");
@@ -500,12 +551,13 @@ void main_init(int argc, char *argv[])
     al_init_user_event_source(&evsrc);
     al_register_event_source(queue, &evsrc);
 
-    al_register_event_source(queue, al_get_keyboard_event_source());
-
     oldmodel = curmodel;
 
-    al_install_mouse();
-    al_register_event_source(queue, al_get_mouse_event_source());
+    if (!headless) {
+        al_register_event_source(queue, al_get_keyboard_event_source());
+        al_install_mouse();
+        al_register_event_source(queue, al_get_mouse_event_source());
+    }
 
     if (mmb_fn)
         mmb_load(mmb_fn);
@@ -521,10 +573,11 @@ void main_init(int argc, char *argv[])
         gui_set_disc_wprot(0, drives[0].writeprot);
     if (drives[1].discfn)
         gui_set_disc_wprot(1, drives[1].writeprot);
-    main_setspeed(emuspeed);
+    if (!headless)
+        main_setspeed(emuspeed);
     debug_start(exec_fn, true);
     // lovebug
-    if (fullscreen)
+    if (fullscreen && !headless)
         video_enterfullscreen();
     // lovebug end
 }
@@ -533,6 +586,8 @@ void main_restart()
 {
     main_pause("restarting");
     cmos_save(&models[oldmodel]);
+    rewind_clear();
+    movie_stop();
 
     model_init();
     main_reset();
@@ -601,6 +656,7 @@ void main_key_break(void)
     cmos_reset();
     paula_reset();
 
+    tube_thread_stop();
     if (curtube != -1)
         tubes[curtube].cpu->reset();
     tube_reset();
@@ -630,35 +686,66 @@ static double prev_time = 0;
 static int execs = 0;
 static int slow_count = 0;
 
+static void main_slice(void)
+{
+    movie_slice_start();
+    if (autoboot)
+        autoboot--;
+    if (x65c02)
+        m65c02_exec(slice);
+    else
+        m6502_exec(slice);
+    movie_slice_end(slice);
+
+    if (ddnoise_ticks > 0 && --ddnoise_ticks == 0)
+        ddnoise_headdown();
+
+    if (tapeledcount) {
+        if (--tapeledcount == 0 && !motor) {
+            log_debug("main: delayed cassette motor LED off");
+            led_update(LED_CASSETTE_MOTOR, 0, 0);
+        }
+    }
+
+    if (savestate_wantload) {
+        movie_stop();
+        savestate_doload();
+        rewind_clear();
+    }
+    if (savestate_wantsave)
+        savestate_dosave();
+    // Snapshots would be counted against the benchmark workloads.
+    if (!bench)
+        rewind_poll(slice);
+}
+
+/*
+ * The limit given with -expire counts the cycles run since start-up,
+ * whether headless or from the timer.
+ */
+
+static void main_expire(void)
+{
+    static uint64_t expire_count = 0;
+
+    expire_count += slice;
+    if (expire_cycles && expire_count >= expire_cycles) {
+        log_info("main: expired after %" PRIu64 " cycles", expire_count);
+        set_shutdown_exit_code(SHUTDOWN_EXPIRED);
+        set_quit();
+    }
+}
+
 static void main_timer(ALLEGRO_EVENT *event)
 {
     double now = al_get_time();
     double delay = now - event->any.timestamp;
 
     if (delay < time_limit && music5000_ok()) {
-        if (autoboot)
-            autoboot--;
-        if (x65c02)
-            m65c02_exec(slice);
-        else
-            m6502_exec(slice);
+        main_slice();
+        main_expire();
         execs++;
 
-        if (ddnoise_ticks > 0 && --ddnoise_ticks == 0)
-            ddnoise_headdown();
-
-        if (tapeledcount) {
-            if (--tapeledcount == 0 && !motor) {
-                log_debug("main: delayed cassette motor LED off");
-                led_update(LED_CASSETTE_MOTOR, 0, 0);
-            }
-        }
-
-        if (savestate_wantload)
-            savestate_doload();
-        if (savestate_wantsave)
-            savestate_dosave();
-
         if (now - prev_time > 0.1) {
             double speed = execs * slice / (now - prev_time);
 
@@ -701,12 +788,61 @@ static void main_timer(ALLEGRO_EVENT *event)
     }
 }
 
+/*
+ * Run the emulated machine for at least the given number of cycles, or
+ * until something asks to quit, returning the number actually run.
+ */
+
+uint64_t main_run_cycles(uint64_t cycles)
+{
+    uint64_t total = 0;
+    while (total < cycles && !quitting) {
+        main_slice();
+        total += slice;
+    }
+    return total;
+}
+
+/*
+ * In headless mode there is no display, keyboard or sound to service
+ * so, rather than waiting for timer events, the CPU is run slice after
+ * slice as fast as the host allows until something asks to quit, for
+ * example a shutdown breakpoint, *QUIT from VDFS or the cycle limit
+ * given with -expire.
+ */
+
+static void main_run_headless(void)
+{
+    uint64_t total_cycles = 0;
+    double start = al_get_time();
+
+    log_debug("main: entering headless loop");
+    while (!quitting) {
+        main_slice();
+        total_cycles += slice;
+        main_expire();
+    }
+    double secs = al_get_time() - start;
+    if (secs > 0)
+        log_info("main: ran %" PRIu64 " cycles in %.3fs, %.3fMHz", total_cycles, secs, total_cycles / secs / 1000000);
+    log_debug("main: end headless loop");
+}
+
 static double last_switch_in = 0.0;
 
 void main_run()
 {
     ALLEGRO_EVENT event;
 
+    if (bench) {
+        bench_run();
+        return;
+    }
+    if (headless) {
+        main_run_headless();
+        return;
+    }
+
     log_debug("main: about to start timer");
     al_start_timer(timer);
 
@@ -716,15 +852,15 @@ void main_run()
         switch(event.type) {
             case ALLEGRO_EVENT_KEY_DOWN:
                 if (!keydefining)
-                    key_down_event(&event);
+                    movie_key_event(&event);
                 break;
             case ALLEGRO_EVENT_KEY_CHAR:
                 if (!keydefining)
-                    key_char_event(&event);
+                    movie_key_event(&event);
                 break;
             case ALLEGRO_EVENT_KEY_UP:
                 if (!keydefining)
-                    key_up_event(&event);
+                    movie_key_event(&event);
                 break;
             case ALLEGRO_EVENT_MOUSE_AXES:
                 mouse_axes(&event);
@@ -795,14 +931,16 @@ void main_close()
     gui_keydefine_close();
 
     debug_kill();
+    movie_stop();
+    tube_thread_stop();
 
-    config_save();
+    if (!headless)
+        config_save();
     cmos_save(&models[curmodel]);
 
     midi_close();
     mem_close();
-    uef_close();
-    csw_close();
+    tape_close();
     tube_6502_close();
     arm_close();
     x86_close();
@@ -822,7 +960,9 @@ void main_close()
     tape_free();
     al_destroy_timer(timer);
     al_destroy_event_queue(queue);
+    video_render_stop();
     led_close();
+    pal_close();
     video_close();
     model_close();
     log_close();
@@ -853,12 +993,15 @@ void main_pause(const char *why)
 {
     char buf[120];
     snprintf(buf, sizeof(buf), "%s (%s)", VERSION_STR, why);
-    al_set_window_title(tmp_display, buf);
+    if (tmp_display)
+        al_set_window_title(tmp_display, buf);
     al_stop_timer(timer);
 }
 
 void main_resume(void)
 {
+    if (headless)
+        return;
     if (emuspeed != EMU_SPEED_PAUSED && emuspeed != EMU_SPEED_FULL)
         al_start_timer(timer);
 }
@@ -41,6 +41,7 @@ extern bool keydefining;
 extern bool autopause;
 extern bool autoskip;
 extern bool skipover;
+extern bool headless;
 extern unsigned hiresdisplay;
 
 /* TOHv3: although C exit code is an int, Unix shells don't safely allow
@@ -51,6 +52,7 @@ void main_softreset(void);
 void main_reset(void);
 void main_restart(void);
 void main_run(void);
+uint64_t main_run_cycles(uint64_t cycles);
 void main_close(void);
 void main_pause(const char *why);
 void main_resume(void);
@@ -6,16 +6,55 @@
 #include "mc68000tube.h"
 #include "musahi/m68k.h"
 
+/*
+ * The address space is divided into 32K pages, the size of the ROM,
+ * and for each page the tables give a pointer to the host memory
+ * behind it if the page is all RAM or all ROM so an access there is
+ * made straight from that memory.  NULL means the page holds I/O,
+ * wraps round the end of RAM or, for reads, may page out the boot ROM
+ * and any access there goes through readmem or writemem.
+ */
+
+#define MC68000_PAGE_SHIFT 15
+#define MC68000_PAGE_SIZE  (1 << MC68000_PAGE_SHIFT)
+#define MC68000_PAGE_MASK  (MC68000_PAGE_SIZE - 1)
+#define MC68000_PAGES      (1 << (32 - MC68000_PAGE_SHIFT))
+
 static uint_least32_t mc68000_ram_size;
 static uint8_t *mc68000_ram, *mc68000_rom;
+static uint8_t **mc68000_read_map, **mc68000_write_map;
 static bool mc68000_debug_enabled = false;
 static bool rom_low;
 
+static void mc68000_map(void)
+{
+    for (uint32_t page = 0; page < MC68000_PAGES; page++) {
+        uint32_t addr = page << MC68000_PAGE_SHIFT;
+        uint32_t top = addr & 0xFFFF0000;
+        uint8_t *host = NULL;
+        if (top != 0xFFFF0000 && top != 0xFFFE0000) {
+            uint32_t offset = addr % mc68000_ram_size;
+            if (offset + MC68000_PAGE_SIZE <= mc68000_ram_size)
+                host = mc68000_ram + offset;
+        }
+        mc68000_write_map[page] = host;
+        if (rom_low && (addr & 0x40000))
+            mc68000_read_map[page] = NULL;  // includes the high ROM.
+        else if (rom_low && addr < MC68000_ROM_SIZE)
+            mc68000_read_map[page] = mc68000_rom;
+        else if (top == 0xFFFF0000)
+            mc68000_read_map[page] = mc68000_rom;
+        else
+            mc68000_read_map[page] = host;
+    }
+}
+
 static uint8_t readmem(uint32_t addr)
 {
     if (rom_low) {
         if (addr & 0x40000) {
             rom_low = false;
+            mc68000_map();
             log_debug("mc68000: readmem paging out ROM");
         }
         else if (addr < MC68000_ROM_SIZE) {
@@ -38,16 +77,46 @@ static uint8_t readmem(uint32_t addr)
     else
     {
         uint8_t data = mc68000_ram[addr % mc68000_ram_size];
-        log_debug("mc68000: read %08X as RAM -> %02X", addr, data);
+        //log_debug("mc68000: read %08X as RAM -> %02X", addr, data);
         return data;
     }
     log_debug("mc68000: read %08X unmapped", addr);
     return 0xff;
 }
 
+static inline uint32_t read8(uint32_t addr)
+{
+    uint8_t *host = mc68000_read_map[addr >> MC68000_PAGE_SHIFT];
+    if (host)
+        return host[addr & MC68000_PAGE_MASK];
+    return readmem(addr);
+}
+
+static inline uint32_t read16(uint32_t addr)
+{
+    uint8_t *host = mc68000_read_map[addr >> MC68000_PAGE_SHIFT];
+    uint32_t offset = addr & MC68000_PAGE_MASK;
+    if (host && offset <= MC68000_PAGE_SIZE - 2) {
+        host += offset;
+        return (host[0] << 8) | host[1];
+    }
+    return (readmem(addr) << 8) | readmem(addr+1);
+}
+
+static inline uint32_t read32(uint32_t addr)
+{
+    uint8_t *host = mc68000_read_map[addr >> MC68000_PAGE_SHIFT];
+    uint32_t offset = addr & MC68000_PAGE_MASK;
+    if (host && offset <= MC68000_PAGE_SIZE - 4) {
+        host += offset;
+        return ((uint32_t)host[0] << 24) | (host[1] << 16) | (host[2] << 8) | host[3];
+    }
+    return (readmem(addr) << 24) | (readmem(addr+1) << 16) | (readmem(addr+2) << 8) | readmem(addr+3);
+}
+
 unsigned int m68k_read_memory_8(unsigned int address)
 {
-    uint32_t data = readmem(address);
+    uint32_t data = read8(address);
     if (mc68000_debug_enabled)
         debug_memread(&mc68000_cpu_debug, address, data, 1);
     return data;
@@ -55,12 +124,12 @@ unsigned int m68k_read_memory_8(unsigned int address)
 
 unsigned int m68k_read_disassembler_8(unsigned int address)
 {
-    return readmem(address);
+    return read8(address);
 }
 
 unsigned int m68k_read_memory_16(unsigned int address)
 {
-    uint32_t data = (readmem(address) << 8) | readmem(address+1);
+    uint32_t data = read16(address);
     if (mc68000_debug_enabled)
         debug_memread(&mc68000_cpu_debug, address, data, 2);
     return data;
@@ -68,12 +137,12 @@ unsigned int m68k_read_memory_16(unsigned int address)
 
 unsigned int m68k_read_disassembler_16(unsigned int address)
 {
-    return (readmem(address) << 8) | readmem(address+1);
+    return read16(address);
 }
 
 unsigned int  m68k_read_memory_32(unsigned int address)
 {
-    uint32_t data = (readmem(address) << 24) | (readmem(address+1) << 16) | (readmem(address+2) << 8) | readmem(address+3);
+    uint32_t data = read32(address);
     if (mc68000_debug_enabled)
         debug_memread(&mc68000_cpu_debug, address, data, 4);
     return data;
@@ -81,7 +150,7 @@ unsigned int  m68k_read_memory_32(unsigned int address)
 
 unsigned int m68k_read_disassembler_32 (unsigned int address)
 {
-    return (readmem(address) << 24) | (readmem(address+1) << 16) | (readmem(address+2) << 8) | readmem(address+3);
+    return read32(address);
 }
 
 static void writemem(uint32_t addr, uint8_t data)
@@ -97,7 +166,7 @@ static void writemem(uint32_t addr, uint8_t data)
   }
   else
   {
-    log_debug("mc68000: write %08X as RAM <- %02X", addr, data);
+    //log_debug("mc68000: write %08X as RAM <- %02X", addr, data);
     mc68000_ram[addr % mc68000_ram_size] = data;
   }
 }
@@ -106,25 +175,49 @@ void m68k_write_memory_8(unsigned int address, unsigned int value)
 {
     if (mc68000_debug_enabled)
         debug_memwrite(&mc68000_cpu_debug, address, value, 1);
-    writemem(address, value);
+    uint8_t *host = mc68000_write_map[address >> MC68000_PAGE_SHIFT];
+    if (host)
+        host[address & MC68000_PAGE_MASK] = value;
+    else
+        writemem(address, value);
 }
 
 void m68k_write_memory_16(unsigned int address, unsigned int value)
 {
     if (mc68000_debug_enabled)
         debug_memwrite(&mc68000_cpu_debug, address, value, 2);
-    writemem(address, value >> 8);
-    writemem(address+1, value);
+    uint8_t *host = mc68000_write_map[address >> MC68000_PAGE_SHIFT];
+    uint32_t offset = address & MC68000_PAGE_MASK;
+    if (host && offset <= MC68000_PAGE_SIZE - 2) {
+        host += offset;
+        host[0] = value >> 8;
+        host[1] = value;
+    }
+    else {
+        writemem(address, value >> 8);
+        writemem(address+1, value);
+    }
 }
 
 void m68k_write_memory_32(unsigned int address, unsigned int value)
 {
     if (mc68000_debug_enabled)
         debug_memwrite(&mc68000_cpu_debug, address, value, 4);
-    writemem(address, value >> 24);
-    writemem(address+1, value >> 16);
-    writemem(address+2, value >> 8);
-    writemem(address+3, value);
+    uint8_t *host = mc68000_write_map[address >> MC68000_PAGE_SHIFT];
+    uint32_t offset = address & MC68000_PAGE_MASK;
+    if (host && offset <= MC68000_PAGE_SIZE - 4) {
+        host += offset;
+        host[0] = value >> 24;
+        host[1] = value >> 16;
+        host[2] = value >> 8;
+        host[3] = value;
+    }
+    else {
+        writemem(address, value >> 24);
+        writemem(address+1, value >> 16);
+        writemem(address+2, value >> 8);
+        writemem(address+3, value);
+    }
 }
 
 static void mc6809nc_exec(void)
@@ -136,6 +229,7 @@ static void mc6809nc_exec(void)
 void tube_68000_rst(void)
 {
     rom_low = true;
+    mc68000_map();
     m68k_pulse_reset();
 }
 
@@ -180,6 +274,17 @@ bool tube_68000_init(void *rom)
             log_error("mc68000: unable to allocate RAM: %s", strerror(errno));
             return false;
         }
+        mc68000_read_map = malloc(MC68000_PAGES * sizeof(uint8_t *));
+        mc68000_write_map = malloc(MC68000_PAGES * sizeof(uint8_t *));
+        if (!mc68000_read_map || !mc68000_write_map) {
+            log_error("mc68000: unable to allocate memory map: %s", strerror(errno));
+            free(mc68000_read_map);
+            free(mc68000_write_map);
+            free(mc68000_ram);
+            mc68000_read_map = mc68000_write_map = NULL;
+            mc68000_ram = NULL;
+            return false;
+        }
         m68k_init();
         m68k_set_cpu_type(M68K_CPU_TYPE_68020);
     }
@@ -191,6 +296,7 @@ bool tube_68000_init(void *rom)
     tube_proc_savestate = mc68000_savestate;
     tube_proc_loadstate = mc68000_loadstate;
     rom_low = true;
+    mc68000_map();
     m68k_pulse_reset();
     return true;
 }
@@ -8,6 +8,7 @@
 #include "6809tube.h"
 #include "mc6809nc/mc6809_debug.h"
 #include "mem.h"
+#include "6502.h"
 #include "tube.h"
 #include "NS32016/32016.h"
 #include "6502tube.h"
@@ -278,6 +279,7 @@ static void *tuberom = NULL;
 
 static void tube_init(void)
 {
+    tube_thread_stop();
     if (curtube!=-1) {
         TUBE_MODEL *tube = &tubes[curtube];
         if (!(tube->bootrom && tube->bootrom[0])) { // no boot ROM needed
@@ -371,6 +373,7 @@ void model_init()
 
     mem_clearroms();
     models[curmodel].romsetup->func();
+    m6502_io_setup();
     tube_init();
     cmos_load(&models[curmodel]);
 }
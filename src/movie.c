@@ -0,0 +1,540 @@
+/*B-em movies
+  Recording and replay of the input to the emulated machine.
+
+  A movie file starts with a full savestate followed by a stream of
+  input events, each stamped with the number of 6502 cycles run since
+  that state was taken.  Events are only ever applied to the machine
+  between slices so, given the same start state, disc images and ROMs,
+  replaying a movie drives the emulated machine through exactly the
+  same sequence as when it was recorded.  Input that arrives while the
+  machine is in the middle of a slice, for example pasted from the
+  debugger, is held back to the end of that slice.*/
+
+#include <errno.h>
+#include "b-em.h"
+#include "6502.h"
+#include "keyboard.h"
+#include "main.h"
+#include "model.h"
+#include "music5000.h"
+#include "movie.h"
+#include "rewind.h"
+#include "savestate.h"
+#include "sound.h"
+#include "tube.h"
+
+#define MOVIE_MAGIC   "BEMMOVIE"
+#define MOVIE_VERSION '1'
+
+enum {
+    MOVIE_EV_END,
+    MOVIE_EV_KEY_DOWN,
+    MOVIE_EV_KEY_CHAR,
+    MOVIE_EV_KEY_UP,
+    MOVIE_EV_BBC_DOWN,
+    MOVIE_EV_BBC_UP,
+    MOVIE_EV_JOY_AXIS,
+    MOVIE_EV_JOY_BUTTON,
+    MOVIE_EV_PASTE_KBD,
+    MOVIE_EV_PASTE_OS
+};
+
+typedef struct {
+    uint64_t stamp;
+    int type;
+    int code;       // keycode, BBC key, joystick channel or button.
+    int unichar;    // key char events only.
+    int modifiers;  // key events; also repeat flag and button value.
+    float value;    // joystick axis position.
+    char *str;      // paste text, allocated with al_malloc.
+} movie_event_t;
+
+movie_mode_t movie_mode = MOVIE_OFF;
+
+static movie_mode_t movie_want;
+static char *movie_want_name;
+static char *movie_name;
+static FILE *movie_fp;
+static uint64_t movie_cycles;   // cycles run since the start state.
+static uint64_t movie_last;     // stamp of the last event in the file.
+static bool movie_in_slice;
+static movie_event_t movie_next;
+static bool movie_have_next;
+static movie_event_t *movie_defer;
+static size_t movie_defer_count, movie_defer_alloc;
+
+static void movie_put_var(uint64_t value)
+{
+    while (value >= 0x80) {
+        putc((value & 0x7f) | 0x80, movie_fp);
+        value >>= 7;
+    }
+    putc(value, movie_fp);
+}
+
+static bool movie_get_var(uint64_t *value)
+{
+    uint64_t result = 0;
+    int shift = 0, ch;
+
+    do {
+        if ((ch = getc(movie_fp)) == EOF || shift > 63)
+            return false;
+        result |= (uint64_t)(ch & 0x7f) << shift;
+        shift += 7;
+    } while (ch & 0x80);
+    *value = result;
+    return true;
+}
+
+static void movie_write(const movie_event_t *ev)
+{
+    putc(ev->type, movie_fp);
+    movie_put_var(ev->stamp - movie_last);
+    movie_last = ev->stamp;
+    switch(ev->type) {
+        case MOVIE_EV_KEY_DOWN:
+        case MOVIE_EV_KEY_UP:
+            movie_put_var(ev->code);
+            movie_put_var(ev->modifiers);
+            break;
+        case MOVIE_EV_KEY_CHAR:
+            movie_put_var(ev->code);
+            movie_put_var((uint32_t)ev->unichar);
+            putc(ev->modifiers, movie_fp);
+            break;
+        case MOVIE_EV_BBC_DOWN:
+        case MOVIE_EV_BBC_UP:
+            putc(ev->code, movie_fp);
+            break;
+        case MOVIE_EV_JOY_AXIS: {
+            uint32_t bits;
+            memcpy(&bits, &ev->value, sizeof(bits));
+            putc(ev->code, movie_fp);
+            for (int i = 0; i < 4; i++, bits >>= 8)
+                putc(bits & 0xff, movie_fp);
+            break;
+        }
+        case MOVIE_EV_JOY_BUTTON:
+            putc(ev->code, movie_fp);
+            putc(ev->modifiers, movie_fp);
+            break;
+        case MOVIE_EV_PASTE_KBD:
+        case MOVIE_EV_PASTE_OS: {
+            size_t len = strlen(ev->str);
+            movie_put_var(len);
+            fwrite(ev->str, len, 1, movie_fp);
+        }
+    }
+}
+
+static bool movie_read(movie_event_t *ev)
+{
+    uint64_t delta, code, mods;
+    int type = getc(movie_fp);
+
+    if (type == EOF || !movie_get_var(&delta))
+        return false;
+    memset(ev, 0, sizeof(*ev));
+    ev->type = type;
+    ev->stamp = movie_last += delta;
+    switch(type) {
+        case MOVIE_EV_END:
+            return true;
+        case MOVIE_EV_KEY_DOWN:
+        case MOVIE_EV_KEY_UP:
+            if (!movie_get_var(&code) || !movie_get_var(&mods) || code >= ALLEGRO_KEY_MAX)
+                return false;
+            ev->code = code;
+            ev->modifiers = mods;
+            return true;
+        case MOVIE_EV_KEY_CHAR:
+            if (!movie_get_var(&code) || !movie_get_var(&mods) || code >= ALLEGRO_KEY_MAX)
+                return false;
+            ev->code = code;
+            ev->unichar = (int32_t)(uint32_t)mods;
+            return (ev->modifiers = getc(movie_fp)) != EOF;
+        case MOVIE_EV_BBC_DOWN:
+        case MOVIE_EV_BBC_UP:
+            return (ev->code = getc(movie_fp)) != EOF;
+        case MOVIE_EV_JOY_AXIS: {
+            unsigned char bytes[4];
+            if ((unsigned)(ev->code = getc(movie_fp)) >= 4 || fread(bytes, sizeof(bytes), 1, movie_fp) != 1)
+                return false;
+            uint32_t bits = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+            memcpy(&ev->value, &bits, sizeof(bits));
+            return true;
+        }
+        case MOVIE_EV_JOY_BUTTON:
+            if ((unsigned)(ev->code = getc(movie_fp)) >= 4)
+                return false;
+            return (ev->modifiers = getc(movie_fp)) != EOF;
+        case MOVIE_EV_PASTE_KBD:
+        case MOVIE_EV_PASTE_OS:
+            if (!movie_get_var(&code) || code > 0x1000000 || !(ev->str = al_malloc(code + 1)))
+                return false;
+            if (code && fread(ev->str, code, 1, movie_fp) != 1) {
+                al_free(ev->str);
+                ev->str = NULL;
+                return false;
+            }
+            ev->str[code] = 0;
+            return true;
+    }
+    log_error("movie: unknown event type %d in %s", type, movie_name);
+    return false;
+}
+
+static void movie_apply(movie_event_t *ev)
+{
+    ALLEGRO_EVENT event;
+
+    switch(ev->type) {
+        case MOVIE_EV_KEY_DOWN:
+        case MOVIE_EV_KEY_CHAR:
+        case MOVIE_EV_KEY_UP:
+            memset(&event, 0, sizeof(event));
+            event.keyboard.keycode = ev->code;
+            event.keyboard.modifiers = ev->modifiers;
+            if (ev->type == MOVIE_EV_KEY_DOWN) {
+                event.type = ALLEGRO_EVENT_KEY_DOWN;
+                key_down_event(&event);
+            }
+            else if (ev->type == MOVIE_EV_KEY_UP) {
+                event.type = ALLEGRO_EVENT_KEY_UP;
+                key_up_event(&event);
+            }
+            else {
+                event.type = ALLEGRO_EVENT_KEY_CHAR;
+                event.keyboard.unichar = ev->unichar;
+                event.keyboard.modifiers = 0;
+                event.keyboard.repeat = ev->modifiers;
+                key_char_event(&event);
+            }
+            break;
+        case MOVIE_EV_BBC_DOWN:
+            key_down(ev->code);
+            break;
+        case MOVIE_EV_BBC_UP:
+            key_up(ev->code);
+            break;
+        case MOVIE_EV_JOY_AXIS:
+            joyaxes[ev->code] = ev->value;
+            break;
+        case MOVIE_EV_JOY_BUTTON:
+            joybutton[ev->code] = ev->modifiers;
+            break;
+        case MOVIE_EV_PASTE_KBD:
+            key_paste_start(ev->str);
+            ev->str = NULL;
+            break;
+        case MOVIE_EV_PASTE_OS:
+            os_paste_start(ev->str);
+            ev->str = NULL;
+    }
+}
+
+/*
+ * All input for the emulated machine comes through here.  When not
+ * recording or replaying it is applied straight away.  When recording
+ * it is written to the movie first, or held back if a slice is part
+ * way through, and while replaying live input is ignored so it can't
+ * make the replay diverge.
+ */
+
+static void movie_input(movie_event_t *ev)
+{
+    switch(movie_mode) {
+        case MOVIE_OFF:
+            movie_apply(ev);
+            break;
+        case MOVIE_RECORD:
+            if (movie_in_slice) {
+                if (movie_defer_count >= movie_defer_alloc) {
+                    size_t new_alloc = movie_defer_alloc ? movie_defer_alloc * 2 : 16;
+                    movie_event_t *new_defer = realloc(movie_defer, new_alloc * sizeof(movie_event_t));
+                    if (!new_defer) {
+                        log_error("movie: out of memory deferring input, event lost");
+                        if (ev->str)
+                            al_free(ev->str);
+                        return;
+                    }
+                    movie_defer = new_defer;
+                    movie_defer_alloc = new_alloc;
+                }
+                movie_defer[movie_defer_count++] = *ev;
+            }
+            else {
+                ev->stamp = movie_cycles;
+                movie_write(ev);
+                movie_apply(ev);
+            }
+            break;
+        case MOVIE_REPLAY:
+            log_debug("movie: live input type %d ignored during replay", ev->type);
+            if (ev->str)
+                al_free(ev->str);
+    }
+}
+
+void movie_key_event(const ALLEGRO_EVENT *event)
+{
+    movie_event_t ev = {
+        .code = event->keyboard.keycode,
+        .modifiers = event->keyboard.modifiers
+    };
+    if (ev.code <= 0 || ev.code >= ALLEGRO_KEY_MAX)
+        return;
+    switch(event->type) {
+        case ALLEGRO_EVENT_KEY_DOWN:
+            ev.type = MOVIE_EV_KEY_DOWN;
+            break;
+        case ALLEGRO_EVENT_KEY_CHAR:
+            ev.type = MOVIE_EV_KEY_CHAR;
+            ev.unichar = event->keyboard.unichar;
+            ev.modifiers = event->keyboard.repeat;
+            break;
+        case ALLEGRO_EVENT_KEY_UP:
+            ev.type = MOVIE_EV_KEY_UP;
+            break;
+        default:
+            return;
+    }
+    movie_input(&ev);
+}
+
+void movie_bbc_key(uint8_t bbckey, bool down)
+{
+    movie_event_t ev = {
+        .type = down ? MOVIE_EV_BBC_DOWN : MOVIE_EV_BBC_UP,
+        .code = bbckey
+    };
+    movie_input(&ev);
+}
+
+void movie_joy_axis(int chan, float value)
+{
+    movie_event_t ev = {
+        .type = MOVIE_EV_JOY_AXIS,
+        .code = chan,
+        .value = value
+    };
+    movie_input(&ev);
+}
+
+void movie_joy_button(int button, int value)
+{
+    movie_event_t ev = {
+        .type = MOVIE_EV_JOY_BUTTON,
+        .code = button,
+        .modifiers = value
+    };
+    movie_input(&ev);
+}
+
+static void movie_paste(char *str, int type)
+{
+    if (str) {
+        movie_event_t ev = {
+            .type = type,
+            .str = str
+        };
+        movie_input(&ev);
+    }
+}
+
+void movie_paste_kbd(char *str)
+{
+    movie_paste(str, MOVIE_EV_PASTE_KBD);
+}
+
+void movie_paste_os(char *str)
+{
+    movie_paste(str, MOVIE_EV_PASTE_OS);
+}
+
+static void movie_close(void)
+{
+    if (movie_fp) {
+        fclose(movie_fp);
+        movie_fp = NULL;
+    }
+    if (movie_have_next && movie_next.str)
+        al_free(movie_next.str);
+    movie_have_next = false;
+    for (size_t i = 0; i < movie_defer_count; i++)
+        if (movie_defer[i].str)
+            al_free(movie_defer[i].str);
+    movie_defer_count = 0;
+    movie_mode = MOVIE_OFF;
+}
+
+void movie_stop(void)
+{
+    if (movie_mode == MOVIE_RECORD) {
+        movie_event_t ev = { .type = MOVIE_EV_END, .stamp = movie_cycles };
+        movie_write(&ev);
+        if (ferror(movie_fp))
+            log_error("movie: error writing %s: %s", movie_name, strerror(errno));
+        log_info("movie: recorded %" PRIu64 " cycles to %s", movie_cycles, movie_name);
+    }
+    else if (movie_mode == MOVIE_REPLAY)
+        log_info("movie: replay of %s stopped after %" PRIu64 " cycles", movie_name, movie_cycles);
+    else
+        return;
+    movie_close();
+}
+
+static void movie_want_start(movie_mode_t mode, const char *name)
+{
+    char *name_copy = strdup(name);
+    if (name_copy) {
+        if (movie_want_name)
+            free(movie_want_name);
+        movie_want_name = name_copy;
+        movie_want = mode;
+    }
+    else
+        log_error("movie: out of memory copying filename");
+}
+
+void movie_record(const char *name)
+{
+    if (curtube != -1 && !tube_proc_savestate)
+        log_error("movie: current tube processor does not support saving state");
+    else
+        movie_want_start(MOVIE_RECORD, name);
+}
+
+void movie_replay(const char *name)
+{
+    movie_want_start(MOVIE_REPLAY, name);
+}
+
+/*
+ * Both the recording and the replay start from the same keyboard and
+ * joystick state, and the same peripheral timing, as none of these is
+ * part of a savestate.
+ */
+
+static void movie_reset_input(void)
+{
+    m6502_reset_timing();
+    sound_reset_timing();
+    music5000_reset_timing();
+    key_lost_focus();
+    for (int i = 0; i < 4; i++) {
+        joyaxes[i] = 0;
+        joybutton[i] = 0;
+    }
+    autoboot = 0;
+    movie_cycles = 0;
+    movie_last = 0;
+    rewind_clear();
+}
+
+static void movie_start_record(const char *name)
+{
+    if (!(movie_fp = fopen(name, "wb+"))) {
+        log_error("movie: unable to open %s for writing: %s", name, strerror(errno));
+        return;
+    }
+    fwrite(MOVIE_MAGIC, 8, 1, movie_fp);
+    putc(MOVIE_VERSION, movie_fp);
+    long start = ftell(movie_fp);
+    fseek(movie_fp, 4, SEEK_CUR);
+    savestate_save_machine(movie_fp, true);
+    long end = ftell(movie_fp);
+    long size = end - start - 4;
+    fseek(movie_fp, start, SEEK_SET);
+    for (int i = 0; i < 4; i++, size >>= 8)
+        putc(size & 0xff, movie_fp);
+    fseek(movie_fp, end, SEEK_SET);
+    movie_reset_input();
+    movie_mode = MOVIE_RECORD;
+    log_info("movie: recording to %s", name);
+}
+
+static void movie_start_replay(const char *name)
+{
+    unsigned char hdr[13];
+
+    if (!(movie_fp = fopen(name, "rb"))) {
+        log_error("movie: unable to open %s for reading: %s", name, strerror(errno));
+        return;
+    }
+    if (fread(hdr, sizeof(hdr), 1, movie_fp) != 1 || memcmp(hdr, MOVIE_MAGIC, 8)) {
+        log_error("movie: file %s is not a B-Em movie file", name);
+        movie_close();
+        return;
+    }
+    if (hdr[8] != MOVIE_VERSION) {
+        log_error("movie: unable to replay movie file version %c", hdr[8]);
+        movie_close();
+        return;
+    }
+    long size = hdr[9] | (hdr[10] << 8) | (hdr[11] << 16) | ((long)hdr[12] << 24);
+    long start = ftell(movie_fp);
+    savestate_load_machine(movie_fp, size);
+    fseek(movie_fp, start + size, SEEK_SET);
+    movie_reset_input();
+    movie_mode = MOVIE_REPLAY;
+    log_info("movie: replaying %s", name);
+}
+
+/*
+ * Called before each slice is run.  Pending starts happen here, so on
+ * a slice boundary, as do any replayed events which are now due.
+ */
+
+void movie_slice_start(void)
+{
+    if (movie_want != MOVIE_OFF && !savestate_wantload) {
+        movie_stop();
+        if (movie_name)
+            free(movie_name);
+        movie_name = movie_want_name;
+        movie_want_name = NULL;
+        if (movie_want == MOVIE_RECORD)
+            movie_start_record(movie_name);
+        else
+            movie_start_replay(movie_name);
+        movie_want = MOVIE_OFF;
+    }
+    if (movie_mode == MOVIE_REPLAY) {
+        for (;;) {
+            if (!movie_have_next) {
+                if (!movie_read(&movie_next)) {
+                    log_warn("movie: %s is truncated or corrupt", movie_name);
+                    movie_stop();
+                    break;
+                }
+                movie_have_next = true;
+            }
+            if (movie_next.stamp > movie_cycles)
+                break;
+            movie_have_next = false;
+            if (movie_next.type == MOVIE_EV_END) {
+                movie_stop();
+                if (headless)
+                    set_quit();
+                break;
+            }
+            movie_apply(&movie_next);
+        }
+    }
+    movie_in_slice = true;
+}
+
+void movie_slice_end(int cycles)
+{
+    movie_in_slice = false;
+    if (movie_mode != MOVIE_OFF) {
+        movie_cycles += cycles;
+        if (movie_mode == MOVIE_RECORD) {
+            for (size_t i = 0; i < movie_defer_count; i++)
+                movie_input(&movie_defer[i]);
+            movie_defer_count = 0;
+        }
+    }
+}
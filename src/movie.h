@@ -0,0 +1,26 @@
+#ifndef __INC_MOVIE_H
+#define __INC_MOVIE_H
+
+typedef enum {
+    MOVIE_OFF,
+    MOVIE_RECORD,
+    MOVIE_REPLAY
+} movie_mode_t;
+
+extern movie_mode_t movie_mode;
+
+void movie_record(const char *name);
+void movie_replay(const char *name);
+void movie_stop(void);
+
+void movie_slice_start(void);
+void movie_slice_end(int cycles);
+
+void movie_key_event(const ALLEGRO_EVENT *event);
+void movie_bbc_key(uint8_t bbckey, bool down);
+void movie_joy_axis(int chan, float value);
+void movie_joy_button(int button, int value);
+void movie_paste_kbd(char *str);
+void movie_paste_os(char *str);
+
+#endif
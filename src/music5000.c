@@ -33,6 +33,7 @@
 #include <allegro5/allegro_audio.h>
 #include "sound.h"
 #include "savestate.h"
+#include "hostprof.h"
 
 #define I_WAVEFORM(n) ((n)*128)
 #define I_WFTOP (14*128)
@@ -77,8 +78,11 @@ static ushort antilogtable[128];
 static uint16_t *music5000_buf;
 static int music5000_bufpos = 0;
 static int music5000_time = 0;
+static int music5000_pending = 0;
 static unsigned music5000_freq;
 
+static void music5000_render(void);
+
 static void synth_reset(struct synth *s)
 {
    // Real hardware clears 0x3E00 for 128bytes and random
@@ -90,6 +94,7 @@ static void synth_reset(struct synth *s)
 
 void music5000_reset(void)
 {
+    music5000_render();
     synth_reset(&m5000);
     synth_reset(&m3000);
 }
@@ -112,6 +117,7 @@ static void synth_savestate(struct synth *s, FILE *f)
 
 void music5000_savestate(FILE *f) {
     if (sound_music5000) {
+        music5000_render();
         putc_unlocked('M', f);
         savestate_save_var(9, f);
         synth_savestate(&m5000, f);
@@ -155,6 +161,9 @@ void music5000_init(int speed)
                                         al_destroy_voice(music5000_voice);
                                     music5000_voice = new_voice;
                                     music5000_freq = new_freq;
+                                    music5000_buf = new_frag;
+                                    music5000_bufpos = 0;
+                                    music5000_pending = 0;
                                     return;
                                 }
                                 else
@@ -207,6 +216,9 @@ void music5000_close(void)
         al_destroy_voice(music5000_voice);
         music5000_voice = NULL;
     }
+    music5000_buf = NULL;
+    music5000_bufpos = 0;
+    music5000_pending = 0;
     music5000_freq = 0;
 }
 
@@ -221,6 +233,7 @@ void music5000_loadstate(FILE *f) {
             }
             pc = savestate_load_var(f);
             if (pc == 9) {
+                music5000_render();
                 synth_loadstate(&m5000, f);
                 synth_loadstate(&m3000, f);
             }
@@ -263,19 +276,31 @@ void music5000_write(uint16_t addr, uint8_t val)
     if (addr == 0xfcff)
         page = val;
     else {
+        // Bring the sound up to date before the registers change.
         uint8_t msn = page & 0xf0;
-        if (msn == 0x30)
+        if (msn == 0x30) {
+            HOSTPROF(HOSTPROF_M5000, music5000_render());
             ram_write(&m5000, addr, val);
-        else if (msn == 0x50)
+        }
+        else if (msn == 0x50) {
+            HOSTPROF(HOSTPROF_M5000, music5000_render());
             ram_write(&m3000, addr, val);
+        }
     }
 }
 
+/*
+ * Modulation carries from one channel to the next, including from the
+ * last channel of the Music 5000 to the first of the Music 3000 and on
+ * to the next sample, so needs to live outside the synths.
+ */
+
+static uint8_t modulate = 0;
+
 static void update_channels(struct synth *s)
 {
     int sleft = 0;
     int sright = 0;
-    static uint8_t modulate = 0;
 
     for (int i = 0; i < 16; i++) {
         uint8_t * c = s->ram + I_WFTOP + modulate + i;
@@ -346,6 +371,59 @@ static void update_channels(struct synth *s)
     s->sright = sright / 6;
 }
 
+/*
+ * Sound is synthesised in blocks between writes to the synth registers
+ * which means, so long as no channel is using modulation, each channel
+ * is independent of the others and can be run for the whole block in
+ * one go with its registers decoded once.  This is the same sum as
+ * update_channels, one sample at a time, would give.
+ */
+
+#define M5000_BLOCK 192   // samples synthesised at a time.
+
+static bool synth_modulates(const struct synth *s)
+{
+    const uint8_t *ctl = s->ram + I_WFTOP + 0x70;
+    for (int i = 0; i < 16; i++)
+        if ((ctl[i] | ctl[i + 128]) & 0x20)
+            return true;
+    return false;
+}
+
+static void synth_block(struct synth *s, int n, int *left, int *right)
+{
+    memset(left, 0, n * sizeof(int));
+    memset(right, 0, n * sizeof(int));
+    for (int i = 0; i < 16; i++) {
+        const uint8_t *c = s->ram + I_WFTOP + i;
+        const uint8_t *wave = s->ram + I_WAVEFORM(WAVESEL(c));
+        uint32_t freq = FREQ(c);
+        uint32_t keep = DISABLE(c) ? 0 : 0xffffff;
+        uint32_t phase = s->phaseRAM[i];
+        int amp = s->amplitude[i];
+        int newamp = AMP(c);
+        int flip = INVERT(c) ? 0x80 : 0;
+        int lpan = PanArray[PAN(c)];
+        int rpan = 6 - lpan;
+        for (int k = 0; k < n; k++) {
+            uint32_t sum = (phase & keep) + freq;
+            phase = sum & 0xffffff;
+            if (sum & (1<<24))
+                amp = newamp;
+            int sample = wave[phase >> 17];
+            int sign = sample & 0x80;
+            sample += amp;
+            sample = ((sign ^ sample) & 0x80) ? antilogtable[sample & 0x7f] : 0;
+            if (sign ^ flip)
+                sample = -sample;
+            left[k]  += sample * lpan;
+            right[k] += sample * rpan;
+        }
+        s->phaseRAM[i] = phase;
+        s->amplitude[i] = amp;
+    }
+}
+
 static void fput_samples(int sl, int sr)
 {
     if (music5000_rec.fp && (music5000_rec.rec_started || sl || sr)) {
@@ -382,35 +460,44 @@ static const m5000_fcoeff m500_filters[2] = {
     }
 };
 
-static double xyv_l[]={0,0,0,0,0,0,0,0,0};
-static double xyv_r[]={0,0,0,0,0,0,0,0,0};
+/*
+ * The filter is a biquad followed by a first order section.  Left and
+ * right are run side by side so the compiler can do both in one go.
+ */
+
+typedef struct {
+    double x1[2], x2[2];    // last two inputs.
+    double y1[2], y2[2];    // last two outputs of the biquad.
+    double z1[2];           // last output of the first order section.
+} m5000_fstate;
+
+static m5000_fstate music5000_fstate;
 int music5000_fno;
 
-static double applyfilter(const m5000_fcoeff *fcp, double *xyv, double v)
+static void applyfilter(const m5000_fcoeff *fcp, m5000_fstate *st, double *v)
 {
-	int i,b,xp=0,yp=3,bqp=0;
-	double out=v/fcp->gain;
-	for (i=8; i>0; i--) {xyv[i]=xyv[i-1];}
-	for (b=0; b<NBQ; b++)
-	{
-		int len=(b==NBQ-1)?1:2;
-		xyv[xp]=out;
-		for(i=0; i<len; i++) { out+=xyv[xp+len-i]*fcp->biquadb[bqp+i]-xyv[yp+len-i]*fcp->biquada[bqp+i]; }
-		bqp+=len;
-		xyv[yp]=out;
-		xp=yp; yp+=len+1;
-	}
-	return out;
+    const double *a = fcp->biquada;
+    const double *b = fcp->biquadb;
+
+    for (int ch = 0; ch < 2; ch++) {
+        double x = v[ch] / fcp->gain;
+        double y = x + (st->x2[ch] * b[0] - st->y2[ch] * a[0]);
+        y += st->x1[ch] * b[1] - st->y1[ch] * a[1];
+        double z = y + (st->y1[ch] * b[2] - st->z1[ch] * a[2]);
+        st->x2[ch] = st->x1[ch];
+        st->x1[ch] = x;
+        st->y2[ch] = st->y1[ch];
+        st->y1[ch] = y;
+        st->z1[ch] = z;
+        v[ch] = z;
+    }
 }
 
-static void music5000_get_sample(const m5000_fcoeff *fcp)
+static void music5000_put_sample(const m5000_fcoeff *fcp, int sl, int sr)
 {
     int clip;
     static int divisor = 1;
 
-    update_channels(&m5000);
-    update_channels(&m3000);
-
 #ifdef LOG_LEVELS
     static int count = 0;
     static int min_l = INT_MAX;
@@ -422,13 +509,13 @@ static void music5000_get_sample(const m5000_fcoeff *fcp)
     static int window = FREQ_M5 * 30;
 #endif
 
-    int sl = m5000.sleft  + m3000.sleft;
-    int sr = m5000.sright + m3000.sright;
     if (fcp) {
-        sl = applyfilter(fcp, xyv_l, (double)sl);
-        sr = applyfilter(fcp, xyv_r, (double)sr);
+        double v[2] = { sl, sr };
+        applyfilter(fcp, &music5000_fstate, v);
+        sl = v[0];
+        sr = v[1];
     }
-    
+
     fput_samples(sl, sr);
 
 #ifdef LOG_LEVELS
@@ -500,35 +587,109 @@ static void music5000_get_sample(const m5000_fcoeff *fcp)
     music5000_buf[music5000_bufpos++] = sr;
 }
 
+static void music5000_block(const m5000_fcoeff *fcp, int n)
+{
+    int sl[M5000_BLOCK], sr[M5000_BLOCK];
+
+    if (!modulate && !synth_modulates(&m5000) && !synth_modulates(&m3000)) {
+        int l3[M5000_BLOCK], r3[M5000_BLOCK];
+        synth_block(&m5000, n, sl, sr);
+        synth_block(&m3000, n, l3, r3);
+        m5000.sleft  = sl[n-1] / 6;
+        m5000.sright = sr[n-1] / 6;
+        m3000.sleft  = l3[n-1] / 6;
+        m3000.sright = r3[n-1] / 6;
+        for (int k = 0; k < n; k++) {
+            sl[k] = sl[k] / 6 + l3[k] / 6;
+            sr[k] = sr[k] / 6 + r3[k] / 6;
+        }
+    }
+    else {
+        for (int k = 0; k < n; k++) {
+            update_channels(&m5000);
+            update_channels(&m3000);
+            sl[k] = m5000.sleft  + m3000.sleft;
+            sr[k] = m5000.sright + m3000.sright;
+        }
+    }
+    for (int k = 0; k < n; k++)
+        music5000_put_sample(fcp, sl[k], sr[k]);
+}
+
+/*
+ * Synthesise the samples owed since the last register write, handing
+ * each fragment to Allegro as it fills.
+ */
+
+static void music5000_render(void)
+{
+    const m5000_fcoeff *fcp = music5000_fno < 0 ? NULL : &m500_filters[music5000_fno];
+
+    while (music5000_pending > 0) {
+        if (!music5000_buf && music5000_stream) {
+            music5000_buf = al_get_audio_stream_fragment(music5000_stream);
+            log_debug("music5000: late buffer allocation %s", music5000_buf ? "worked" : "failed");
+        }
+        if (!music5000_buf) {
+            music5000_pending = 0;
+            return;
+        }
+        int n = buflen_m5 - music5000_bufpos / 2;
+        if (n > music5000_pending)
+            n = music5000_pending;
+        if (n > M5000_BLOCK)
+            n = M5000_BLOCK;
+        music5000_block(fcp, n);
+        music5000_pending -= n;
+        if (music5000_bufpos >= (buflen_m5*2)) {
+            al_set_audio_stream_fragment(music5000_stream, music5000_buf);
+            al_set_audio_stream_playing(music5000_stream, true);
+            music5000_buf = al_get_audio_stream_fragment(music5000_stream);
+            music5000_bufpos = 0;
+        }
+    }
+}
+
+/*
+ * Each 128 cycles owes three samples but nothing is synthesised until
+ * the registers are written or there is enough to fill a fragment.
+ */
+
 void music5000_poll(int cycles)
 {
     if (sound_music5000) {
         music5000_time -= cycles;
         if (music5000_time < 0) {
-            if (!music5000_buf) {
-                music5000_buf = al_get_audio_stream_fragment(music5000_stream);
-                log_debug("music5000: late buffer allocation %s", music5000_buf ? "worked" : "failed");
-            }
-            if (music5000_buf) {
-                const m5000_fcoeff *fcp = music5000_fno < 0 ? NULL : &m500_filters[music5000_fno];
-                music5000_get_sample(fcp);
-                music5000_get_sample(fcp);
-                music5000_get_sample(fcp);
-                if (music5000_bufpos >= (buflen_m5*2)) {
-                    al_set_audio_stream_fragment(music5000_stream, music5000_buf);
-                    al_set_audio_stream_playing(music5000_stream, true);
-                    music5000_buf = al_get_audio_stream_fragment(music5000_stream);
-                    music5000_bufpos = 0;
-                }
-            }
-            music5000_time += 128;
+            int ticks = (127 - music5000_time) >> 7;
+            music5000_time += ticks * 128;
+            music5000_pending += ticks * 3;
+            if (!music5000_buf || music5000_pending >= buflen_m5 - music5000_bufpos / 2)
+                music5000_render();
         }
     }
 }
 
+void music5000_reset_timing(void)
+{
+    music5000_time = 0;
+}
+
+int music5000_next_poll(void)
+{
+    if (!sound_music5000)
+        return INT_MAX;
+    int ticks = 1;
+    if (music5000_buf) {
+        int owed = buflen_m5 - music5000_bufpos / 2 - music5000_pending;
+        if (owed > 3)
+            ticks = (owed + 2) / 3;
+    }
+    return music5000_time + 1 + (ticks - 1) * 128;
+}
+
 bool music5000_ok(void)
 {
-    if (sound_music5000) {
+    if (sound_music5000 && music5000_stream) {
         unsigned frags = al_get_available_audio_stream_fragments(music5000_stream);
         if (frags < 2)
             return false;
@@ -12,6 +12,8 @@ void music5000_streamfrag(void);
 void music5000_write(uint16_t addr, uint8_t val);
 void music5000_reset(void);
 void music5000_poll(int cycles);
+void music5000_reset_timing(void);
+int  music5000_next_poll(void);
 bool music5000_ok(void);
 
 extern int music5000_fno;
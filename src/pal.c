@@ -207,57 +207,43 @@ void pal_convert(ALLEGRO_BITMAP *inb, int x1, int y1, int x2, int y2, int yoff)
 
 #ifdef PAL_FLOAT
 
-static inline int get_pixel(ALLEGRO_LOCKED_REGION *region, int x, int y)
-{
-    return *((uint32_t *)((char *)region->data + region->pitch * y + x * region->pixel_size));
-}
-
-static inline void put_pixel(ALLEGRO_LOCKED_REGION *region, int x, int y, uint32_t colour)
-{
-    *((uint32_t *)((char *)region->data + region->pitch * y + x * region->pixel_size)) = colour;
-}
-
-static float vision_iir(float NewSample) {
-    static float x; //input samples
-
-    x = (x + NewSample) * 0.5;
-//    x = NewSample;
-
-    return x;
-}
-
-
-#define NCoef 2
-
-static inline float chroma_iir(float NewSample) {
-    static float y[NCoef+1]; //output samples
-    static float x[NCoef+1]; //input samples
-
-    x[2] = x[1];
-    x[1] = x[0];
-    x[0] = NewSample;
-    y[2] = y[1];
-    y[1] = y[0];
-
-
-    //Calculate the new output
-    y[0]  = 0.754226 * x[0];
-    y[0] -= 0.184815 * y[1];
-    y[0] -= 0.754226 * x[2];
-    y[0] -= 0.332316 * y[2];
-
-    return y[0];
-}
+/*
+ * The frame is split by lines into bands, each converted on its own
+ * host thread.  So that bands do not depend on each other the filters
+ * start afresh on each line, which only touches the border, and each
+ * band first runs the line above it to fill the PAL delay line.
+ */
+
+#define PAL_MAX_THREADS 8
+#define PAL_MIN_BAND   32   // lines, smaller bands are not worth a thread
+#define PAL_MAX_WIDTH 1536
+
+typedef struct {
+    int x1, y1, x2, yoff;
+    int lines, bands, wt;
+    const ALLEGRO_LOCKED_REGION *src;
+    ALLEGRO_LOCKED_REGION *dr;
+} pal_frame_t;
+
+static ALLEGRO_THREAD *pal_threads[PAL_MAX_THREADS];
+static ALLEGRO_MUTEX *pal_mutex;
+static ALLEGRO_COND *pal_run_cond;
+static ALLEGRO_COND *pal_done_cond;
+static int pal_nthreads = 1;
+static unsigned pal_gen;
+static int pal_busy;
+static pal_frame_t pal_frame;
 
 #define WT_INC ((4433618.75 / 16000000.0) * (2 * 3.14))
 
-static float sint[832*2], cost[832*2];
+// A line may start anywhere in the first 832 and run its full width.
+static float sint[832 + PAL_MAX_WIDTH], cost[832 + PAL_MAX_WIDTH];
 
 void pal_init(void)
 {
         int c;
         float wt = 0.0;
-        for (c = 0; c < 832*2; c++)
+        for (c = 0; c < 832 + PAL_MAX_WIDTH; c++)
         {
                 sint[c] = sin(wt);
                 cost[c] = cos(wt);
@@ -265,68 +251,217 @@ void pal_init(void)
         }
 }
 
-void pal_convert(int x1, int y1, int x2, int y2, int yoff)
+/*
+ * First pass over a line: encode to composite and decode again.  This
+ * is a chain of filters so has to go one pixel at a time but runs of
+ * the same colour, which is almost all of them, reuse the conversion
+ * to YUV.  Leaves luma in yl and this line's chroma in uo and vo.
+ */
+
+static void pal_line(const pal_frame_t *fp, int y, int wt, float *yl, float *uo, float *vo)
 {
-        int x, y;
-        uint32_t pixel;
-        float r, g, b, Y, U, V, signal;
-        static int wt;
-        float u_old[2][1536], v_old[2][1536];
-        float u_filt[4], v_filt[4];
-        float *uo[2], *vo[2];
-        ALLEGRO_LOCKED_REGION *dr;
+    const uint32_t *src = (const uint32_t *)((const char *)fp->src->data + fp->src->pitch * y);
+    const float *sinp = sint + wt;
+    const float *cosp = cost + wt;
+    float u_filt[4] = { 0.0, 0.0, 0.0, 0.0 };
+    float v_filt[4] = { 0.0, 0.0, 0.0, 0.0 };
+    float cx1 = 0.0, cx2 = 0.0, cy1 = 0.0, cy2 = 0.0, vis = 0.0;
+    uint32_t last = 0;
+    float Yc = 0.0, Uc = 0.0, Vc = 0.0;
+
+    for (int x = fp->x1; x < fp->x2; x++) {
+        uint32_t pixel = src[x] & 0xffffff;
+        if (pixel != last) {
+            float r = (float)(pixel >> 16);
+            float g = (float)((pixel >> 8) & 0xff);
+            float b = (float)(pixel & 0xff);
+            Yc = 0.299 * r + 0.587 * g + 0.114 * b;
+            Uc = -0.147 * r - 0.289 * g + 0.436 * b;
+            Vc = 0.615 * r - 0.515 * g - 0.100 * b;
+            last = pixel;
+        }
+        vis = (vis + Yc) * 0.5;
+
+        float sinw = sinp[x - fp->x1];
+        float cosw = cosp[x - fp->x1];
+        float chroma = Uc * sinw + Vc * cosw;
+        float out = 0.754226 * chroma;
+        out -= 0.184815 * cy1;
+        out -= 0.754226 * cx2;
+        out -= 0.332316 * cy2;
+        cx2 = cx1;
+        cx1 = chroma;
+        cy2 = cy1;
+        cy1 = out;
+
+        float signal = vis + out;
+        u_filt[x & 3] = signal * sinw;
+        v_filt[x & 3] = signal * cosw;
+        yl[x] = vis;
+        uo[x] = u_filt[0] + u_filt[1] + u_filt[2] + u_filt[3];
+        vo[x] = v_filt[0] + v_filt[1] + v_filt[2] + v_filt[3];
+    }
+}
 
-        for (x = x1; x < x2; x++)
-            u_old[0][x] = u_old[1][x] = v_old[0][x] = v_old[1][x] = 0.0;
-        for (x = 0; x < 4; x++)
-            u_filt[x] = v_filt[x] = 0.0;
-        dr = al_lock_bitmap(b32, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_WRITEONLY);
-        for (y = y1; y < y2; y += yoff)
-        {
-                uo[0] = u_old[y&1];
-                vo[0] = v_old[y&1];
-                uo[1] = u_old[(y&1)^1];
-                vo[1] = v_old[(y&1)^1];
-                for (x = x1; x < x2; x++)
-                {
-                        pixel = get_pixel(region, x, y);
-                        r = (float)((pixel >> 16) & 0xff);
-                        g = (float)((pixel >> 8) & 0xff);
-                        b = (float)(pixel & 0xff);
-                        Y = vision_iir(0.299 * r + 0.587 * g + 0.114 * b);
-                        U = -0.147 * r - 0.289 * g + 0.436 * b;
-                        V = 0.615 * r - 0.515 * g - 0.100 * b;
-
-                        signal = Y + chroma_iir(U * sint[wt] + V * cost[wt]);
-
-                        u_filt[x & 3] = signal * sint[wt];
-                        v_filt[x & 3] = signal * cost[wt];
-                        U = u_filt[0] + u_filt[1] + u_filt[2] + u_filt[3];
-                        V = v_filt[0] + v_filt[1] + v_filt[2] + v_filt[3];
-                        uo[0][x] = U;
-                        vo[0][x] = V;
-                        U += uo[1][x];
-                        V += vo[1][x];
-                        wt++;
+/*
+ * Second pass: average the chroma with the line before, as a PAL
+ * delay line does, and convert back to RGB.  Each pixel stands alone
+ * here so the compiler is free to do several at once.
+ */
 
-                        r = Y + (1.140/2.0) * V;
-                        g = Y - (0.396/2.0) * U - (0.581/8.0) * V;
-                        b = Y + (2.029/2.0) * U;
+static void pal_output(const pal_frame_t *fp, int y, const float *yl, const float *uo, const float *vo, const float *up, const float *vp)
+{
+    uint32_t *dest = (uint32_t *)((char *)fp->dr->data + fp->dr->pitch * y);
+
+    for (int x = fp->x1; x < fp->x2; x++) {
+        float U = uo[x] + up[x];
+        float V = vo[x] + vp[x];
+        float r = yl[x] + (float)(1.140/2.0) * V;
+        float g = yl[x] - (float)(0.396/2.0) * U - (float)(0.581/8.0) * V;
+        float b = yl[x] + (float)(2.029/2.0) * U;
+        r = r > 255.0f ? 255.0f : r < 0.0f ? 0.0f : r;
+        g = g > 255.0f ? 255.0f : g < 0.0f ? 0.0f : g;
+        b = b > 255.0f ? 255.0f : b < 0.0f ? 0.0f : b;
+        dest[x] = 0xff000000|((uint32_t)r << 16)|((uint32_t)g << 8)|(uint32_t)b;
+    }
+}
 
-                        if (r > 255) r = 255;
-                        if (r < 0)   r = 0;
-                        if (g > 255) g = 255;
-                        if (g < 0)   g = 0;
-                        if (b > 255) b = 255;
-                        if (b < 0)   b = 0;
+static void pal_band(const pal_frame_t *fp, int band)
+{
+    float yl[PAL_MAX_WIDTH];
+    float u_old[2][PAL_MAX_WIDTH], v_old[2][PAL_MAX_WIDTH];
+    int first = fp->lines * band / fp->bands;
+    int last = fp->lines * (band + 1) / fp->bands;
+    int cur = 0;
+
+    if (first > 0) {
+        // Only wanted for its chroma, to prime the delay line.
+        int line = first - 1;
+        pal_line(fp, fp->y1 + line * fp->yoff, (fp->wt + 192 * line) % 832, yl, u_old[0], v_old[0]);
+    }
+    else {
+        for (int x = fp->x1; x < fp->x2; x++)
+            u_old[0][x] = v_old[0][x] = 0.0;
+    }
+    for (int line = first; line < last; line++) {
+        int y = fp->y1 + line * fp->yoff;
+        cur ^= 1;
+        pal_line(fp, y, (fp->wt + 192 * line) % 832, yl, u_old[cur], v_old[cur]);
+        pal_output(fp, y, yl, u_old[cur], v_old[cur], u_old[cur ^ 1], v_old[cur ^ 1]);
+    }
+}
 
-                        put_pixel(dr, x, y, 0xff000000|((uint32_t)r << 16)|((uint32_t)g << 8)|(uint32_t)b);
-                }
+static void *pal_thread_proc(ALLEGRO_THREAD *thread, void *data)
+{
+    int band = (intptr_t)data;
+    unsigned gen = 0;
+
+    al_lock_mutex(pal_mutex);
+    while (!al_get_thread_should_stop(thread)) {
+        if (gen != pal_gen) {
+            gen = pal_gen;
+            if (band < pal_frame.bands) {
+                al_unlock_mutex(pal_mutex);
+                pal_band(&pal_frame, band);
+                al_lock_mutex(pal_mutex);
+                if (--pal_busy == 0)
+                    al_broadcast_cond(pal_done_cond);
+            }
+        }
+        else
+            al_wait_cond(pal_run_cond, pal_mutex);
+    }
+    al_unlock_mutex(pal_mutex);
+    return NULL;
+}
+
+static void pal_start_threads(void)
+{
+    int want = al_get_cpu_count();
+    if (want > PAL_MAX_THREADS)
+        want = PAL_MAX_THREADS;
+    if (want > 1) {
+        if (!(pal_mutex = al_create_mutex()) || !(pal_run_cond = al_create_cond()) || !(pal_done_cond = al_create_cond())) {
+            log_error("pal: unable to create synchronisation objects, converting on one thread");
+            return;
+        }
+        while (pal_nthreads < want) {
+            ALLEGRO_THREAD *thread = al_create_thread(pal_thread_proc, (void *)(intptr_t)pal_nthreads);
+            if (!thread) {
+                log_warn("pal: unable to create worker thread %d", pal_nthreads);
+                break;
+            }
+            pal_threads[pal_nthreads++] = thread;
+            al_start_thread(thread);
+        }
+        log_debug("pal: converting on %d threads", pal_nthreads);
+    }
+}
 
-                wt += (1024 - (x2 - x1));
-                wt %= 832;
+void pal_close(void)
+{
+    if (pal_nthreads > 1) {
+        for (int i = 1; i < pal_nthreads; i++)
+            al_set_thread_should_stop(pal_threads[i]);
+        al_lock_mutex(pal_mutex);
+        al_broadcast_cond(pal_run_cond);
+        al_unlock_mutex(pal_mutex);
+        for (int i = 1; i < pal_nthreads; i++) {
+            al_join_thread(pal_threads[i], NULL);
+            al_destroy_thread(pal_threads[i]);
+            pal_threads[i] = NULL;
         }
-        al_unlock_bitmap(b32);
+        pal_nthreads = 1;
+    }
+}
+
+void pal_convert(const ALLEGRO_LOCKED_REGION *src, int x1, int y1, int x2, int y2, int yoff)
+{
+        static int wt;
+        static bool started;
+
+        if (x2 > PAL_MAX_WIDTH)
+            x2 = PAL_MAX_WIDTH;
+        if (x1 >= x2 || y1 >= y2)
+            return;
+        if (!started) {
+            pal_start_threads();
+            started = true;
+        }
+
+        pal_frame.src = src;
+        pal_frame.x1 = x1;
+        pal_frame.y1 = y1;
+        pal_frame.x2 = x2;
+        pal_frame.yoff = yoff;
+        pal_frame.lines = (y2 - y1 + yoff - 1) / yoff;
+        pal_frame.wt = wt;
+        pal_frame.bands = pal_frame.lines / PAL_MIN_BAND;
+        if (pal_frame.bands > pal_nthreads)
+            pal_frame.bands = pal_nthreads;
+        if (pal_frame.bands < 1)
+            pal_frame.bands = 1;
+        pal_frame.dr = al_lock_bitmap(b32, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_WRITEONLY);
+        if (pal_frame.dr) {
+            if (pal_frame.bands > 1) {
+                al_lock_mutex(pal_mutex);
+                pal_busy = pal_frame.bands - 1;
+                pal_gen++;
+                al_broadcast_cond(pal_run_cond);
+                al_unlock_mutex(pal_mutex);
+                pal_band(&pal_frame, 0);
+                al_lock_mutex(pal_mutex);
+                while (pal_busy)
+                    al_wait_cond(pal_done_cond, pal_mutex);
+                al_unlock_mutex(pal_mutex);
+            }
+            else
+                pal_band(&pal_frame, 0);
+            al_unlock_bitmap(b32);
+        }
+
+        // Each line moves the subcarrier on by 1024 pixels.
+        wt = (wt + 192 * pal_frame.lines) % 832;
 }
 
 #endif
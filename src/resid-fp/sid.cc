@@ -23,9 +23,11 @@
 
 extern float convolve(const float *a, const float *b, int n);
 extern float convolve_sse(const float *a, const float *b, int n);
+extern float convolve_avx2(const float *a, const float *b, int n);
 
 enum host_cpu_feature {
-    HOST_CPU_MMX=1, HOST_CPU_SSE=2, HOST_CPU_SSE2=4, HOST_CPU_SSE3=8
+    HOST_CPU_MMX=1, HOST_CPU_SSE=2, HOST_CPU_SSE2=4, HOST_CPU_SSE3=8,
+    HOST_CPU_AVX2=16
 };
 
 /* This code is appropriate for 32-bit and 64-bit x86 CPUs. */
@@ -75,6 +77,19 @@ static int host_cpu_features_by_cpuid(void)
   if (regs.ecx & (1 << 0))
     features |= HOST_CPU_SSE3;
 
+#if (RESID_USE_AVX2==1)
+  /* AVX2 and FMA are only usable if the OS saves the YMM registers. */
+  const unsigned int fma_osxsave_avx = (1 << 12) | (1 << 27) | (1 << 28);
+  if ((regs.ecx & fma_osxsave_avx) == fma_osxsave_avx
+      && get_cpuid_regs(0).eax >= 7) {
+    unsigned int xcr0_lo, xcr0_hi, eax, ebx, ecx, edx;
+    __asm__ ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    if ((xcr0_lo & 6) == 6 && (ebx & (1 << 5)))
+      features |= HOST_CPU_AVX2;
+  }
+#endif
+
   return features;
 }
 
@@ -131,6 +146,11 @@ SIDFP::SIDFP()
 #else
   can_use_sse = false;
 #endif
+#if (RESID_USE_AVX2==1)
+  can_use_avx2 = (host_cpu_features() & HOST_CPU_AVX2) != 0;
+#else
+  can_use_avx2 = false;
+#endif
 
   // Initialize pointers.
   sample = 0;
@@ -850,6 +870,9 @@ int SIDFP::clock_resample_interpolate(cycle_count& delta_t, short* buf, int n,
     float* sample_start = sample + sample_index - fir_N + RINGSIZE - 1;
 
     float v1 =
+#if (RESID_USE_AVX2==1)
+      can_use_avx2 ? convolve_avx2(sample_start, fir + fir_offset*fir_N, fir_N) :
+#endif
 #if (RESID_USE_SSE==1)
       can_use_sse ? convolve_sse(sample_start, fir + fir_offset*fir_N, fir_N) :
 #endif
@@ -862,6 +885,9 @@ int SIDFP::clock_resample_interpolate(cycle_count& delta_t, short* buf, int n,
       ++ sample_start;
     }
     float v2 =
+#if (RESID_USE_AVX2==1)
+      can_use_avx2 ? convolve_avx2(sample_start, fir + fir_offset*fir_N, fir_N) :
+#endif
 #if (RESID_USE_SSE==1)
       can_use_sse ? convolve_sse(sample_start, fir + fir_offset*fir_N, fir_N) :
 #endif
@@ -34,6 +34,7 @@ public:
 
   static float kinked_dac(const int x, const float nonlinearity, const int bits);
   bool sse_enabled() { return can_use_sse; }
+  bool avx2_enabled() { return can_use_avx2; }
 
   void set_chip_model(chip_model model);
   FilterFP& get_filter() { return filter; }
@@ -125,6 +126,7 @@ protected:
   float* fir;
 
   bool can_use_sse;
+  bool can_use_avx2;
 };
 
 #endif // not __SID_H__
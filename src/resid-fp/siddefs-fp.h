@@ -80,6 +80,13 @@ const char* resid_version_string = VERSION;
 #define RESID_USE_SSE 0
 #endif
 
+// The AVX2 kernel is built with a target attribute so needs GCC or clang.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RESID_USE_AVX2 1
+#else
+#define RESID_USE_AVX2 0
+#endif
+
 #define HAVE_LOGF
 #define HAVE_EXPF
 #define HAVE_LOGF_PROTOTYPE
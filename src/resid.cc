@@ -150,9 +150,10 @@ static void fillbuf2(int& count, int16_t *buf, int len)
         else            memset(buf,0,len*2);
 //        printf("Result %i len %i\n",c,len);
 }
+/*The chip runs at 1MHz so each sample at FREQ_SID is 32 cycles.*/
 void sid_fillbuf(int16_t *buf, int len)
 {
-        int x=64;
-        
+        int x=len*(1000000/FREQ_SID);
+
         fillbuf2(x,buf,len);
 }
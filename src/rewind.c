@@ -0,0 +1,259 @@
+/*B-em rewind
+  In-memory snapshots of the machine taken at regular intervals which
+  can be stepped back through.
+
+  Main memory and sideways ROM/RAM is kept in pages which are shared
+  with the previous snapshot when unchanged, so a snapshot of a machine
+  which is mostly running from ROM costs little more than the rest of
+  the state, which is serialised with the same per-device functions as
+  a savestate file.  That includes the memory of any second processor,
+  which is why snapshots are only taken when enabled.*/
+
+#include <errno.h>
+#include "b-em.h"
+#include "6502.h"
+#include "mem.h"
+#include "model.h"
+#include "movie.h"
+#include "rewind.h"
+#include "savestate.h"
+#include "tube.h"
+
+#define REWIND_SLOTS    32
+#define REWIND_INTERVAL 2000000  // 2MHz cycles between snapshots, i.e. 1s.
+#define REWIND_PAGE     1024
+#define REWIND_NPAGES   ((RAM_SIZE + ROM_SIZE * ROM_NSLOT) / REWIND_PAGE)
+
+typedef struct {
+    int refs;
+    uint8_t data[REWIND_PAGE];
+} rewind_page_t;
+
+typedef struct {
+    rewind_page_t *pages[REWIND_NPAGES];
+    unsigned char *state;
+    long state_size;
+    uint8_t fe30, fe34;
+} rewind_snap_t;
+
+bool rewind_enabled = false;
+
+static rewind_snap_t rewind_ring[REWIND_SLOTS];
+static int rewind_count;    // number of snapshots held.
+static int rewind_newest;   // ring index of the most recent.
+static int rewind_cycles;   // cycles run since the most recent.
+static int rewind_want;     // steps back requested.
+static bool rewind_warned;
+
+#if defined(HAVE_OPEN_MEMSTREAM) && defined(HAVE_FMEMOPEN)
+
+/* The state is serialised straight into, and back out of, memory. */
+
+static bool rewind_save_state(rewind_snap_t *snap)
+{
+    char *buf = NULL;
+    size_t size;
+    FILE *fp = open_memstream(&buf, &size);
+    if (!fp)
+        return false;
+    savestate_save_machine(fp, false);
+    if (fclose(fp)) {
+        free(buf);
+        return false;
+    }
+    snap->state = (unsigned char *)buf;
+    snap->state_size = size;
+    return true;
+}
+
+static bool rewind_load_state(rewind_snap_t *snap)
+{
+    FILE *fp = fmemopen(snap->state, snap->state_size, "rb");
+    if (!fp)
+        return false;
+    savestate_load_machine(fp, snap->state_size);
+    fclose(fp);
+    return true;
+}
+
+#else
+
+/* Without memory streams a scratch file is used and copied to memory. */
+
+static FILE *rewind_fp;
+
+static bool rewind_save_state(rewind_snap_t *snap)
+{
+    if (!rewind_fp && !(rewind_fp = tmpfile()))
+        return false;
+    fseek(rewind_fp, 0, SEEK_SET);
+    savestate_save_machine(rewind_fp, false);
+    long size = ftell(rewind_fp);
+    if (!(snap->state = malloc(size)))
+        return false;
+    fseek(rewind_fp, 0, SEEK_SET);
+    if (fread(snap->state, size, 1, rewind_fp) != 1)
+        return false;
+    snap->state_size = size;
+    return true;
+}
+
+static bool rewind_load_state(rewind_snap_t *snap)
+{
+    fseek(rewind_fp, 0, SEEK_SET);
+    if (fwrite(snap->state, snap->state_size, 1, rewind_fp) != 1)
+        return false;
+    fseek(rewind_fp, 0, SEEK_SET);
+    savestate_load_machine(rewind_fp, snap->state_size);
+    return true;
+}
+
+#endif
+
+static uint8_t *rewind_mem(int page)
+{
+    if (page < RAM_SIZE / REWIND_PAGE)
+        return ram + page * REWIND_PAGE;
+    return rom + (page - RAM_SIZE / REWIND_PAGE) * REWIND_PAGE;
+}
+
+static void rewind_free(rewind_snap_t *snap)
+{
+    for (int i = 0; i < REWIND_NPAGES; i++) {
+        rewind_page_t *page = snap->pages[i];
+        if (page && --page->refs == 0)
+            free(page);
+        snap->pages[i] = NULL;
+    }
+    if (snap->state) {
+        free(snap->state);
+        snap->state = NULL;
+    }
+}
+
+void rewind_clear(void)
+{
+    while (rewind_count > 0) {
+        rewind_free(rewind_ring + rewind_newest);
+        rewind_newest = (rewind_newest + REWIND_SLOTS - 1) % REWIND_SLOTS;
+        rewind_count--;
+    }
+    rewind_cycles = 0;
+    rewind_warned = false;
+}
+
+static bool rewind_available(void)
+{
+    const char *why;
+
+    if (mem_jim_size != JIM_NONE)
+        why = "JIM RAM is enabled";
+    else if (curtube != -1 && !tube_proc_savestate)
+        why = "the current tube processor does not support saving state";
+    else
+        return true;
+    if (!rewind_warned) {
+        log_warn("rewind: snapshots not available: %s", why);
+        rewind_warned = true;
+    }
+    return false;
+}
+
+static void rewind_capture(void)
+{
+    rewind_snap_t *prev = rewind_count ? rewind_ring + rewind_newest : NULL;
+    int slot = (rewind_newest + 1) % REWIND_SLOTS;
+    rewind_snap_t *snap = rewind_ring + slot;
+
+    if (rewind_count == REWIND_SLOTS) {
+        rewind_free(snap);
+        rewind_count--;
+    }
+    for (int i = 0; i < REWIND_NPAGES; i++) {
+        uint8_t *mem = rewind_mem(i);
+        rewind_page_t *page = prev ? prev->pages[i] : NULL;
+        if (page && !memcmp(page->data, mem, REWIND_PAGE))
+            page->refs++;
+        else if ((page = malloc(sizeof(rewind_page_t)))) {
+            page->refs = 1;
+            memcpy(page->data, mem, REWIND_PAGE);
+        }
+        else {
+            log_error("rewind: out of memory taking snapshot");
+            rewind_free(snap);
+            return;
+        }
+        snap->pages[i] = page;
+    }
+    snap->fe30 = ram_fe30;
+    snap->fe34 = ram_fe34;
+
+    if (!rewind_save_state(snap)) {
+        log_error("rewind: unable to take snapshot: %s", strerror(errno));
+        rewind_free(snap);
+        return;
+    }
+    rewind_newest = slot;
+    rewind_count++;
+}
+
+static void rewind_restore(rewind_snap_t *snap)
+{
+    writemem(0xFE30, snap->fe30);
+    // Only these have a latch at FE34; elsewhere it is another ROMSEL
+    // address and writing it would page in ROM 0.
+    if (MASTER || BPLUS || integra)
+        writemem(0xFE34, snap->fe34);
+    if (ram_fe30 != snap->fe30)
+        log_warn("rewind: sideways ROM %d selected, snapshot had %d", ram_fe30 & 0x0f, snap->fe30 & 0x0f);
+    for (int i = 0; i < REWIND_NPAGES; i++)
+        memcpy(rewind_mem(i), snap->pages[i]->data, REWIND_PAGE);
+
+    if (!rewind_load_state(snap))
+        log_error("rewind: unable to restore snapshot: %s", strerror(errno));
+}
+
+static void rewind_back(int steps)
+{
+    if (!rewind_count) {
+        log_warn("rewind: no snapshots to rewind to");
+        return;
+    }
+    /* A snapshot taken only a moment ago would barely go back at all so
+     * count it as the current position rather than as a step. */
+    if (rewind_cycles < REWIND_INTERVAL / 2 && rewind_count > 1)
+        steps++;
+    while (steps > 1 && rewind_count > 1) {
+        rewind_free(rewind_ring + rewind_newest);
+        rewind_newest = (rewind_newest + REWIND_SLOTS - 1) % REWIND_SLOTS;
+        rewind_count--;
+        steps--;
+    }
+    rewind_restore(rewind_ring + rewind_newest);
+    rewind_cycles = 0;
+    log_debug("rewind: restored snapshot, %d remaining", rewind_count);
+}
+
+void rewind_step(int count)
+{
+    if (movie_mode != MOVIE_OFF)
+        log_warn("rewind: not available while a movie is recording or replaying");
+    else
+        rewind_want += count;
+}
+
+void rewind_poll(int cycles)
+{
+    if (rewind_want) {
+        rewind_back(rewind_want);
+        rewind_want = 0;
+    }
+    else if (rewind_enabled) {
+        rewind_cycles += cycles;
+        if (rewind_cycles >= REWIND_INTERVAL) {
+            rewind_cycles = 0;
+            if (rewind_available())
+                rewind_capture();
+        }
+    }
+}
@@ -0,0 +1,10 @@
+#ifndef __INC_REWIND_H
+#define __INC_REWIND_H
+
+extern bool rewind_enabled;
+
+void rewind_poll(int cycles);
+void rewind_step(int count);
+void rewind_clear(void);
+
+#endif
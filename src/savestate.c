@@ -1,6 +1,7 @@
 /*B-em v2.2 by Tom Walker
   Savestate handling*/
 #include "b-em.h"
+#include <limits.h>
 #include <zlib.h>
 
 #include "6502.h"
@@ -190,13 +191,18 @@ void savestate_zwrite(ZFILE *zfp, void *src, size_t size)
     log_warn("savestate: compression error %d (%s)", res, zfp->zs.msg);
 }
 
-void savestate_dosave(void)
+/*
+ * Save the sections of a savestate.  Without full, the model and main
+ * memory sections are left out which is what the rewind snapshots need.
+ */
+
+static void save_sections(FILE *fp, bool full)
 {
-    FILE *fp = savestate_fp;
-    fwrite("BEMSNAP3", 8,1, fp);
-    save_sect(fp, 'm', model_savestate);
+    if (full)
+        save_sect(fp, 'm', model_savestate);
     save_sect(fp, '6', m6502_savestate);
-    save_zlib(fp, 'M', mem_savezlib);
+    if (full)
+        save_zlib(fp, 'M', mem_savezlib);
     save_sect(fp, 'S', sysvia_savestate);
     save_sect(fp, 'U', uservia_savestate);
     save_sect(fp, 'V', videoula_savestate);
@@ -209,11 +215,20 @@ void savestate_dosave(void)
     save_sect(fp, 'F', vdfs_savestate);
     save_sect(fp, '5', music5000_savestate);
     save_sect(fp, 'p', paula_savestate);
-    save_zlib(fp, 'J', mem_jim_savez);
+    if (full)
+        save_zlib(fp, 'J', mem_jim_savez);
     if (curtube != -1) {
         save_sect(fp, 'T', tube_ula_savestate);
         save_zlib(fp, 'P', tube_proc_savestate);
     }
+}
+
+void savestate_dosave(void)
+{
+    FILE *fp = savestate_fp;
+    tube_thread_stop();
+    fwrite("BEMSNAP3", 8,1, fp);
+    save_sections(fp, true);
     fclose(fp);
     savestate_wantsave = 0;
     savestate_fp = NULL;
@@ -371,11 +386,11 @@ static void load_state_two(FILE *fp)
     }
 }
 
-static void load_state_three(FILE *fp)
+static void load_sections(FILE *fp, long end)
 {
     unsigned char hdr[3];
 
-    while (fread(hdr, sizeof hdr, 1, fp) == 1) {
+    while (ftell(fp) < end && fread(hdr, sizeof hdr, 1, fp) == 1) {
         int key = hdr[0];
         long size = hdr[1] | (hdr[2] << 8);
         if (key & 0x80) {
@@ -390,9 +405,15 @@ static void load_state_three(FILE *fp)
     }
 }
 
+static void load_state_three(FILE *fp)
+{
+    load_sections(fp, LONG_MAX);
+}
+
 void savestate_doload(void)
 {
     FILE *fp = savestate_fp;
+    tube_thread_stop();
     switch(savestate_wantload) {
         case '1':
             load_state_one(fp);
@@ -413,6 +434,23 @@ void savestate_doload(void)
     savestate_fp = NULL;
 }
 
+void savestate_save_machine(FILE *fp, bool full)
+{
+    tube_thread_park();
+    savestate_fp = fp;
+    save_sections(fp, full);
+    savestate_fp = NULL;
+    tube_thread_unpark();
+}
+
+void savestate_load_machine(FILE *fp, long size)
+{
+    tube_thread_stop();
+    savestate_fp = fp;
+    load_sections(fp, ftell(fp) + size);
+    savestate_fp = NULL;
+}
+
 void savestate_save_var(unsigned var, FILE *f) {
     uint8_t byte;
 
@@ -42,6 +42,7 @@ Offset  Description                 Access
 #include "b-em.h"
 #include "main.h"
 #include "scsi.h"
+#include "hdimage.h"
 #include "6502.h"
 #include "led.h"
 
@@ -89,7 +90,8 @@ struct scsi_disc {
     bool (*ReadSector)(scsidisc *disc, unsigned char *buf, unsigned block);
     bool (*WriteSector)(scsidisc *disc, unsigned char *buf, unsigned block);
     ALLEGRO_PATH *path;
-    FILE *dat_fp, *dsc_fp;
+    hdimage_t *dat;
+    FILE *dsc_fp;
     unsigned blocks;
     unsigned char geom[33];
 };
@@ -146,7 +148,7 @@ static void Status(void)
 static bool DiscTestUnitReady(unsigned char *buf)
 {
     log_debug("scsi lun %d: test unit ready", scsi.lun);
-    if (SCSIDisc[scsi.lun].dat_fp == NULL)
+    if (SCSIDisc[scsi.lun].dat == NULL)
         return false;
     return true;
 }
@@ -238,10 +240,9 @@ static bool DiscFormat(unsigned char *buf)
         sd->path = path;
     }
     cpath = al_path_cstr(path, ALLEGRO_NATIVE_PATH_SEP);
-    if (sd->dat_fp)
-        fclose(sd->dat_fp);
-    if (!(sd->dat_fp = fopen(cpath, "wb+"))) {
-        log_error("scsi lun %d: unable to open %s: %s", scsi.lun, cpath, strerror(errno));
+    hdimage_close(sd->dat);
+    if (!(sd->dat = hdimage_open(cpath, true))) {
+        log_error("scsi lun %d: unable to open %s", scsi.lun, cpath);
         return false;
     }
     return true;
@@ -271,25 +272,15 @@ static bool ReadWriteNone(scsidisc *sd, unsigned char *buf, unsigned block)
 static bool ReadSectorSimple(scsidisc *sd, unsigned char *buf, unsigned block)
 {
     log_debug("scsi lun %d: read sector %u", scsi.lun, block);
-    if (fseek(sd->dat_fp, block * 256, SEEK_SET))
-        return false;
-    if (fread(buf, 256, 1, sd->dat_fp) != 1 && ferror(sd->dat_fp)) {
-        log_warn("scsi lun %d: read error: %s", scsi.lun, strerror(errno));
-        return false;
-    }
-    return true;
+    return hdimage_read(sd->dat, (size_t)block * 256, buf, 256);
 }
 
 static bool ReadSectorPadded(scsidisc *sd, unsigned char *buf, unsigned block)
 {
     unsigned char padbuf[512];
     unsigned char *end = padbuf + sizeof(padbuf);
-    if (fseek(sd->dat_fp, block * sizeof(padbuf), SEEK_SET))
+    if (!hdimage_read(sd->dat, (size_t)block * sizeof(padbuf), padbuf, sizeof(padbuf)))
         return false;
-    if (fread(padbuf, sizeof(padbuf), 1, sd->dat_fp) != 1 && ferror(sd->dat_fp)) {
-        log_warn("scsi lun %d: read error: %s", scsi.lun, strerror(errno));
-        return false;
-    }
     for (unsigned char *ptr = padbuf; ptr < end; ptr += 2)
         *buf++ = *ptr;
     return true;
@@ -328,13 +319,7 @@ static void Read6(void)
 static bool WriteSectorSimple(scsidisc *sd, unsigned char *buf, unsigned block)
 {
     log_debug("scsi lun %d: write sector %d", scsi.lun, block);
-    if (fseek(sd->dat_fp, block * 256, SEEK_SET))
-        return false;
-    if (fwrite(buf, 256, 1, sd->dat_fp) != 1) {
-        log_warn("scsi lun %d: write error: %s", scsi.lun, strerror(errno));
-        return false;
-    }
-    return true;
+    return hdimage_write(sd->dat, (size_t)block * 256, buf, 256);
 }
 
 static bool WriteSectorPadded(scsidisc *sd, unsigned char *buf, unsigned block)
@@ -342,15 +327,9 @@ static bool WriteSectorPadded(scsidisc *sd, unsigned char *buf, unsigned block)
     unsigned char padbuf[512];
     unsigned char *end = padbuf + sizeof(padbuf);
     log_debug("scsi lun %d: write sector %d", scsi.lun, block);
-    if (fseek(sd->dat_fp, block * sizeof(padbuf), SEEK_SET))
-        return false;
     for (unsigned char *ptr = padbuf; ptr < end; ptr += 2)
         *ptr = *buf++;
-    if (fwrite(padbuf, sizeof(padbuf), 1, sd->dat_fp) != 1) {
-        log_warn("scsi lun %d: write error: %s", scsi.lun, strerror(errno));
-        return false;
-    }
-    return true;
+    return hdimage_write(sd->dat, (size_t)block * sizeof(padbuf), padbuf, sizeof(padbuf));
 }
 
 static void Write6(void)
@@ -416,10 +395,10 @@ static bool DiscStartStop(unsigned char *buf)
 {
     if (buf[4] & 0x02) {
         // Eject Disc
-        FILE *fp = SCSIDisc[scsi.lun].dat_fp;
+        hdimage_t *hd = SCSIDisc[scsi.lun].dat;
         log_debug("scsi lun %d: eject", scsi.lun);
-        if (fp)
-            fflush(fp);
+        if (hd)
+            hdimage_flush(hd);
     }
     else
         log_debug("scsi lun %d: start", scsi.lun);
@@ -789,18 +768,16 @@ void scsi_reset(void)
     BusFree();
 }
 
-static bool scsi_check_adfs(FILE *fp, unsigned off1, unsigned off2, const char *pattern, size_t len)
+static bool scsi_check_adfs(hdimage_t *hd, unsigned off1, unsigned off2, const char *pattern, size_t len)
 {
     char id1[10], id2[10];
-    if (fseek(fp, off1, SEEK_SET))
+    if (off2 + len > hdimage_size(hd))
         return false;
-    if (fread(id1, len, 1, fp) != 1)
+    if (!hdimage_read(hd, off1, id1, len))
         return false;
     if (memcmp(id1+1, pattern, len-1))
         return false;
-    if (fseek(fp, off2, SEEK_SET))
-        return false;
-    if (fread(id2, len, 1, fp) != 1)
+    if (!hdimage_read(hd, off2, id2, len))
         return false;
     if (memcmp(id1, id2, len))
         return false;
@@ -827,21 +804,23 @@ static void scsi_init_lun(scsidisc *sd, int lun)
     char name[50];
     sd->ReadSector  = ReadWriteNone;
     sd->WriteSector = ReadWriteNone;
-    sd->dat_fp = sd->dsc_fp = NULL;
+    sd->dat = NULL;
+    sd->dsc_fp = NULL;
     sd->blocks = 0;
     snprintf(name, sizeof(name), "scsi/scsi%d", lun);
     if ((path = find_cfg_file(name, ".dat"))) {
         sd->path = path;
         const char *cpath = al_path_cstr(path, ALLEGRO_NATIVE_PATH_SEP);
-        FILE *fp = fopen(cpath, "rb+");
-        if (fp) {
-            if (scsi_check_adfs(fp, 0x200, 0x6fa, "Hugo", 5))
+        hdimage_t *hd = hdimage_open(cpath, false);
+        if (hd) {
+            FILE *fp;
+            if (scsi_check_adfs(hd, 0x200, 0x6fa, "Hugo", 5))
                 scsi_select_simple(sd, lun, cpath, "detected as simple (SCSI) format");
-            else if (scsi_check_adfs(fp, 0x400, 0xdf4, "\0H\0u\0g\0o", 10))
+            else if (scsi_check_adfs(hd, 0x400, 0xdf4, "\0H\0u\0g\0o", 10))
                 scsi_select_padded(sd, lun, cpath, "detected as padded (IDE) format");
             else
                 scsi_select_simple(sd, lun, cpath, "selected as simple (SCSI) format by default");
-            sd->dat_fp = fp;
+            sd->dat = hd;
             al_set_path_extension(path, ".dsc");
             cpath = al_path_cstr(path, ALLEGRO_NATIVE_PATH_SEP);
             if ((fp = fopen(cpath, "rb+"))) {
@@ -857,9 +836,7 @@ static void scsi_init_lun(scsidisc *sd, int lun)
                 }
             }
             if (sd->blocks == 0) {
-                unsigned bytes, cyl;
-                fseek(sd->dat_fp, 0, SEEK_END);
-                bytes = ftell(sd->dat_fp);
+                unsigned bytes = hdimage_size(hd), cyl;
                 memset(sd->geom, 0, sizeof(sd->geom));
                 cyl = 1 + ((bytes - 1) / (33 * 255));
                 sd->geom[13] = cyl >> 8;
@@ -873,7 +850,7 @@ static void scsi_init_lun(scsidisc *sd, int lun)
             }
         }
         else
-            log_error("scsi lun %d: unable to open data file %s: %s", lun, cpath, strerror(errno));
+            log_error("scsi lun %d: unable to open data file %s", lun, cpath);
     }
     else
         log_warn("scsi lun %d: no disc file %s found", lun, name);
@@ -890,9 +867,9 @@ void scsi_close(void)
 {
     for (int lun = 0; lun < SCSI_DRIVES; lun++) {
         scsidisc *sd = &SCSIDisc[lun];
-        if (sd->dat_fp) {
-            fclose(sd->dat_fp);
-            sd->dat_fp = NULL;
+        if (sd->dat) {
+            hdimage_close(sd->dat);
+            sd->dat = NULL;
         }
         if (sd->dsc_fp) {
             fclose(sd->dsc_fp);
@@ -62,70 +62,190 @@ static void sn_updaterectwave(int d)
         for ( ;c < 32; c++)     snwaves[4][c] = -127;
 }
 
+/*
+ * Rather than output the level of each channel as it is at each sample,
+ * which aliases badly as the square waves have harmonics far above the
+ * sample rate, each change of level is added to the output as a
+ * band-limited step placed at the fraction of a sample at which it
+ * happened.  The steps are accumulated as impulses in sn_delta, each
+ * the windowed sinc for its position, and the output is their running
+ * sum, so a channel that does not change costs nothing.  This delays
+ * the output by half the filter length, 128us.
+ */
 
+#define SN_TAPS    32       // length of the band-limiting filter.
+#define SN_PHASES  64       // fractions of a sample a step can be placed at.
+#define SN_CUTOFF  0.18     // of the sample rate, about 22kHz.
+#define SN_CHUNK   512      // samples rendered at a time.
+#define SN_RECT    2496     // samples between changes of the rectangle wave.
 
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
-void sn_fillbuf(int16_t *buffer, int len)
+static float sn_kernel[SN_PHASES + 1][SN_TAPS];
+static float sn_delta[SN_CHUNK + SN_TAPS];
+static float sn_level[4];   // level of each channel as last output.
+static double sn_sum;       // output so far, the sum of the deltas used.
+static int sn_rect_count;
+
+static void sn_init_kernel(void)
 {
-        int c, d;
-        static int sidcount = 0;
-        uint8_t sdb_data;
+        for (int p = 0; p <= SN_PHASES; p++) {
+                double total = 0;
+                for (int i = 0; i < SN_TAPS; i++) {
+                        double x = i - SN_TAPS / 2 + 1 - (double)p / SN_PHASES;
+                        double sinc = x == 0 ? 2 * SN_CUTOFF : sin(2 * M_PI * SN_CUTOFF * x) / (M_PI * x);
+                        double window = 0.42 + 0.5 * cos(2 * M_PI * x / SN_TAPS) + 0.08 * cos(4 * M_PI * x / SN_TAPS);
+                        sn_kernel[p][i] = sinc * window;
+                        total += sn_kernel[p][i];
+                }
+                // Each step must move the output by exactly its size.
+                for (int i = 0; i < SN_TAPS; i++)
+                        sn_kernel[p][i] /= total;
+        }
+}
 
-        if (sysvia_get_sn_data(&sdb_data))
-                sn_write(sdb_data);
+// Add a step of size delta at sample pos plus frac/scale of a sample.
 
-        for (d = 0; d < len; d++)
-        {
-                for (c = 0; c < 3; c++)
-                {
-                        c++;
-                        if (sn_latch[c] > 256) buffer[d] += (int16_t) (snwaves[curwave][sn_stat[c]] * volslog[sn_vol[c]]);
-                        else                   buffer[d] += (int16_t) (volslog[sn_vol[c]] * 127);
+static inline void sn_step(int pos, int frac, int scale, float delta)
+{
+        // A count left behind by a loaded state can put frac outside
+        // the sample; such a step is placed at its start.
+        if (frac < 0)
+                frac = 0;
+        else if (frac > scale)
+                frac = scale;
+        const float *k = sn_kernel[(frac * SN_PHASES + scale / 2) / scale];
+        float *d = sn_delta + pos + 1;
+        for (int i = 0; i < SN_TAPS; i++)
+                d[i] += delta * k[i];
+}
 
-                        sn_count[c] -= 2048;
-                        while ((int)sn_count[c] < 0  && sn_latch[c])
-                        {
-                                sn_count[c] += sn_latch[c];
-                                sn_stat[c]++;
-                                sn_stat[c] &= 31;
-                        }
-                        c--;
+static float sn_amp(int c)
+{
+        float vol = volslog[sn_vol[c]];
+        if (c) {
+                if (sn_latch[c] > 256)
+                        return snwaves[curwave][sn_stat[c]] * vol;
+                return vol * 127;
+        }
+        if (!(sn_noise & 4) && curwave == 4)
+                return snwaves[4][sn_stat[0] & 31] * vol;
+        return ((sn_shift & 1) ^ 1) * 127 * vol * 2;
+}
+
+static void sn_render(int len)
+{
+        // Register writes take effect at the start of a block.
+        for (int c = 0; c < 4; c++) {
+                float amp = sn_amp(c);
+                if (amp != sn_level[c]) {
+                        sn_step(0, 0, 1, amp - sn_level[c]);
+                        sn_level[c] = amp;
                 }
-                if (!(sn_noise & 4))
-                {
-                        if (curwave == 4) buffer[d] += (snwaves[4][sn_stat[0] & 31] * volslog[sn_vol[0]]);
-                        else              buffer[d] += (((sn_shift & 1) ^ 1) * 127 * volslog[sn_vol[0]] * 2);
+        }
+
+        for (int c = 1; c < 4; c++) {
+                int count = sn_count[c];
+                int latch = sn_latch[c];
+                for (int d = 0; d < len; d++) {
+                        count -= 2048;
+                        while (count < 0 && latch) {
+                                int frac = count + 2048;
+                                count += latch;
+                                sn_stat[c] = (sn_stat[c] + 1) & 31;
+                                float amp = sn_amp(c);
+                                if (amp != sn_level[c]) {
+                                        sn_step(d, frac, 2048, amp - sn_level[c]);
+                                        sn_level[c] = amp;
+                                }
+                        }
                 }
-                else    buffer[d] += (((sn_shift & 1) ^ 1) * 127 * volslog[sn_vol[0]] * 2);
+                // A channel with no period does not run, so must not
+                // fall further behind with each sample.
+                if (!latch && count < 0)
+                        count = 0;
+                sn_count[c] = count;
+        }
 
-                sn_count[0] -= 128;
-                while ((int)sn_count[0] < 0 && sn_latch[0])
-                {
-                        sn_count[0] += (sn_latch[0] * 2);
+        int count = sn_count[0];
+        int latch = sn_latch[0];
+        for (int d = 0; d < len; d++) {
+                count -= 128;
+                while (count < 0 && latch) {
+                        int frac = count + 128;
+                        count += latch * 2;
                         if (!(sn_noise & 4))
                         {
                                 if (sn_shift & 1) sn_shift |= 0x8000;
                                 sn_shift >>= 1;
+                                if (++sn_stat[0] >= 30) sn_stat[0] -= 30;
                         }
                         else
                         {
                                 if ((sn_shift & 1) ^ ((sn_shift >> 1) & 1)) sn_shift |= 0x8000;
                                 sn_shift >>= 1;
+                                sn_stat[0] = (sn_stat[0] + 1) & 32767;
+                        }
+                        float amp = sn_amp(0);
+                        if (amp != sn_level[0]) {
+                                sn_step(d, frac, 128, amp - sn_level[0]);
+                                sn_level[0] = amp;
                         }
-                        sn_stat[0]++;
-                }
-                if (!(sn_noise & 4))
-                {
-                        while (sn_stat[0] >= 30) sn_stat[0] -= 30;
                 }
-                else
-                   sn_stat[0] &= 32767;
-//                buffer[d] += (lpt_dac * 32);
+        }
+        if (!latch && count < 0)
+                count = 0;
+        sn_count[0] = count;
+}
+
+// Add the output for the block just rendered to the buffer.
+
+static void sn_output(int16_t *buffer, int len)
+{
+        double sum = sn_sum;
+        for (int d = 0; d < len; d++) {
+                sum += sn_delta[d];
+                buffer[d] += (int16_t)sum;
+        }
+        memmove(sn_delta, sn_delta + len, SN_TAPS * sizeof(float));
+        memset(sn_delta + SN_TAPS, 0, len * sizeof(float));
+
+        // Re-derive the sum from the levels so rounding cannot build up.
+        float pending = 0;
+        for (int i = 0; i < SN_TAPS; i++)
+                pending += sn_delta[i];
+        sn_sum = sn_level[0] + sn_level[1] + sn_level[2] + sn_level[3] - pending;
+}
+
+static void sn_latch_write(uint8_t data);
+
+void sn_fillbuf(int16_t *buffer, int len)
+{
+        uint8_t sdb_data;
 
-                sidcount++;
-                if (sidcount == 2496)
+        // While the write enable is held the chip keeps latching the
+        // bus so that has to be done a sample at a time.
+        bool held = sysvia_get_sn_data(&sdb_data);
+
+        while (len > 0) {
+                int chunk = held ? 1 : len;
+                if (chunk > SN_CHUNK)
+                        chunk = SN_CHUNK;
+                if (chunk > SN_RECT - sn_rect_count)
+                        chunk = SN_RECT - sn_rect_count;
+                if (held)
+                        sn_latch_write(sdb_data);
+                sn_render(chunk);
+                sn_output(buffer, chunk);
+                buffer += chunk;
+                len -= chunk;
+
+                sn_rect_count += chunk;
+                if (sn_rect_count == SN_RECT)
                 {
-                        sidcount = 0;
+                        sn_rect_count = 0;
                         if (!sn_rect_dir)
                         {
                                 sn_rect_pos++;
@@ -161,10 +281,15 @@ void sn_init()
         sn_count[3] = (rand()&0x3FF)<<6;
         sn_noise = 3;
         sn_shift = 0x4000;
+
+        sn_init_kernel();
+        memset(sn_delta, 0, sizeof(sn_delta));
+        memset(sn_level, 0, sizeof(sn_level));
+        sn_sum = 0;
 }
 
 static uint8_t firstdat;
-void sn_write(uint8_t data)
+static void sn_latch_write(uint8_t data)
 {
         int freq;
 
@@ -233,11 +358,19 @@ void sn_write(uint8_t data)
         }
 }
 
+void sn_write(uint8_t data)
+{
+        // Output up to now is made with the registers as they were.
+        sound_sn_sync();
+        sn_latch_write(data);
+}
+
 
 
 void sn_savestate(FILE *f)
 {
     unsigned char bytes[3];
+    sound_sn_sync();
     fwrite(sn_latch, 16, 1, f);
     fwrite(sn_count, 16, 1, f);
     fwrite(sn_stat,  16, 1, f);
@@ -258,4 +391,9 @@ void sn_loadstate(FILE *f)
     fread(bytes, sizeof(bytes), 1, f);
     sn_noise = bytes[0];
     sn_shift = bytes[1] | (bytes[2] << 8);
+
+    // Steps still pending are from the sound before the load.
+    memset(sn_delta, 0, sizeof(sn_delta));
+    memset(sn_level, 0, sizeof(sn_level));
+    sn_sum = 0;
 }
@@ -3,6 +3,8 @@
 
 #include "b-em.h"
 #include <allegro5/allegro_audio.h>
+#include <stdatomic.h>
+#include "hostprof.h"
 #include "sid_b-em.h"
 #include "sn76489.h"
 #include "sound.h"
@@ -21,10 +23,34 @@ static ALLEGRO_MIXER *mixer;
 static ALLEGRO_AUDIO_STREAM *stream;
 
 static int sound_pos = 0;
-static int sound_sn_pos = 0;
+static int sound_sn_pos = 0;    // samples due from the SN76489.
+static int sound_sn_done = 0;   // samples it has rendered.
+static int sound_sid_pos = 0;   // sample pairs due from the BeebSID.
+static int sound_sid_done = 0;  // pairs it has rendered.
 
 static short sound_buffer[BUFLEN_SO];
 
+/*
+ * Finished blocks of samples are passed from the emulation thread to
+ * the audio thread through a single-producer, single-consumer ring so
+ * the emulation never waits for, or drops blocks because of, the audio
+ * stream.  The audio thread resamples from the ring, speeding up or
+ * slowing down slightly to keep it near SOUND_RING_TARGET samples full.
+ */
+
+#define SOUND_RING_LEN    131072  // must be a power of two
+#define SOUND_RING_TARGET (BUFLEN_SO * 2)
+
+static float sound_ring[SOUND_RING_LEN];
+static atomic_uint sound_ring_head;  // written only by the emulation thread
+static atomic_uint sound_ring_tail;  // written only by the audio thread
+
+static ALLEGRO_THREAD *sound_thread;
+static ALLEGRO_EVENT_QUEUE *sound_queue;
+static double sound_ring_pos;        // fractional read position, audio thread
+static double sound_ring_avg = SOUND_RING_TARGET;
+static float sound_last;
+
 static int sound_sn76489_cycles = 0, sound_poll_cycles = 0;
 
 #define NCoef 2
@@ -109,13 +135,80 @@ static void sound_rec_int(short *buf)
     }
 }
 
+static void sound_ring_put(const float *buf, unsigned len)
+{
+    unsigned head = atomic_load_explicit(&sound_ring_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&sound_ring_tail, memory_order_acquire);
+
+    if (SOUND_RING_LEN - (head - tail) < len) {
+        log_debug("sound: overrun");
+        return;
+    }
+    for (unsigned c = 0; c < len; c++)
+        sound_ring[(head + c) & (SOUND_RING_LEN - 1)] = buf[c];
+    atomic_store_explicit(&sound_ring_head, head + len, memory_order_release);
+}
+
+static void sound_ring_get(float *buf, unsigned len)
+{
+    unsigned tail = atomic_load_explicit(&sound_ring_tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&sound_ring_head, memory_order_acquire);
+    unsigned fill = head - tail;
+
+    /* Smooth the fill level as the producer adds whole blocks at once
+     * then derive the playback rate from it, clamped so that running
+     * at other than 1x speed shifts pitch rather than losing blocks.
+     */
+    sound_ring_avg += ((double)fill - sound_ring_avg) / 16;
+    double ratio = 1.0 + (sound_ring_avg - SOUND_RING_TARGET) / (2.0 * SOUND_RING_TARGET);
+    if (ratio < 0.5)
+        ratio = 0.5;
+    else if (ratio > 4.0)
+        ratio = 4.0;
+
+    double pos = sound_ring_pos;
+    for (unsigned c = 0; c < len; c++) {
+        unsigned i = (unsigned)pos;
+        if (i + 1 < fill) {
+            float s0 = sound_ring[(tail + i) & (SOUND_RING_LEN - 1)];
+            float s1 = sound_ring[(tail + i + 1) & (SOUND_RING_LEN - 1)];
+            sound_last = s0 + (s1 - s0) * (float)(pos - i);
+            pos += ratio;
+        }
+        buf[c] = sound_last;    // on underrun hold the last sample
+    }
+    unsigned used = (unsigned)pos;
+    if (used > fill) {
+        used = fill;
+        pos = 0.0;
+    }
+    else
+        pos -= used;
+    sound_ring_pos = pos;
+    atomic_store_explicit(&sound_ring_tail, tail + used, memory_order_release);
+}
+
+static void *sound_thread_proc(ALLEGRO_THREAD *thread, void *data)
+{
+    log_debug("sound: audio thread started");
+    while (!al_get_thread_should_stop(thread)) {
+        ALLEGRO_EVENT event;
+        if (al_wait_for_event_timed(sound_queue, &event, 0.1) && event.type == ALLEGRO_EVENT_AUDIO_STREAM_FRAGMENT) {
+            float *buf;
+            while ((buf = al_get_audio_stream_fragment(stream))) {
+                sound_ring_get(buf, BUFLEN_SO);
+                al_set_audio_stream_fragment(stream, buf);
+            }
+        }
+    }
+    return NULL;
+}
+
 static void sound_poll_all(void)
 {
-    if ((sound_internal || sound_beebsid) && stream) {
+    if (sound_internal || sound_beebsid) {
         int16_t temp_buffer[2] = {0};
 
-        if (sound_beebsid)
-            sid_fillbuf(temp_buffer, 2);
         if (sound_paula)
             paula_fillbuf(temp_buffer, 2);
         if (sound_dac) {
@@ -127,41 +220,84 @@ static void sound_poll_all(void)
             sound_buffer[sound_pos + c] += temp_buffer[0];
             sound_buffer[sound_pos + c + 4] += temp_buffer[1];
         }
-        // skip forward 8 mono samples
-        sound_pos += 8;
-        if (sound_pos == BUFLEN_SO) {
-            float *buf = al_get_audio_stream_fragment(stream);
-            if (buf) {
-                if (sound_filter) {
-                    for (int c = 0; c < BUFLEN_SO; c++)
-                        buf[c] = iir((float)sound_buffer[c] / 32767.0);
-                    sound_rec_float(buf);
-                } else {
-                    for (int c = 0; c < BUFLEN_SO; c++)
-                        buf[c] = (float)sound_buffer[c] / 32767.0;
-                    sound_rec_int(sound_buffer);
+    }
+    // skip forward 8 mono samples
+    sound_pos += 8;
+    sound_sid_pos++;
+    if (sound_pos == BUFLEN_SO) {
+        static float buf[BUFLEN_SO];
+        sound_sn_sync();
+        sound_sid_sync();
+        if (sound_filter) {
+            for (int c = 0; c < BUFLEN_SO; c++)
+                buf[c] = iir((float)sound_buffer[c] / 32767.0);
+            sound_rec_float(buf);
+        } else {
+            for (int c = 0; c < BUFLEN_SO; c++)
+                buf[c] = (float)sound_buffer[c] / 32767.0;
+            sound_rec_int(sound_buffer);
+        }
+        // with no audio thread, e.g. when headless, the block is discarded.
+        if (sound_thread)
+            sound_ring_put(buf, BUFLEN_SO);
+        sound_pos = 0;
+        sound_sn_pos = 0;
+        sound_sn_done = 0;
+        sound_sid_pos = 0;
+        sound_sid_done = 0;
+        memset(sound_buffer, 0, sizeof(sound_buffer));
+    }
+}
+
+/*
+ * The SN76489 is owed a sample every 16 cycles but only renders them,
+ * as a block, when one of its registers or the bus it latches them
+ * from is about to change, or when the buffer is complete.
+ */
+
+void sound_sn_sync(void)
+{
+    if (sound_sn_pos > sound_sn_done) {
+        if (sound_internal)
+            sn_fillbuf(&sound_buffer[sound_sn_done], sound_sn_pos - sound_sn_done);
+        sound_sn_done = sound_sn_pos;
+    }
+}
+
+/*
+ * Likewise the BeebSID, which is owed two samples at its own rate for
+ * each eight here, is clocked a block at a time when the 6502 is about
+ * to read or write one of its registers, so reSID and its resampler run
+ * over thousands of cycles at once rather than 64 at a time.
+ */
+
+void sound_sid_sync(void)
+{
+    static int16_t sid_buffer[BUFLEN_SO / 4];
+
+    if (sound_sid_pos > sound_sid_done) {
+        if (sound_beebsid) {
+            int pairs = sound_sid_pos - sound_sid_done;
+            short *dest = &sound_buffer[sound_sid_done * 8];
+            HOSTPROF(HOSTPROF_SID, sid_fillbuf(sid_buffer, pairs * 2));
+            for (int i = 0; i < pairs; i++, dest += 8) {
+                int16_t s0 = sid_buffer[i * 2], s1 = sid_buffer[i * 2 + 1];
+                for (int c = 0; c < 8/2; c++) {
+                    dest[c] += s0;
+                    dest[c + 4] += s1;
                 }
-                al_set_audio_stream_fragment(stream, buf);
-                al_set_audio_stream_playing(stream, true);
-            } else
-                log_debug("sound: overrun");
-            sound_pos = 0;
-            sound_sn_pos = 0;
-            memset(sound_buffer, 0, sizeof(sound_buffer));
+            }
         }
+        sound_sid_done = sound_sid_pos;
     }
 }
 
 void sound_poll(int cycles)
 {
     sound_sn76489_cycles -= cycles;
-    if (sound_sn76489_cycles < 0)
+    while (sound_sn76489_cycles < 0)
     {
         sound_sn76489_cycles += 16;
-
-        if (sound_internal)
-            sn_fillbuf(&sound_buffer[sound_sn_pos], 1);
-
         sound_sn_pos++;
 
         sound_poll_cycles -= 16;
@@ -173,6 +309,18 @@ void sound_poll(int cycles)
     }
 }
 
+void sound_reset_timing(void)
+{
+    sound_sn76489_cycles = sound_poll_cycles = 0;
+}
+
+// Only the other sources, mixed every eight samples, need a poll.
+
+int sound_next_poll(void)
+{
+    return sound_sn76489_cycles + 1 + (sound_poll_cycles / 16) * 16;
+}
+
 static ALLEGRO_VOICE *sound_create_voice(void)
 {
     ALLEGRO_VOICE *voice;
@@ -204,13 +352,31 @@ static ALLEGRO_VOICE *sound_create_voice(void)
     return NULL;
 }
 
+static void sound_start_thread(void)
+{
+    if ((sound_queue = al_create_event_queue())) {
+        al_register_event_source(sound_queue, al_get_audio_stream_event_source(stream));
+        if ((sound_thread = al_create_thread(sound_thread_proc, NULL))) {
+            al_start_thread(sound_thread);
+            return;
+        }
+        log_error("sound: unable to create audio thread");
+        al_destroy_event_queue(sound_queue);
+        sound_queue = NULL;
+    }
+    else
+        log_error("sound: unable to create event queue for audio thread");
+}
+
 void sound_init(void)
 {
     if ((voice = sound_create_voice())) {
         if ((mixer = al_create_mixer(FREQ_SO, ALLEGRO_AUDIO_DEPTH_FLOAT32, ALLEGRO_CHANNEL_CONF_1))) {
             if (al_attach_mixer_to_voice(mixer, voice)) {
                 if ((stream = al_create_audio_stream(4, BUFLEN_SO, FREQ_SO, ALLEGRO_AUDIO_DEPTH_FLOAT32, ALLEGRO_CHANNEL_CONF_1))) {
-                    if (!al_attach_audio_stream_to_mixer(stream, mixer))
+                    if (al_attach_audio_stream_to_mixer(stream, mixer))
+                        sound_start_thread();
+                    else
                         log_error("sound: unable to attach stream to mixer for internal/SID/DAC sound");
                 } else
                     log_error("sound: unable to create stream for internal/SID/DAC sound");
@@ -312,6 +478,12 @@ void sound_close(void)
 {
     if (sound_rec.fp)
         sound_stop_rec(&sound_rec);
+    if (sound_thread) {
+        al_destroy_thread(sound_thread);
+        sound_thread = NULL;
+    }
+    if (sound_queue)
+        al_destroy_event_queue(sound_queue);
     if (stream)
         al_destroy_audio_stream(stream);
     if (mixer)
@@ -22,6 +22,10 @@ extern bool sound_music5000, sound_filter, sound_paula;
 
 void sound_init(void);
 void sound_poll(int cycles);
+int  sound_next_poll(void);
+void sound_reset_timing(void);
+void sound_sn_sync(void);
+void sound_sid_sync(void);
 
 typedef struct {
     FILE *fp;
@@ -10,6 +10,7 @@
 #include "via.h"
 #include "sysvia.h"
 #include "sn76489.h"
+#include "sound.h"
 #include "video.h"
 
 VIA sysvia;
@@ -74,6 +75,10 @@ int kbdips;
   only) and the CMOS RAM (Master 128 only)*/
 static void sysvia_update_sdb()
 {
+        /*While its write enable is low the SN76489 follows the bus so must
+          catch up before it changes*/
+        if (!(IC32 & 1))
+                sound_sn_sync();
         sdbval = sysvia_sdb_out;
         if (MASTER && !compactcmos) sdbval &= cmos_read();
 
@@ -86,6 +91,9 @@ static void sysvia_write_IC32(uint8_t val)
 {
     uint8_t oldIC32 = IC32;
 
+        if (!(IC32 & 1) || !(val & 0x0f))
+                sound_sn_sync();
+
         if (val & 8)
            IC32 |=  (1 << (val & 7));
         else
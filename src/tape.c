@@ -1,31 +1,499 @@
+/*B-em tape engine
+  UEF and CSW files are decoded as they are loaded into one timeline of
+  items: runs of high tone, gaps, data bytes, baud rate changes and, for
+  CSW, the raw pulses, which are turned into bytes as the tape plays.
+  The tape moves on one tick each poll, a byte time at the current baud
+  rate.  The blocks on the tape are found by playing a copy of the tape
+  position through once, when a catalogue or a seek first needs them,
+  and remembering where each one's leading tone starts.*/
+
 #include "b-em.h"
 #include "led.h"
 #include "tape.h"
 #include "serial.h"
+#include "sysacia.h"
 #include "tapenoise.h"
 #include "uef.h"
 #include "csw.h"
 
+#define TAPE_LATCH_1200 ((1000000 / (1200 / 10)) / 64)
+#define TAPE_SETTLE     120     // ticks into a file before "previous" restarts it.
+#define CSW_SHORT       0x0d    // longest pulse, in samples, of a 2400Hz cycle.
+
 int tapelcount,tapellatch,tapeledcount;
 
 bool tape_loaded = false;
 bool fasttape = false;
 ALLEGRO_PATH *tape_fn = NULL;
 
+typedef enum {
+    TAPE_TONE,      // count ticks of high tone.
+    TAPE_GAP,       // count ticks of silence.
+    TAPE_DATA,      // count ticks, a byte from the pool in each.
+    TAPE_BAUD,      // one tick, arg is the new poll interval.
+    TAPE_PULSES     // count CSW pulses in the pool, up to ten a tick.
+} tape_kind_t;
+
+typedef struct {
+    uint8_t  kind;
+    uint8_t  flags;
+    uint32_t count;
+    uint32_t arg;       // offset into the pool, or the poll interval.
+} tape_item_t;
+
+typedef struct {
+    uint32_t item;      // item being played.
+    uint32_t off;       // ticks or pulses into it.
+    uint32_t tick;      // ticks since the start of the tape.
+    int      latch;     // poll interval at this point.
+    int      toneon;    // 2 in a tone, one less for each byte since.
+    int8_t   intone;    // CSW pulse decoder.
+    int8_t   indat;
+    int8_t   datbits;
+    uint8_t  enddat;
+    int      skip;
+} tape_pos_t;
+
+typedef struct {
+    int  dcd;           // 1 raised, -1 dropped, 0 unchanged.
+    int  byte;          // byte received, or -1.
+    bool wrapped;       // the tape ran out and started again.
+} tape_event_t;
+
+typedef struct {
+    tape_pos_t start;   // just before the tone that leads the block.
+    char     name[11];
+    uint32_t load;
+    uint32_t exec;
+    uint16_t num;
+    uint16_t len;
+    uint8_t  flags;
+} tape_block_t;
+
+static tape_item_t  *tape_items;
+static size_t        tape_nitems, tape_sitems;
+static uint8_t      *tape_pool;
+static size_t        tape_npool, tape_spool;
+static tape_block_t *tape_blocks;
+static size_t        tape_nblocks, tape_sblocks;
+static bool          tape_indexed;
+static tape_pos_t    tape_pos;
+static int           tape_hold;
+
 static struct
 {
         char *ext;
-        void (*load)(const char *fn);
-        void (*close)();
+        bool (*load)(const char *fn);
 }
 loaders[]=
 {
-        {"UEF", uef_load, uef_close},
-        {"CSW", csw_load, csw_close},
-        {0,0,0}
+        {"UEF", uef_load},
+        {"CSW", csw_load},
+        {0,0}
 };
 
-static int tape_loader;
+static void *tape_grow(void *ptr, size_t *size, size_t need, size_t elem)
+{
+    size_t nsize = *size ? *size : 256;
+    while (nsize < need)
+        nsize *= 2;
+    if (nsize > UINT32_MAX || !(ptr = realloc(ptr, nsize * elem))) {
+        log_error("tape: out of memory");
+        return NULL;
+    }
+    *size = nsize;
+    return ptr;
+}
+
+static bool tape_add_item(tape_kind_t kind, unsigned flags, uint32_t count, uint32_t arg)
+{
+    if (tape_nitems >= tape_sitems) {
+        tape_item_t *items = tape_grow(tape_items, &tape_sitems, tape_nitems + 1, sizeof(tape_item_t));
+        if (!items)
+            return false;
+        tape_items = items;
+    }
+    tape_item_t *it = tape_items + tape_nitems++;
+    it->kind = kind;
+    it->flags = flags;
+    it->count = count;
+    it->arg = arg;
+    return true;
+}
+
+static bool tape_add_pool(const uint8_t *data, uint32_t len)
+{
+    if (tape_npool + len > tape_spool) {
+        uint8_t *pool = tape_grow(tape_pool, &tape_spool, tape_npool + len, 1);
+        if (!pool)
+            return false;
+        tape_pool = pool;
+    }
+    memcpy(tape_pool + tape_npool, data, len);
+    tape_npool += len;
+    return true;
+}
+
+bool tape_add_tone(uint32_t ticks, bool dcd)
+{
+    return tape_add_item(TAPE_TONE, dcd ? TAPE_DCD : 0, ticks, 0);
+}
+
+bool tape_add_gap(uint32_t ticks)
+{
+    return tape_add_item(TAPE_GAP, 0, ticks, 0);
+}
+
+bool tape_add_data(const uint8_t *data, uint32_t len, unsigned flags)
+{
+    uint32_t arg = tape_npool;
+    uint32_t ticks = (flags & TAPE_LEAD) ? len + 1 : len;
+    if (!ticks)
+        return true;
+    return tape_add_pool(data, len) && tape_add_item(TAPE_DATA, flags, ticks, arg);
+}
+
+bool tape_add_baud(int latch)
+{
+    return tape_add_item(TAPE_BAUD, 0, 1, latch);
+}
+
+/*
+ * A CSW tape is one run of pulses, extended as more are decoded.
+ */
+
+bool tape_add_pulses(const uint8_t *pulses, uint32_t len)
+{
+    if (!len)
+        return true;
+    if (tape_nitems) {
+        tape_item_t *it = tape_items + tape_nitems - 1;
+        if (it->kind == TAPE_PULSES && it->arg + it->count == tape_npool) {
+            if (!tape_add_pool(pulses, len))
+                return false;
+            it->count += len;
+            return true;
+        }
+    }
+    uint32_t arg = tape_npool;
+    return tape_add_pool(pulses, len) && tape_add_item(TAPE_PULSES, 0, len, arg);
+}
+
+static void tape_clear(void)
+{
+    if (tape_items) {
+        free(tape_items);
+        tape_items = NULL;
+    }
+    if (tape_pool) {
+        free(tape_pool);
+        tape_pool = NULL;
+    }
+    if (tape_blocks) {
+        free(tape_blocks);
+        tape_blocks = NULL;
+    }
+    tape_nitems = tape_sitems = 0;
+    tape_npool = tape_spool = 0;
+    tape_nblocks = tape_sblocks = 0;
+    tape_indexed = false;
+}
+
+static void tape_start(tape_pos_t *pos)
+{
+    memset(pos, 0, sizeof(*pos));
+    pos->latch = TAPE_LATCH_1200;
+    pos->toneon = 2;
+    pos->intone = 1;
+}
+
+static void tape_next(tape_pos_t *pos, tape_event_t *ev)
+{
+    pos->off = 0;
+    if (++pos->item >= tape_nitems) {
+        pos->item = 0;
+        pos->tick = 0;
+        ev->wrapped = true;
+    }
+}
+
+static int tape_pulse(tape_pos_t *pos, tape_event_t *ev)
+{
+    const tape_item_t *it = tape_items + pos->item;
+    if (pos->off >= it->count) {
+        pos->off = 0;
+        pos->tick = 0;
+        ev->wrapped = true;
+    }
+    return tape_pool[it->arg + pos->off++];
+}
+
+/*
+ * Decode up to ten CSW pulses.  Each bit is a cycle at 1200Hz for a
+ * zero or two at 2400Hz for a one, so once the first half of a cycle
+ * has been measured the rest of it is skipped, and at 300 baud the
+ * further cycles that make up each bit are skipped too.
+ */
+
+static void tape_csw_step(tape_pos_t *pos, tape_event_t *ev, bool slow)
+{
+    for (int c = 0; c < 10; c++) {
+        int dat = tape_pulse(pos, ev);
+        if (pos->skip)
+            pos->skip--;
+        else if (pos->intone && dat > CSW_SHORT) { /*Not in tone any more - data start bit*/
+            pos->off++;
+            if (slow) pos->skip = 6;
+            pos->intone = 0;
+            pos->indat = 1;
+            pos->datbits = pos->enddat = 0;
+            ev->dcd = -1;
+            return;
+        }
+        else if (pos->indat && pos->datbits != -1 && pos->datbits != -2) {
+            pos->off++;
+            if (slow) pos->skip = 6;
+            pos->enddat >>= 1;
+            if (dat <= CSW_SHORT) {
+                pos->off += 2;
+                if (slow) pos->skip += 6;
+                pos->enddat |= 0x80;
+            }
+            if (++pos->datbits == 8) {
+                ev->byte = pos->enddat;
+                pos->toneon--;
+                pos->datbits = -2;
+                return;
+            }
+        }
+        else if (pos->indat && pos->datbits == -2) { /*Deal with stop bit*/
+            pos->off++;
+            if (slow) pos->skip = 6;
+            if (dat <= CSW_SHORT) {
+                pos->off += 2;
+                if (slow) pos->skip += 6;
+            }
+            pos->datbits = -1;
+        }
+        else if (pos->indat && pos->datbits == -1) {
+            if (dat <= CSW_SHORT) { /*Back in tone again*/
+                ev->dcd = 1;
+                pos->toneon = 2;
+                pos->indat = 0;
+                pos->intone = 1;
+                pos->datbits = 0;
+                return;
+            }
+            pos->off++; /*Start bit*/
+            if (slow) pos->skip += 6;
+            pos->datbits = 0;
+            pos->enddat = 0;
+        }
+    }
+}
+
+static void tape_step(tape_pos_t *pos, tape_event_t *ev, bool slow)
+{
+    ev->dcd = 0;
+    ev->byte = -1;
+    ev->wrapped = false;
+    if (!tape_nitems)
+        return;
+    const tape_item_t *it = tape_items + pos->item;
+    pos->tick++;
+    switch (it->kind) {
+        case TAPE_TONE:
+            pos->toneon = 2;
+            if (!pos->off && (it->flags & TAPE_DCD))
+                ev->dcd = 1;
+            break;
+        case TAPE_GAP:
+            pos->toneon = 0;
+            break;
+        case TAPE_DATA:
+            if (!pos->off && (it->flags & TAPE_DCD))
+                ev->dcd = -1;
+            if (it->flags & TAPE_INTONE)
+                pos->toneon = 2;
+            if (!(it->flags & TAPE_LEAD))
+                ev->byte = tape_pool[it->arg + pos->off];
+            else if (pos->off)
+                ev->byte = tape_pool[it->arg + pos->off - 1];
+            if (ev->byte >= 0)
+                pos->toneon--;
+            break;
+        case TAPE_BAUD:
+            pos->latch = it->arg;
+            break;
+        case TAPE_PULSES:
+            tape_csw_step(pos, ev, slow);
+            return;
+    }
+    if (++pos->off >= it->count)
+        tape_next(pos, ev);
+}
+
+static void tape_seek(const tape_pos_t *pos)
+{
+    tape_pos = *pos;
+    tapellatch = pos->latch;
+    tapelcount = 0;
+    tape_hold = 0;
+    if (tape_nitems && tape_items[pos->item].kind == TAPE_PULSES && pos->intone)
+        acia_dcdhigh(&sysacia);
+}
+
+static bool tape_add_block(const tape_pos_t *start, const uint8_t *hdr, int nlen)
+{
+    if (tape_nblocks >= tape_sblocks) {
+        tape_block_t *blocks = tape_grow(tape_blocks, &tape_sblocks, tape_nblocks + 1, sizeof(tape_block_t));
+        if (!blocks)
+            return false;
+        tape_blocks = blocks;
+    }
+    tape_block_t *blk = tape_blocks + tape_nblocks++;
+    const uint8_t *p = hdr + nlen;
+    blk->start = *start;
+    memcpy(blk->name, hdr, nlen);
+    blk->name[hdr[nlen - 1] ? nlen : nlen - 1] = 0;
+    blk->load = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    blk->exec = p[4] | (p[5] << 8) | (p[6] << 16) | ((uint32_t)p[7] << 24);
+    blk->num = p[8] | (p[9] << 8);
+    blk->len = p[10] | (p[11] << 8);
+    blk->flags = p[12];
+    return true;
+}
+
+/*
+ * A block starts with a &2A sync byte straight after the tone, then
+ * the filename ended by a zero, the load and execution addresses, the
+ * block number, length and flags.
+ */
+
+static bool tape_index(void)
+{
+    tape_pos_t pos, prev, lead;
+    tape_event_t ev;
+    uint8_t hdr[11 + 13];
+    int hlen = -1, nlen = 0;
+
+    if (tape_indexed)
+        return true;
+    tape_nblocks = 0;
+    if (!tape_nitems)
+        return tape_indexed = true;
+    tape_start(&pos);
+    lead = pos;
+    do {
+        prev = pos;
+        tape_step(&pos, &ev, false);
+        if (ev.dcd > 0) {
+            lead = prev;
+            hlen = -1;
+        }
+        if (ev.byte < 0)
+            continue;
+        if (ev.byte == 0x2a && pos.toneon == 1) {
+            hlen = 0;
+            nlen = 0;
+        }
+        else if (hlen >= 0) {
+            hdr[hlen++] = ev.byte;
+            if (!nlen) {
+                if (!ev.byte || hlen == 11)
+                    nlen = hlen;
+            }
+            else if (hlen == nlen + 13) {
+                if (!tape_add_block(&lead, hdr, nlen))
+                    return false;
+                hlen = -1;
+            }
+        }
+    } while (!ev.wrapped);
+    log_debug("tape: %zu blocks found", tape_nblocks);
+    return tape_indexed = true;
+}
+
+/*
+ * The last block that starts at or before a tick.
+ */
+
+static int tape_find_block(uint32_t tick)
+{
+    size_t lo = 0, hi = tape_nblocks;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (tape_blocks[mid].start.tick <= tick)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return (int)lo - 1;
+}
+
+void tape_cat(void)
+{
+    char s[64];
+    uint32_t size = 0;
+    int first = 0;
+
+    if (!tape_loaded || !tape_index())
+        return;
+    int cur = tape_find_block(tape_pos.tick);
+    for (int b = 0; b < tape_nblocks; b++) {
+        const tape_block_t *blk = tape_blocks + b;
+        if (!blk->num) {
+            first = b;
+            size = 0;
+        }
+        size += blk->len;
+        if (blk->flags & 0x80) {
+            snprintf(s, sizeof(s), "%c %-12s Size %04X Load %08X Run %08X", (cur >= first && cur <= b) ? '>' : ' ', blk->name, size, blk->load, blk->exec);
+            cataddname(s);
+        }
+    }
+}
+
+void tape_rewind(void)
+{
+    tape_pos_t pos;
+    tape_start(&pos);
+    tape_seek(&pos);
+}
+
+/*
+ * Wind on to the next file, or back to the start of the one the tape
+ * is in or, if it has only just started, to the one before.
+ */
+
+void tape_seek_file(int dir)
+{
+    if (!tape_loaded || !tape_index() || !tape_nblocks)
+        return;
+    int cur = tape_find_block(tape_pos.tick);
+    int f = cur;
+    if (dir > 0) {
+        for (f = cur + 1; f < tape_nblocks && tape_blocks[f].num; f++)
+            ;
+        if (f >= tape_nblocks)
+            return;
+    }
+    else {
+        while (f > 0 && tape_blocks[f].num)
+            f--;
+        if (f >= 0 && tape_pos.tick < tape_blocks[f].start.tick + TAPE_SETTLE)
+            for (f--; f > 0 && tape_blocks[f].num; f--)
+                ;
+    }
+    if (f < 0) {
+        log_debug("tape: wound to start");
+        tape_rewind();
+    }
+    else {
+        log_debug("tape: wound to %s block %d", tape_blocks[f].name, tape_blocks[f].num);
+        tape_seek(&tape_blocks[f].start);
+    }
+}
 
 void tape_load(ALLEGRO_PATH *fn)
 {
@@ -43,8 +511,12 @@ void tape_load(ALLEGRO_PATH *fn)
         {
                 if (!strcasecmp(p, loaders[c].ext))
                 {
-                        tape_loader = c;
-                        loaders[c].load(cpath);
+                        tape_clear();
+                        tape_loaded = loaders[c].load(cpath);
+                        if (tape_loaded)
+                            tape_rewind();
+                        else
+                            tape_clear();
                         return;
                 }
                 c++;
@@ -54,8 +526,7 @@ void tape_load(ALLEGRO_PATH *fn)
 
 void tape_close()
 {
-        if (tape_loaded && tape_loader < 2)
-           loaders[tape_loader].close();
+        tape_clear();
         tape_loaded = 0;
 }
 
@@ -64,18 +535,41 @@ void tape_close()
 
 static uint16_t newdat;
 
-void tape_poll(void) {
+/*
+ * Returns the number of 128 clock periods until the next poll.  With
+ * fast tape the tape is polled every period and each byte is given to
+ * the ACIA as soon as the last has been read, or after a normal byte
+ * time if it is not read at all.
+ */
+
+int tape_poll(void) {
     if (motor) {
-        if (csw_ena) csw_poll();
-        else         uef_poll();
+        tape_pos_t next = tape_pos;
+        tape_event_t ev;
+        tape_step(&next, &ev, sysacia_tapespeed);
+        if (fasttape && ev.byte >= 0 && acia_rx_full(&sysacia) && ++tape_hold < tapellatch)
+            return 1;
+        tape_hold = 0;
+        tape_pos = next;
+        tapellatch = next.latch;
+        if (ev.dcd > 0)
+            acia_dcdhigh(&sysacia);
+        else if (ev.dcd < 0)
+            acia_dcdlow(&sysacia);
+        if (ev.byte >= 0)
+            acia_receive(&sysacia, ev.byte);
 
         if (newdat & 0x100) {
             newdat&=0xFF;
-            tapenoise_adddat(newdat);
+            if (!fasttape)
+                tapenoise_adddat(newdat);
         }
-        else if (csw_toneon || uef_toneon)
+        else if (tape_pos.toneon && !fasttape)
             tapenoise_addhigh();
+        if (fasttape)
+            return 1;
     }
+    return tapellatch;
 }
 
 void tape_receive(ACIA *acia, uint8_t data) {
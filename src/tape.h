@@ -3,13 +3,26 @@
 
 #include "acia.h"
 
+#define TAPE_DCD    0x01    // a tone raises DCD, data drops it.
+#define TAPE_LEAD   0x02    // data starts with a tick without a byte.
+#define TAPE_INTONE 0x04    // data bytes are sent within a tone.
+
 extern ALLEGRO_PATH *tape_fn;
 extern bool tape_loaded;
 
 void tape_load(ALLEGRO_PATH *fn);
 void tape_close(void);
-void tape_poll(void);
+int tape_poll(void);
 void tape_receive(ACIA *acia, uint8_t data);
+void tape_rewind(void);
+void tape_seek_file(int dir);
+void tape_cat(void);
+
+bool tape_add_tone(uint32_t ticks, bool dcd);
+bool tape_add_gap(uint32_t ticks);
+bool tape_add_data(const uint8_t *data, uint32_t len, unsigned flags);
+bool tape_add_baud(int latch);
+bool tape_add_pulses(const uint8_t *pulses, uint32_t len);
 
 extern int tapelcount,tapellatch,tapeledcount;
 extern bool fasttape;
@@ -2,9 +2,12 @@
   Tube ULA emulation*/
 
 #include <stdio.h>
+#include <stdatomic.h>
 #include "b-em.h"
 #include "6502.h"
+#include "debugger.h"
 #include "model.h"
+#include "movie.h"
 #include "tube.h"
 
 #include "NS32016/32016.h"
@@ -56,6 +59,29 @@ int tube_irq=0;
 tubetype tube_type=TUBEX86;
 tube_ula tubeula;
 
+/*
+ * Optionally the parasite CPU runs on its own host thread.  The host
+ * hands it cycles as credit and it runs until that is used up, so it
+ * never gets ahead of the host.  Whenever the host touches the tube
+ * ULA it first waits for the parasite to use all its credit and then
+ * keeps the parasite parked while it does so.  Between those points
+ * the host may run ahead by up to TUBE_MAX_SKEW of its own cycles.
+ */
+
+#define TUBE_SLICE     256   // host cycles between handing over credit
+#define TUBE_MAX_SKEW 4096   // host cycles before waiting for the parasite
+
+bool tube_threaded = false;
+
+static ALLEGRO_THREAD *tube_thread;
+static ALLEGRO_MUTEX *tube_mutex;
+static ALLEGRO_COND *tube_run_cond;
+static ALLEGRO_COND *tube_done_cond;
+static atomic_int tube_credit;
+static atomic_bool tube_idle;
+static atomic_bool tube_hirq;
+static int tube_pending, tube_slice, tube_max_skew;
+
 static void tube_reset_most(void)
 {
     tubeula.ph1count = tubeula.ph1head = tubeula.ph1tail = 0;
@@ -73,14 +99,25 @@ void tube_reset(void)
     tubeula.r1stat = 0;
 }
 
-void tube_updateints()
+/*
+ * When the parasite is on its own thread and it is the one changing
+ * the ULA state the host IRQ is passed back via tube_hirq for the host
+ * to pick up in tube_run() rather than touching the host's interrupt
+ * flags directly.
+ */
+
+static void tube_update_irqs(bool host)
 {
     int new_irq = 0;
+    bool hirq = (tubeula.r1stat & TUBE_STAT_Q) && (tubeula.hstat[3] & TUBE_DATA_AVAIL);
 
-    interrupt &= ~8;
-
-    if ((tubeula.r1stat & TUBE_STAT_Q) && (tubeula.hstat[3] & TUBE_DATA_AVAIL))
-        interrupt |= 8;
+    atomic_store_explicit(&tube_hirq, hirq, memory_order_relaxed);
+    if (host) {
+        if (hirq)
+            interrupt |= 8;
+        else
+            interrupt &= ~8;
+    }
 
     if (((tubeula.r1stat & TUBE_STAT_I) && (tubeula.pstat[0] & TUBE_DATA_AVAIL)) || ((tubeula.r1stat & TUBE_STAT_J) && (tubeula.pstat[3] & TUBE_DATA_AVAIL))) {
         new_irq |= 1;
@@ -127,10 +164,142 @@ void tube_updateints()
     tube_irq = new_irq;
 }
 
-uint8_t tube_host_read(uint16_t addr)
+void tube_updateints()
+{
+    tube_update_irqs(true);
+}
+
+static void *tube_thread_proc(ALLEGRO_THREAD *thread, void *data)
+{
+    log_debug("tube: parasite thread started");
+    al_lock_mutex(tube_mutex);
+    while (!al_get_thread_should_stop(thread)) {
+        int credit = atomic_exchange(&tube_credit, 0);
+        if (credit > 0) {
+            tubecycles += credit;
+            tube_exec();
+        }
+        else {
+            al_broadcast_cond(tube_done_cond);
+            atomic_store(&tube_idle, true);
+            al_wait_cond(tube_run_cond, tube_mutex);
+            atomic_store(&tube_idle, false);
+        }
+    }
+    al_broadcast_cond(tube_done_cond);
+    al_unlock_mutex(tube_mutex);
+    log_debug("tube: parasite thread finished");
+    return NULL;
+}
+
+static bool tube_thread_start(void)
+{
+    if (!tube_mutex) {
+        if (!(tube_mutex = al_create_mutex()) || !(tube_run_cond = al_create_cond()) || !(tube_done_cond = al_create_cond())) {
+            log_error("tube: unable to create synchronisation objects for parasite thread");
+            return false;
+        }
+    }
+    atomic_store(&tube_credit, 0);
+    atomic_store(&tube_idle, false);
+    tube_pending = 0;
+    if ((tube_thread = al_create_thread(tube_thread_proc, NULL))) {
+        al_start_thread(tube_thread);
+        return true;
+    }
+    log_error("tube: unable to create parasite thread");
+    return false;
+}
+
+void tube_thread_stop(void)
+{
+    if (tube_thread) {
+        al_set_thread_should_stop(tube_thread);
+        al_lock_mutex(tube_mutex);
+        al_broadcast_cond(tube_run_cond);
+        al_unlock_mutex(tube_mutex);
+        al_join_thread(tube_thread, NULL);
+        al_destroy_thread(tube_thread);
+        tube_thread = NULL;
+        /* anything not yet run is picked up by the next inline run */
+        tubecycles += atomic_exchange(&tube_credit, 0) + tube_pending;
+        tube_pending = 0;
+        tube_update_irqs(true);
+    }
+}
+
+/* Wait for the parasite to catch up with the host and return with it
+ * parked, i.e. with tube_mutex held.
+ */
+static void tube_thread_sync(void)
+{
+    atomic_fetch_add(&tube_credit, tube_pending);
+    tube_pending = 0;
+    al_lock_mutex(tube_mutex);
+    while (atomic_load(&tube_credit) > 0) {
+        al_broadcast_cond(tube_run_cond);
+        al_wait_cond(tube_done_cond, tube_mutex);
+    }
+}
+
+/* Hold the parasite still, caught up with the host, so its state can be
+ * saved without the cost of stopping and restarting the thread.
+ */
+void tube_thread_park(void)
+{
+    if (tube_thread)
+        tube_thread_sync();
+}
+
+void tube_thread_unpark(void)
+{
+    if (tube_thread)
+        al_unlock_mutex(tube_mutex);
+}
+
+void tube_run(int cycles)
+{
+    // Movies need the parasite to run in step with the host.
+    if (tube_threaded && !debug_tube && movie_mode == MOVIE_OFF) {
+        if (!tube_thread && !tube_thread_start()) {
+            tube_threaded = false;
+            tubecycles += cycles;
+            tube_exec();
+            return;
+        }
+        tube_pending += cycles;
+        if (tube_pending >= tube_slice) {
+            int credit = atomic_fetch_add(&tube_credit, tube_pending) + tube_pending;
+            tube_pending = 0;
+            if (credit > tube_max_skew) {
+                tube_thread_sync();
+                al_unlock_mutex(tube_mutex);
+            }
+            else if (atomic_load(&tube_idle)) {
+                /* with the mutex held the parasite is either running or
+                   waiting, so the wakeup cannot fall between it setting
+                   tube_idle and starting to wait */
+                al_lock_mutex(tube_mutex);
+                al_broadcast_cond(tube_run_cond);
+                al_unlock_mutex(tube_mutex);
+            }
+        }
+        if (atomic_load_explicit(&tube_hirq, memory_order_relaxed))
+            interrupt |= 8;
+        else
+            interrupt &= ~8;
+    }
+    else {
+        if (tube_thread)
+            tube_thread_stop();
+        tubecycles += cycles;
+        tube_exec();
+    }
+}
+
+static uint8_t tube_ula_host_read(uint16_t addr)
 {
         uint8_t temp = 0;
-        if (!tube_exec) return 0xFE;
         switch (addr & 7)
         {
             case 0: /*Reg 1 Stat*/
@@ -193,9 +362,8 @@ uint8_t tube_host_read(uint16_t addr)
         return temp;
 }
 
-void tube_host_write(uint16_t addr, uint8_t val)
+static void tube_ula_host_write(uint16_t addr, uint8_t val)
 {
-        if (!tube_exec) return;
         tubeula.hpl = val;
 
         switch (addr & 7)
@@ -249,6 +417,31 @@ void tube_host_write(uint16_t addr, uint8_t val)
         tube_updateints();
 }
 
+uint8_t tube_host_read(uint16_t addr)
+{
+    if (!tube_exec)
+        return 0xFE;
+    if (!tube_thread)
+        return tube_ula_host_read(addr);
+    tube_thread_sync();
+    uint8_t val = tube_ula_host_read(addr);
+    al_unlock_mutex(tube_mutex);
+    return val;
+}
+
+void tube_host_write(uint16_t addr, uint8_t val)
+{
+    if (!tube_exec)
+        return;
+    if (!tube_thread)
+        tube_ula_host_write(addr, val);
+    else {
+        tube_thread_sync();
+        tube_ula_host_write(addr, val);
+        al_unlock_mutex(tube_mutex);
+    }
+}
+
 uint8_t tube_parasite_read(uint32_t addr)
 {
         uint8_t temp = 0;
@@ -302,7 +495,7 @@ uint8_t tube_parasite_read(uint32_t addr)
                 tubeula.hstat[3] |=  TUBE_SPACE_AVAIL;
                 break;
         }
-        tube_updateints();
+        tube_update_irqs(!tube_thread);
         return temp;
 }
 
@@ -350,12 +543,14 @@ void tube_parasite_write(uint32_t addr, uint8_t val)
                 tubeula.pstat[3] &= ~TUBE_SPACE_AVAIL;
                 break;
         }
-        tube_updateints();
+        tube_update_irqs(!tube_thread);
 }
 
 void tube_updatespeed()
 {
     tube_multiplier = (double)(tube_speeds[tube_speed_num].multipler) * tubes[curtube].speed_multiplier / 2.0;
+    tube_slice = TUBE_SLICE * tube_multiplier;
+    tube_max_skew = TUBE_MAX_SKEW * tube_multiplier;
 }
 
 bool tube_32016_init(void *rom)
@@ -72,9 +72,14 @@ uint8_t tube_parasite_read(uint32_t addr);
 void    tube_parasite_write(uint32_t addr, uint8_t val);
 
 extern int tube_irq;
+extern bool tube_threaded;
 
 void tube_reset(void);
 void tube_updatespeed(void);
+void tube_run(int cycles);
+void tube_thread_stop(void);
+void tube_thread_park(void);
+void tube_thread_unpark(void);
 
 void tube_ula_savestate(FILE *f);
 void tube_ula_loadstate(FILE *f);
@@ -1,11 +1,6 @@
 #ifndef __INC_UEF_H
 #define __INC_UEF_H
 
-void uef_load(const char *fn);
-void uef_close(void);
-void uef_poll(void);
-void uef_findfilenames(void);
-
-extern int uef_toneon;
+bool uef_load(const char *fn);
 
 #endif
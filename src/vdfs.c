@@ -53,6 +53,12 @@
 
 #include <sys/stat.h>
 
+#ifdef HAVE_SYS_INOTIFY_H
+#define VDFS_INOTIFY
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
 bool vdfs_enabled = 0;
 const char *vdfs_cfg_root = NULL;
 const char *vdfs_boot_dir = NULL;
@@ -72,7 +78,8 @@ const char *vdfs_boot_dir = NULL;
  *
  * In the event this is a directory rather than a file this entry
  * will contain a head pointer to a linked list of children, those
- * being contents of the directory.
+ * being contents of the directory, and hashed indexes of those
+ * children by Acorn and by host name.
  */
 
 #define MAX_FILE_NAME    10
@@ -116,9 +123,17 @@ typedef enum {
     SORT_DFS
 } sort_type;
 
+typedef struct {
+    vdfs_entry **chains;
+    unsigned   size;
+    unsigned   count;
+} vdfs_index;
+
 struct vdfs_entry {
     vdfs_entry *parent;
     vdfs_entry *next;
+    vdfs_entry *acorn_hnext;
+    vdfs_entry *host_hnext;
     char       *host_path;
     char       *host_fn;
     char       *host_inf;
@@ -136,8 +151,11 @@ struct vdfs_entry {
         } file;
         struct {
             vdfs_entry *children;
+            vdfs_index acorn_idx;
+            vdfs_index host_idx;
             time_t     scan_mtime;
             unsigned   scan_seq;
+            int        watch;
             sort_type  sorted;
             char       boot_opt;
             uint8_t    title_len;
@@ -431,16 +449,216 @@ static void flush_all(void)
     }
 }
 
+/*
+ * Each directory has two hashed indexes of its children, one by Acorn
+ * name, compared without regard to case, and one by host name, so
+ * finding a name in a large directory does not mean walking the whole
+ * list of children.  An index is built when first needed and dropped,
+ * to be built again, when names it holds change or the directory
+ * outgrows it.  Entries are on a hash chain in the same order as in
+ * the list of children so the first match found is the same either way.
+ */
+
+#define INDEX_MIN_SIZE 32
+
+static unsigned hash_acorn(const char *fn, unsigned len)
+{
+    unsigned hash = 2166136261u;
+    while (len--) {
+        int ch = *(const unsigned char *)fn++;
+        if (ch >= 'a' && ch <= 'z')
+            ch = ch - 'a' + 'A';
+        hash = (hash ^ ch) * 16777619u;
+    }
+    return hash;
+}
+
+static unsigned hash_host(const char *fn)
+{
+    unsigned hash = 2166136261u;
+    int ch;
+    while ((ch = *(const unsigned char *)fn++))
+        hash = (hash ^ ch) * 16777619u;
+    return hash;
+}
+
+static inline vdfs_entry **index_link(vdfs_entry *ent, bool host)
+{
+    return host ? &ent->host_hnext : &ent->acorn_hnext;
+}
+
+static inline unsigned index_hash(const vdfs_entry *ent, bool host)
+{
+    return host ? hash_host(ent->host_fn) : hash_acorn(ent->acorn_fn, ent->acorn_len);
+}
+
+static void index_drop(vdfs_index *idx)
+{
+    if (idx->chains) {
+        free(idx->chains);
+        idx->chains = NULL;
+    }
+}
+
+static vdfs_index *index_get(vdfs_entry *dir, bool host)
+{
+    vdfs_index *idx = host ? &dir->u.dir.host_idx : &dir->u.dir.acorn_idx;
+    if (!idx->chains) {
+        unsigned count = 0;
+        for (vdfs_entry *ent = dir->u.dir.children; ent; ent = ent->next)
+            count++;
+        unsigned size = INDEX_MIN_SIZE;
+        while (size < count)
+            size *= 2;
+        vdfs_entry **chains = calloc(size, sizeof(vdfs_entry *));
+        if (!chains)
+            return NULL; // search the list instead.
+        for (vdfs_entry *ent = dir->u.dir.children; ent; ent = ent->next) {
+            vdfs_entry **link = chains + (index_hash(ent, host) & (size - 1));
+            while (*link)
+                link = index_link(*link, host);
+            *link = ent;
+            *index_link(ent, host) = NULL;
+        }
+        idx->chains = chains;
+        idx->size = size;
+        idx->count = count;
+        log_debug("vdfs: built %s index of %u entries for %s", host ? "host" : "acorn", count, dir->host_path);
+    }
+    return idx;
+}
+
+// Add an entry to the indexes having added it to the head of the list.
+
+static void index_add(vdfs_entry *dir, vdfs_entry *ent)
+{
+    for (int host = 0; host < 2; host++) {
+        vdfs_index *idx = host ? &dir->u.dir.host_idx : &dir->u.dir.acorn_idx;
+        if (idx->chains) {
+            if (++idx->count > idx->size)
+                index_drop(idx);
+            else {
+                vdfs_entry **chain = idx->chains + (index_hash(ent, host) & (idx->size - 1));
+                *index_link(ent, host) = *chain;
+                *chain = ent;
+            }
+        }
+    }
+}
+
+static void link_child(vdfs_entry *dir, vdfs_entry *ent)
+{
+    ent->next = dir->u.dir.children;
+    dir->u.dir.children = ent;
+    dir->u.dir.sorted = SORT_NONE;
+    index_add(dir, ent);
+}
+
+#ifdef VDFS_INOTIFY
+
+/*
+ * Where the host supports it each directory that has been scanned is
+ * watched for changes so, rather than reading the whole directory
+ * again when it is found to have changed, only the entries named in
+ * the change notifications are scanned again.  A directory that cannot
+ * be watched is checked for changes by modification time as before.
+ */
+
+#define WATCH_EVENTS (IN_ONLYDIR|IN_CREATE|IN_DELETE|IN_MOVED_FROM|IN_MOVED_TO|IN_CLOSE_WRITE|IN_ATTRIB)
+
+static int watch_fd = -1;
+static vdfs_entry **watch_dirs; // directory for each watch descriptor.
+static int watch_max;
+
+static void watch_add(vdfs_entry *dir)
+{
+    if (dir->u.dir.watch)
+        return;
+    if (watch_fd == -1 && (watch_fd = inotify_init1(IN_NONBLOCK|IN_CLOEXEC)) == -1) {
+        log_warn("vdfs: unable to watch directories, will check for changes instead: %s", strerror(errno));
+        watch_fd = -2;
+    }
+    if (watch_fd < 0)
+        return;
+    int wd = inotify_add_watch(watch_fd, dir->host_path, WATCH_EVENTS);
+    if (wd <= 0) {
+        log_debug("vdfs: unable to watch directory '%s': %s", dir->host_path, strerror(errno));
+        return;
+    }
+    if (wd >= watch_max) {
+        int max = watch_max ? watch_max : 64;
+        while (max <= wd)
+            max *= 2;
+        vdfs_entry **dirs = realloc(watch_dirs, max * sizeof(vdfs_entry *));
+        if (!dirs) {
+            log_warn("vdfs: out of memory watching directory '%s'", dir->host_path);
+            inotify_rm_watch(watch_fd, wd);
+            return;
+        }
+        memset(dirs + watch_max, 0, (max - watch_max) * sizeof(vdfs_entry *));
+        watch_dirs = dirs;
+        watch_max = max;
+    }
+    // The same host directory reached by another route, a symbolic
+    // link say, gets the same watch so that entry is no longer told.
+    vdfs_entry *other = watch_dirs[wd];
+    if (other && other != dir)
+        other->u.dir.watch = 0;
+    watch_dirs[wd] = dir;
+    dir->u.dir.watch = wd;
+}
+
+static void watch_drop(vdfs_entry *dir)
+{
+    int wd = dir->u.dir.watch;
+    if (wd) {
+        if (watch_dirs[wd] == dir) {
+            inotify_rm_watch(watch_fd, wd);
+            watch_dirs[wd] = NULL;
+        }
+        dir->u.dir.watch = 0;
+    }
+}
+
+static void watch_close(void)
+{
+    if (watch_fd >= 0) {
+        close(watch_fd);
+        watch_fd = -1;
+    }
+    if (watch_dirs) {
+        free(watch_dirs);
+        watch_dirs = NULL;
+        watch_max = 0;
+    }
+}
+
+#endif
+
+static void free_entry(vdfs_entry *ent);
+
+static void free_dir(vdfs_entry *dir)
+{
+    free_entry(dir->u.dir.children);
+    dir->u.dir.children = NULL;
+    index_drop(&dir->u.dir.acorn_idx);
+    index_drop(&dir->u.dir.host_idx);
+#ifdef VDFS_INOTIFY
+    watch_drop(dir);
+#endif
+}
+
 static void free_entry(vdfs_entry *ent)
 {
-    if (ent) {
-        free_entry(ent->next);
+    while (ent) {
+        vdfs_entry *next = ent->next;
         char *ptr = ent->host_path;
         if (ptr)
             free(ptr);
         if (ent->attribs & ATTR_IS_DIR)
-            free_entry(ent->u.dir.children);
+            free_dir(ent);
         free(ent);
+        ent = next;
     }
 }
 
@@ -632,8 +850,11 @@ static void vdfs_hosterr(int errnum)
 static void init_dir(vdfs_entry *ent)
 {
     ent->u.dir.children = NULL;
+    ent->u.dir.acorn_idx.chains = NULL;
+    ent->u.dir.host_idx.chains = NULL;
     ent->u.dir.scan_mtime = 0;
     ent->u.dir.scan_seq = 0;
+    ent->u.dir.watch = 0;
     ent->u.dir.sorted = SORT_NONE;
     ent->u.dir.boot_opt = 0;
     ent->u.dir.title_len = 0;
@@ -672,7 +893,7 @@ static void scan_attr(vdfs_entry *ent)
             if (attribs & ATTR_IS_DIR) {
                 log_debug("vdfs: dir %.*s has become a file", ent->acorn_len, ent->acorn_fn);
                 attribs &= ~ATTR_IS_DIR;
-                free_entry(ent->u.dir.children);
+                free_dir(ent);
             }
             ent->u.file.load_addr = 0;
             ent->u.file.exec_addr = 0;
@@ -726,7 +947,7 @@ static void scan_attr(vdfs_entry *ent)
             if (attribs & ATTR_IS_DIR) {
                 log_debug("vdfs: dir %.*s has become a file", ent->acorn_len, ent->acorn_fn);
                 attribs &= ~ATTR_IS_DIR;
-                free_entry(ent->u.dir.children);
+                free_dir(ent);
             }
             ent->u.file.load_addr = 0;
             ent->u.file.exec_addr = 0;
@@ -1094,6 +1315,10 @@ static void scan_inf_dir(vdfs_entry *dir)
 
 static void scan_entry(vdfs_entry *ent)
 {
+    uint8_t old_len = ent->acorn_len;
+    char old_fn[MAX_FILE_NAME];
+    memcpy(old_fn, ent->acorn_fn, old_len);
+
     scan_attr(ent);
     if (ent->attribs & ATTR_IS_DIR)
         scan_inf_dir(ent);
@@ -1101,6 +1326,12 @@ static void scan_entry(vdfs_entry *ent)
         scan_inf_file(ent);
     if (ent->acorn_len == 0)
         hst2bbc(ent);
+
+    // An entry already in a directory may have been given a new Acorn
+    // name by its .inf file.
+    vdfs_entry *dir = ent->parent;
+    if (old_len && dir && dir != ent && (ent->acorn_len != old_len || memcmp(ent->acorn_fn, old_fn, old_len)))
+        index_drop(&dir->u.dir.acorn_idx);
 }
 
 static void init_entry(vdfs_entry *ent)
@@ -1144,9 +1375,34 @@ static int vdfs_cmp(vdfs_entry *ent_a, vdfs_entry *ent_b)
         return 0;
 }
 
+/*
+ * Start a search of a directory for an Acorn name.  If the name has no
+ * wildcards only the hash chain for it need be searched, otherwise the
+ * whole list of children is.  Which it is decides the link to follow.
+ */
+
+static vdfs_entry *search_first(vdfs_entry *dir, const char *fn, unsigned len, bool *chain)
+{
+    if (!memchr(fn, '*', len) && !memchr(fn, '#', len)) {
+        vdfs_index *idx = index_get(dir, false);
+        if (idx) {
+            *chain = true;
+            return idx->chains[hash_acorn(fn, len) & (idx->size - 1)];
+        }
+    }
+    *chain = false;
+    return dir->u.dir.children;
+}
+
+static inline vdfs_entry *search_next(vdfs_entry *ent, bool chain)
+{
+    return chain ? ent->acorn_hnext : ent->next;
+}
+
 static vdfs_entry *acorn_search(vdfs_entry *dir, vdfs_entry *obj)
 {
-    for (vdfs_entry *ent = dir->u.dir.children; ent; ent = ent->next)
+    bool chain;
+    for (vdfs_entry *ent = search_first(dir, obj->acorn_fn, obj->acorn_len, &chain); ent; ent = search_next(ent, chain))
         if (!vdfs_cmp(ent, obj))
             return ent;
     return NULL;
@@ -1203,7 +1459,8 @@ bool vdfs_wildmat(const char *pattern, unsigned pat_len, const char *candidate,
 
 static vdfs_entry *wild_search(vdfs_entry *dir, vdfs_findres *res)
 {
-    for (vdfs_entry *ent = dir->u.dir.children; ent; ent = ent->next)
+    bool chain;
+    for (vdfs_entry *ent = search_first(dir, res->acorn_fn, res->acorn_len, &chain); ent; ent = search_next(ent, chain))
         if (vdfs_wildmat(res->acorn_fn, res->acorn_len, ent->acorn_fn, ent->acorn_len))
             return ent;
     return NULL;
@@ -1253,9 +1510,7 @@ static vdfs_entry *new_entry(vdfs_entry *dir, const char *host_fn)
                 }
                 log_debug("vdfs: new_entry: unique name %.*s used", ent->acorn_len, ent->acorn_fn);
             }
-            ent->next = dir->u.dir.children;
-            dir->u.dir.children = ent;
-            dir->u.dir.sorted = SORT_NONE;
+            link_child(dir, ent);
             log_debug("vdfs: new_entry: returning new entry %p", ent);
             return ent;
         }
@@ -1268,9 +1523,17 @@ static vdfs_entry *new_entry(vdfs_entry *dir, const char *host_fn)
 
 static vdfs_entry *host_search(vdfs_entry *dir, const char *host_fn)
 {
-    for (vdfs_entry *ent = dir->u.dir.children; ent; ent = ent->next)
-        if (!strcmp(ent->host_fn, host_fn))
-            return ent;
+    vdfs_index *idx = index_get(dir, true);
+    if (idx) {
+        for (vdfs_entry *ent = idx->chains[hash_host(host_fn) & (idx->size - 1)]; ent; ent = ent->host_hnext)
+            if (!strcmp(ent->host_fn, host_fn))
+                return ent;
+    }
+    else {
+        for (vdfs_entry *ent = dir->u.dir.children; ent; ent = ent->next)
+            if (!strcmp(ent->host_fn, host_fn))
+                return ent;
+    }
     return NULL;
 }
 
@@ -1305,12 +1568,76 @@ static void scan_dir_host(vdfs_entry *dir, DIR *dp)
     }
 }
 
+#ifdef VDFS_INOTIFY
+
+static void watch_event(struct inotify_event *ev)
+{
+    if (ev->mask & IN_Q_OVERFLOW) {
+        log_debug("vdfs: change notifications lost, all directories will be scanned again");
+        scan_seq++;
+        return;
+    }
+    if (ev->wd <= 0 || ev->wd >= watch_max)
+        return;
+    vdfs_entry *dir = watch_dirs[ev->wd];
+    if (!dir)
+        return;
+    if (ev->mask & IN_IGNORED) {
+        // The directory has gone so the watch has been removed.
+        watch_dirs[ev->wd] = NULL;
+        dir->u.dir.watch = 0;
+        return;
+    }
+    char *name = ev->name;
+    if (!ev->len || *name == '.')
+        return;
+    log_debug("vdfs: change %08X to %s in %s", ev->mask, name, dir->host_path);
+    bool inf = is_inf(name);
+    if (inf)
+        *strrchr(name, '.') = '\0';
+    vdfs_entry *ent = host_search(dir, name);
+    if (ent) {
+        ent->attribs &= (ATTR_IS_DIR|ATTR_OPEN_READ|ATTR_OPEN_WRITE);
+        if (inf || !(ev->mask & (IN_DELETE|IN_MOVED_FROM)))
+            scan_entry(ent);
+    }
+    else if (!inf && ev->mask & (IN_CREATE|IN_MOVED_TO))
+        new_entry(dir, name);
+}
+
+static void watch_poll(void)
+{
+    if (watch_fd >= 0) {
+        union {
+            struct inotify_event ev;
+            char buf[4096];
+        } u;
+        ssize_t len;
+        while ((len = read(watch_fd, u.buf, sizeof(u.buf))) > 0) {
+            for (char *ptr = u.buf; ptr < u.buf + len; ) {
+                struct inotify_event *ev = (struct inotify_event *)ptr;
+                watch_event(ev);
+                ptr += sizeof(struct inotify_event) + ev->len;
+            }
+        }
+    }
+}
+
+#endif
+
 static int scan_dir(vdfs_entry *dir)
 {
     struct stat stb;
 
     // Has this been scanned sufficiently recently already?
 
+#ifdef VDFS_INOTIFY
+    watch_poll();
+    if (dir->u.dir.watch && scan_seq <= dir->u.dir.scan_seq) {
+        log_debug("vdfs: using watched dir info for %s", dir->host_path);
+        return 0;
+    }
+#endif
     if (stat(dir->host_path, &stb) == -1)
         log_warn("vdfs: unable to stat directory '%s': %s", dir->host_path, strerror(errno));
     else if (scan_seq <= dir->u.dir.scan_seq && stb.st_mtime <= dir->u.dir.scan_mtime) {
@@ -1319,6 +1646,10 @@ static int scan_dir(vdfs_entry *dir)
     }
     show_activity();
 
+#ifdef VDFS_INOTIFY
+    // Watch first so nothing changed while reading is missed.
+    watch_add(dir);
+#endif
     DIR *dp = opendir(dir->host_path);
     if (dp) {
         scan_dir_host(dir, dp);
@@ -1506,7 +1837,8 @@ static vdfs_entry *find_entry_dfs(const vdfs_path *path, vdfs_findres *res, vdfs
     memcpy(res->acorn_fn, filename, len);
     res->acorn_len = len;
     if (!scan_dir(dir->dir)) {
-        for (vdfs_entry *ent = dir->dir->u.dir.children; ent; ent = ent->next) {
+        bool chain;
+        for (vdfs_entry *ent = search_first(dir->dir, res->acorn_fn, len, &chain); ent; ent = search_next(ent, chain)) {
             log_debug("vdfs: find_entry_dfs, considering entry %c.%.*s", ent->dfs_dir, ent->acorn_len, ent->acorn_fn);
             if (srchdir == '*' || srchdir == '#' || !vdfs_cmpch(srchdir, ent->dfs_dir)) {
                 log_debug("vdfs: find_entry_dfs, matched DFS dir");
@@ -1565,9 +1897,7 @@ static vdfs_entry *add_new_file(vdfs_findres *res)
         }
         new_ent->parent = dir;
         if (make_host_path(new_ent, host_fn)) {
-            new_ent->next = dir->u.dir.children;
-            dir->u.dir.children = new_ent;
-            dir->u.dir.sorted = SORT_NONE;
+            link_child(dir, new_ent);
             return new_ent;
         }
         free(new_ent);
@@ -1712,11 +2042,13 @@ void vdfs_close(void)
         free(ptr);
         root_dir.host_path = NULL;
     }
-    if ((ptr = root_dir.u.dir.children)) {
-        free_entry(ptr);
-        root_dir.u.dir.children = NULL;
+    if (root_dir.attribs & ATTR_IS_DIR) {
+        free_dir(&root_dir);
         root_dir.u.dir.sorted = SORT_NONE;
     }
+#ifdef VDFS_INOTIFY
+    watch_close();
+#endif
 }
 
 void vdfs_set_root(const char *root)
@@ -3244,6 +3576,8 @@ static void acorn_sort(vdfs_entry *dir, sort_type sort_reqd)
                 if (nmerges <= 1) {  /* allow for nmerges==0, the empty list case */
                     dir->u.dir.children = list;
                     dir->u.dir.sorted = sort_reqd;
+                    /* hash chains follow list order so rebuild them */
+                    index_drop(&dir->u.dir.acorn_idx);
                     return;
                 }
                 /* Otherwise repeat, merging lists twice the size */
@@ -4006,13 +4340,32 @@ static void rename_tail(vdfs_entry *old_ent, vdfs_entry *new_ent)
     if (rename(old_ent->host_path, new_ent->host_path) == 0) {
         log_debug("vdfs: '%s' renamed to '%s'", old_ent->host_path, new_ent->host_path);
         if (old_ent->attribs & ATTR_IS_DIR) {
+            if (new_ent->attribs & ATTR_IS_DIR) {
+                index_drop(&new_ent->u.dir.acorn_idx);
+                index_drop(&new_ent->u.dir.host_idx);
+#ifdef VDFS_INOTIFY
+                watch_drop(new_ent);
+#endif
+            }
             new_ent->attribs |= ATTR_EXISTS|ATTR_IS_DIR;
             new_ent->u.dir.children   = old_ent->u.dir.children;
+            new_ent->u.dir.acorn_idx  = old_ent->u.dir.acorn_idx;
+            new_ent->u.dir.host_idx   = old_ent->u.dir.host_idx;
             new_ent->u.dir.scan_seq   = old_ent->u.dir.scan_seq;
             new_ent->u.dir.scan_mtime = old_ent->u.dir.scan_mtime;
             new_ent->u.dir.sorted     = old_ent->u.dir.sorted;
             old_ent->u.dir.children   = NULL;
+            old_ent->u.dir.acorn_idx.chains = NULL;
+            old_ent->u.dir.host_idx.chains  = NULL;
             old_ent->u.dir.sorted     = SORT_NONE;
+#ifdef VDFS_INOTIFY
+            // The watch follows the directory to its new name.
+            int wd = old_ent->u.dir.watch;
+            new_ent->u.dir.watch = wd;
+            if (wd && watch_dirs[wd] == old_ent)
+                watch_dirs[wd] = new_ent;
+            old_ent->u.dir.watch = 0;
+#endif
         }
         else {
             new_ent->attribs |= ATTR_EXISTS;
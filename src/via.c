@@ -71,6 +71,25 @@ void via_poll(VIA *v, int cycles)
         via_shift(v, cycles);
 }
 
+/*
+ * Return the number of cycles before via_poll needs to be called
+ * again, i.e. before a timer expires.  In between, the timer counters
+ * may lag so callers must poll before the VIA is accessed.
+ */
+
+int via_next_poll(VIA *v)
+{
+    if ((v->acr & 0x1c) == 0x18)
+        return 1; /* shift register clocked every cycle */
+    int next = v->t1c - TLIMIT + 1;
+    if (!(v->acr & 0x20) && !v->t2hit) {
+        int t2next = v->t2c - TLIMIT + 1;
+        if (t2next < next)
+            next = t2next;
+    }
+    return next;
+}
+
 static void via_set_acr(VIA *v, uint8_t val)
 {
     v->acr = val;
@@ -41,5 +41,6 @@ void via_savestate(VIA *v, FILE *f);
 void via_loadstate(VIA *v, FILE *f);
 
 void via_poll(VIA *v, int cycles);
+int  via_next_poll(VIA *v);
 
 #endif
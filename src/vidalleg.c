@@ -21,6 +21,19 @@ int vid_lock_type;
 
 static int fskipcount;
 
+/*
+ * Once the render thread is started it owns the display and draws each
+ * frame from a copy the emulation hands it, see below.  Anything else
+ * that needs the display, changing its size say, takes it for a moment
+ * with video_acquire.
+ */
+
+static ALLEGRO_DISPLAY *render_display;
+static ALLEGRO_THREAD *render_thread;
+static ALLEGRO_MUTEX *render_mutex;     // guards the frame slots.
+static ALLEGRO_MUTEX *video_mutex;      // guards the display.
+static ALLEGRO_COND *render_cond;
+
 int vid_savescrshot = 0;
 char vid_scrshotname[260];
 
@@ -36,9 +49,30 @@ static const int y_fudge = 0;
 static const int y_fudge = 28;
 #endif
 
-static void video_calc_fullscreen(ALLEGRO_DISPLAY *display)
+static ALLEGRO_DISPLAY *video_acquire(void)
+{
+    if (!render_thread)
+        return al_get_current_display();
+    al_lock_mutex(video_mutex);
+    al_set_target_backbuffer(render_display);
+    return render_display;
+}
+
+static void video_release(void)
+{
+    if (render_thread) {
+        al_set_target_bitmap(NULL);
+        al_unlock_mutex(video_mutex);
+    }
+}
+
+/*
+ * The gaps either side of the BBC image are filled as each frame is
+ * drawn so there is nothing to draw here.
+ */
+
+static void video_calc_fullscreen(void)
 {
-    ALLEGRO_COLOR black = al_map_rgb(0, 0, 0);
     double aspect = (double)winsizex / (double)winsizey;
     log_debug("vidalleg: video_enterfullscreen, new winsizex=%d, winsizey=%d, aspect=%g", winsizex, winsizey, aspect);
     if (aspect > (4.0 / 3.0)) {
@@ -47,11 +81,6 @@ static void video_calc_fullscreen(ALLEGRO_DISPLAY *display)
         scr_y_start = 0;
         scr_x_size = value;
         scr_y_size = winsizey;
-        al_set_target_backbuffer(display);
-        // fill the gap between the left screen edge and the BBC image.
-        al_draw_filled_rectangle(0, 0, scr_x_start, scr_y_size, black);
-        // fill the gap between the BBC image and the right screen edge.
-        al_draw_filled_rectangle(scr_x_start + value, 0, winsizex, winsizey, black);
     }
     else {
         int value = 3 * winsizex / 4;
@@ -59,10 +88,6 @@ static void video_calc_fullscreen(ALLEGRO_DISPLAY *display)
         scr_y_start = (winsizey - value) / 2;
         scr_x_size = winsizex;
         scr_y_size = value;
-        // fill the gap between the top of the screen and the BBC image.
-        al_draw_filled_rectangle(0, 0, scr_x_size, scr_y_start, black);
-        // fill the gap between the BBC image and the bottom of the screen.
-        al_draw_filled_rectangle(0, scr_y_start + value, winsizex, winsizey, black);
     }
     log_debug("vidalleg: video_enterfullscreen, scr_x_start=%d, scr_y_start=%d, scr_x_size=%d, scr_y_size=%d", scr_x_start, scr_y_start, scr_x_size, scr_y_size);
 }
@@ -73,7 +98,7 @@ static void video_startfullscreen(ALLEGRO_DISPLAY *display)
 {
     winsizex = al_get_display_width(display);
     winsizey = al_get_display_height(display);
-    video_calc_fullscreen(display);
+    video_calc_fullscreen();
     if (winsizex == save_winsizex || winsizey == save_winsizey) {
         log_debug("vidalleg: video_enterfullscreen, no immediate change of size, setting fullscreen_pending");
         fullscreen_pending = 500;
@@ -82,7 +107,7 @@ static void video_startfullscreen(ALLEGRO_DISPLAY *display)
 
 void video_enterfullscreen()
 {
-    ALLEGRO_DISPLAY *display = al_get_current_display();
+    ALLEGRO_DISPLAY *display = video_acquire();
     save_winsizex = al_get_display_width(display);
     save_winsizey = al_get_display_height(display);
     log_debug("vidalleg: video_enterfullscreen, save_winsizex=%d, save_winsizey=%d", save_winsizex, save_winsizey);
@@ -107,6 +132,7 @@ void video_enterfullscreen()
         log_error("vidalleg: could not set graphics mode to full-screen");
         fullscreen = 0;
     }
+    video_release();
 }
 
 void video_set_window_size(bool fudge)
@@ -153,21 +179,24 @@ void video_set_borders(int borders)
 {
     vid_fullborders = borders;
     video_set_window_size(false);
-    al_resize_display(al_get_current_display(), winsizex, winsizey);
+    al_resize_display(video_acquire(), winsizex, winsizey);
+    video_release();
 }
 
 void video_set_multipier(int multipler)
 {
     vid_win_multiplier = multipler;
     video_set_window_size(false);
-    al_resize_display(al_get_current_display(), winsizex, winsizey);
+    al_resize_display(video_acquire(), winsizex, winsizey);
+    video_release();
 }
 
 void video_set_led_location(int location)
 {
     vid_ledlocation = location;
     video_set_window_size(false);
-    al_resize_display(al_get_current_display(), winsizex, winsizey);
+    al_resize_display(video_acquire(), winsizex, winsizey);
+    video_release();
 }
 
 void video_set_led_visibility(int visibility)
@@ -193,14 +222,16 @@ void video_update_window_size(ALLEGRO_EVENT *event)
         scr_y_size = winsizey - video_led_height();
         log_debug("vidalleg: video_update_window_size, scr_x_size=%d, scr_y_size=%d", scr_x_size, scr_y_size);
     }
+    video_acquire();
     al_acknowledge_resize(event->display.source);
+    video_release();
 }
 
 void video_leavefullscreen(void)
 {
     ALLEGRO_DISPLAY *display;
 
-    display = al_get_current_display();
+    display = video_acquire();
     //try and restore size to pre fullscreen size
     al_resize_display(display, save_winsizex, save_winsizey);
 
@@ -221,11 +252,51 @@ void video_leavefullscreen(void)
     scr_y_start = 0;
     winsizey = al_get_display_height(display);
     scr_y_size = winsizey - video_led_height();
+    video_release();
 }
 
+/*
+ * At the end of each frame the emulation copies the part of b that will
+ * be shown, and the settings it is to be shown with, into a frame slot
+ * and hands it to the render thread, which does the conversion, scaling
+ * and overlays and waits for the flip while the emulation gets on with
+ * the next frame.  There are three slots: the one being filled, the one
+ * being drawn and the latest complete frame between them.  If the render
+ * thread falls behind the latest frame is replaced and never drawn.
+ *
+ * The part of b shown is copied rather than b swapped for another
+ * because in interlaced modes each frame draws only alternate lines and
+ * relies on the lines from the last frame still being there.
+ */
+
+#define FRAME_WIDTH  1280
+#define FRAME_HEIGHT  800
+
+typedef struct {
+    ALLEGRO_LOCKED_REGION region;       // the copy, laid out as b.
+    int cx1, cy1, cx2, cy2;             // the part of region copied.
+    int firstx, firsty, lastx, lasty;   // the part to show.
+    int shotx1, shoty1, shotx2, shoty2; // the part for a screenshot.
+    bool shot, clear;
+    enum vid_disptype dtype;
+    enum vid_coltype colour;
+    int scr_x_start, scr_x_size, scr_y_start, scr_y_size;
+    int winsizex, winsizey;
+    int ledlocation;
+    uint32_t leds;
+    ALLEGRO_COLOR led_tint;
+    char shotname[260];
+} render_frame_t;
+
+static uint32_t render_data[3][FRAME_HEIGHT][FRAME_WIDTH];
+static render_frame_t render_frames[3];
+static int render_fill = 0, render_latest = 1, render_shown = 2;
+static bool render_ready;
+static bool clear_pending;
+
 static void upscale_only(ALLEGRO_BITMAP *src, int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh)
 {
-    al_set_target_backbuffer(al_get_current_display());
+    al_set_target_backbuffer(render_display);
     if (dw > sw+10 || dh > sh+10)
         al_draw_scaled_bitmap(src, sx, sy, sw, sh, dx, dy, dw, dh, 0);
     else {
@@ -237,20 +308,18 @@ static void upscale_only(ALLEGRO_BITMAP *src, int sx, int sy, int sw, int sh, in
     }
 }
 
-static void line_double(void)
+static void line_double(render_frame_t *fr)
 {
-    char *yptr1 = (char *)region->data + region->pitch * firsty * 2;
-    char *yptr2 = yptr1 + region->pitch;
-    size_t linesize = abs(region->pitch);
+    ALLEGRO_LOCKED_REGION *region = &fr->region;
+    size_t linesize = (fr->cx2 - fr->cx1) * region->pixel_size;
 
-    for (int y = firsty; y < lasty; y++) {
-        memcpy(yptr2, yptr1, linesize);
-        yptr1 = yptr2 + region->pitch;
-        yptr2 = yptr1 + region->pitch;
+    for (int y = fr->cy1 & ~1; y + 1 < fr->cy2; y += 2) {
+        char *yptr1 = (char *)region->data + region->pitch * y + fr->cx1 * region->pixel_size;
+        memcpy(yptr1 + region->pitch, yptr1, linesize);
     }
 }
 
-static void mono_convert(int x1, int y1, int x2, int y2, ALLEGRO_COLOR mono_col)
+static void mono_convert(const ALLEGRO_LOCKED_REGION *region, int x1, int y1, int x2, int y2, ALLEGRO_COLOR mono_col)
 {
     float mono_r, mono_g, mono_b;
     al_unmap_rgb_f(mono_col, &mono_r, &mono_g, &mono_b);
@@ -276,111 +345,94 @@ static void mono_convert(int x1, int y1, int x2, int y2, ALLEGRO_COLOR mono_col)
     al_unlock_bitmap(b32);
 }
 
-static inline void save_screenshot(void)
-{
-    if (!--vid_savescrshot) {
-        int xsize = lastx - firstx;
-        int ysize = lasty - firsty + 1;
-        ALLEGRO_BITMAP *scrshotb  = al_create_bitmap(xsize, ysize << 1);
-        ALLEGRO_COLOR mono_col;
-
-        switch(vid_colour_out) {
-            case VDC_RGB:
-                al_set_target_bitmap(scrshotb);
-                switch(vid_dtype_intern) {
-                    case VDT_SCALE:
-                        al_unlock_bitmap(b);
-                        al_draw_scaled_bitmap(b, firstx, firsty, xsize, ysize, 0, 0, xsize, ysize << 1, 0);
-                        break;
-                    case VDT_INTERLACE:
-                        al_unlock_bitmap(b);
-                        al_draw_bitmap_region(b, firstx, firsty << 1, xsize, ysize << 1, 0, 0, 0);
-                        break;
-                    case VDT_SCANLINES:
-                        al_unlock_bitmap(b);
-                        for (int c = 0, y = firsty; y < lasty; y++, c += 2)
-                            al_draw_bitmap_region(b, firstx, y, xsize, 1, 0, c, 0);
-                        break;
-                    case VDT_LINEDOUBLE:
-                        line_double();
-                        al_unlock_bitmap(b);
-                        al_draw_scaled_bitmap(b, firstx, firsty << 1, xsize, ysize << 1, 0, 0, xsize, ysize << 1, 0);
-                        break;
-                    case VDT_UNSET:
-                        break;
-                }
-                region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, vid_lock_type);
-                break;
-            case VDC_PAL:
-                switch(vid_dtype_intern) {
-                    case VDT_SCALE:
-                        pal_convert(firstx, firsty, lastx, lasty, 1);
-                        al_set_target_bitmap(scrshotb);
-                        al_draw_scaled_bitmap(b32, firstx, firsty, xsize, ysize, 0, 0, xsize, ysize << 1, 0);
-                        break;
-                    case VDT_INTERLACE:
-                        pal_convert(firstx, firsty << 1, lastx, lasty << 1, 1);
-                        al_set_target_bitmap(scrshotb);
-                        al_draw_bitmap_region(b32, firstx, firsty << 1, xsize, ysize << 1, 0, 0, 0);
-                        break;
-                    case VDT_SCANLINES:
-                        pal_convert(firstx, firsty, lastx, lasty, 1);
-                        al_set_target_bitmap(scrshotb);
-                        for (int c = 0, y = firsty; y < lasty; y++, c += 2)
-                            al_draw_bitmap_region(b32, firstx, y, xsize, 1, 0, c, 0);
-                        break;
-                    case VDT_LINEDOUBLE:
-                        line_double();
-                        pal_convert(firstx, firsty << 1, lastx, lasty << 1, 1);
-                        al_set_target_bitmap(scrshotb);
-                        al_draw_bitmap_region(b32, firstx, firsty << 1, xsize, ysize << 1, 0, 0, 0);
-                        break;
-                    case VDT_UNSET:
-                        break;
-                }
-                break;
-            case VDC_GREEN:
-                mono_col = mono_green_col;
-                goto mono_screenshot;
-            case VDC_AMBER:
-                mono_col = mono_amber_col;
-                goto mono_screenshot;
-            case VDC_WHITE:
-                mono_col = mono_white_col;
-            mono_screenshot:
-                switch(vid_dtype_intern) {
-                    case VDT_SCALE:
-                        mono_convert(firstx, firsty, lastx, lasty, mono_col);
-                        al_set_target_bitmap(scrshotb);
-                        al_draw_scaled_bitmap(b32, firstx, firsty, xsize, ysize, 0, 0, xsize, ysize << 1, 0);
-                        break;
-                    case VDT_INTERLACE:
-                        mono_convert(firstx, firsty << 1, lastx, lasty << 1, mono_col);
-                        al_set_target_bitmap(scrshotb);
-                        al_draw_bitmap_region(b32, firstx, firsty << 1, xsize, ysize << 1, 0, 0, 0);
-                        break;
-                    case VDT_SCANLINES:
-                        mono_convert(firstx, firsty, lastx, lasty, mono_col);
-                        al_set_target_bitmap(scrshotb);
-                        for (int c = 0, y = firsty; y < lasty; y++, c += 2)
-                            al_draw_bitmap_region(b32, firstx, y, xsize, 1, 0, c, 0);
-                        break;
-                    case VDT_LINEDOUBLE:
-                        line_double();
-                        mono_convert(firstx, firsty << 1, lastx, lasty << 1, mono_col);
-                        al_set_target_bitmap(scrshotb);
-                        al_draw_bitmap_region(b32, firstx, firsty << 1, xsize, ysize << 1, 0, 0, 0);
-                        break;
-                    case VDT_UNSET:
-                        break;
-                }
-                break;
+/*
+ * Get the frame ready to draw: carry out any clear asked for, fill in
+ * the doubled lines and, for RGB, upload what was copied to bvid.
+ */
+
+static void render_prepare(render_frame_t *fr)
+{
+    if (fr->clear) {
+        al_set_target_bitmap(b32);
+        al_clear_to_color(al_map_rgb(0, 0, 0));
+    }
+    if (fr->dtype == VDT_LINEDOUBLE)
+        line_double(fr);
+    if (fr->colour == VDC_RGB && fr->cx2 > fr->cx1 && fr->cy2 > fr->cy1) {
+        ALLEGRO_LOCKED_REGION *dr = al_lock_bitmap_region(bvid, fr->cx1, fr->cy1, fr->cx2 - fr->cx1, fr->cy2 - fr->cy1, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_WRITEONLY);
+        if (dr) {
+            size_t linesize = (fr->cx2 - fr->cx1) * fr->region.pixel_size;
+            for (int y = fr->cy1; y < fr->cy2; y++)
+                memcpy((char *)dr->data + dr->pitch * (y - fr->cy1), (char *)fr->region.data + fr->region.pitch * y + fr->cx1 * fr->region.pixel_size, linesize);
+            al_unlock_bitmap(bvid);
         }
-        al_save_bitmap(vid_scrshotname, scrshotb);
-        al_destroy_bitmap(scrshotb);
     }
 }
 
+/*
+ * Convert the lines from y1 up to y2, in display lines, for the colour
+ * output chosen and return the bitmap holding the result.
+ */
+
+static ALLEGRO_BITMAP *render_convert(render_frame_t *fr, int x1, int y1, int x2, int y2)
+{
+    ALLEGRO_COLOR mono_col;
+
+    if (fr->dtype == VDT_INTERLACE || fr->dtype == VDT_LINEDOUBLE) {
+        y1 <<= 1;
+        y2 <<= 1;
+    }
+    switch(fr->colour) {
+        case VDC_RGB:
+            return bvid;
+        case VDC_PAL:
+            pal_convert(&fr->region, x1, y1, x2, y2, 1);
+            return b32;
+        case VDC_GREEN:
+            mono_col = mono_green_col;
+            break;
+        case VDC_AMBER:
+            mono_col = mono_amber_col;
+            break;
+        default:
+            mono_col = mono_white_col;
+    }
+    mono_convert(&fr->region, x1, y1, x2, y2, mono_col);
+    return b32;
+}
+
+static void render_screenshot(render_frame_t *fr)
+{
+    int x1 = fr->shotx1, y1 = fr->shoty1, x2 = fr->shotx2, y2 = fr->shoty2;
+    int xsize = x2 - x1;
+    int ysize = y2 - y1 + 1;
+    ALLEGRO_BITMAP *scrshotb, *src;
+
+    if (xsize <= 0 || ysize <= 0 || fr->dtype == VDT_UNSET || !(scrshotb = al_create_bitmap(xsize, ysize << 1))) {
+        log_warn("vidalleg: nothing to save in screenshot %s", fr->shotname);
+        return;
+    }
+    src = render_convert(fr, x1, y1, x2, y2);
+    al_set_target_bitmap(scrshotb);
+    switch(fr->dtype) {
+        case VDT_SCALE:
+            al_draw_scaled_bitmap(src, x1, y1, xsize, ysize, 0, 0, xsize, ysize << 1, 0);
+            break;
+        case VDT_INTERLACE:
+        case VDT_LINEDOUBLE:
+            al_draw_bitmap_region(src, x1, y1 << 1, xsize, ysize << 1, 0, 0, 0);
+            break;
+        case VDT_SCANLINES:
+            for (int c = 0, y = y1; y < y2; y++, c += 2)
+                al_draw_bitmap_region(src, x1, y, xsize, 1, 0, c, 0);
+            break;
+        case VDT_UNSET:
+            break;
+    }
+    al_save_bitmap(fr->shotname, scrshotb);
+    al_destroy_bitmap(scrshotb);
+}
+
 static inline void calc_limits(bool non_ttx, uint8_t vtotal)
 {
     switch(vid_fullborders) {
@@ -440,139 +492,169 @@ static inline void calc_limits(bool non_ttx, uint8_t vtotal)
     }
 }
 
-static inline void blit_screen(void)
+static inline void blit_screen(render_frame_t *fr)
 {
-    int xsize = lastx - firstx;
-    int ysize = lasty - firsty + 1;
-    ALLEGRO_COLOR mono_col;
-
-    switch(vid_colour_out) {
-        case VDC_RGB:
-            switch(vid_dtype_intern) {
-                case VDT_SCALE:
-                    al_unlock_bitmap(b);
-                    al_set_target_backbuffer(al_get_current_display());
-                    al_draw_scaled_bitmap(b, firstx, firsty, xsize, ysize, scr_x_start, scr_y_start, scr_x_size, scr_y_size, 0);
-                    break;
-                case VDT_INTERLACE:
-                    al_unlock_bitmap(b);
-                    upscale_only(b, firstx, firsty << 1, lastx - firstx, (lasty - firsty) << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
-                    break;
-                case VDT_SCANLINES:
-                    al_unlock_bitmap(b);
-                    al_set_target_bitmap(b16);
-                    al_clear_to_color(border_col);
-                    for (int c = firsty; c < lasty; c++)
-                        al_draw_bitmap_region(b, firstx, c, xsize, 1, 0, c << 1, 0);
-                    upscale_only(b16, 0, firsty << 1, lastx - firstx, (lasty - firsty) << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
-                    break;
-                case VDT_LINEDOUBLE:
-                    line_double();
-                    al_unlock_bitmap(b);
-                    upscale_only(b, firstx, firsty << 1, xsize, ysize  << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
-                case VDT_UNSET:
-                    break;
-            }
-            region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, vid_lock_type);
+    int x1 = fr->firstx, y1 = fr->firsty, x2 = fr->lastx, y2 = fr->lasty;
+    int xsize = x2 - x1;
+    int ysize = y2 - y1 + 1;
+    ALLEGRO_BITMAP *src;
+
+    if (fr->dtype == VDT_UNSET)
+        return;
+    src = render_convert(fr, x1, y1, x2, y2);
+    switch(fr->dtype) {
+        case VDT_SCALE:
+            al_set_target_backbuffer(render_display);
+            al_draw_scaled_bitmap(src, x1, y1, xsize, ysize, fr->scr_x_start, fr->scr_y_start, fr->scr_x_size, fr->scr_y_size, 0);
             break;
-        case VDC_PAL:
-            switch(vid_dtype_intern) {
-                case VDT_SCALE:
-                    pal_convert(firstx, firsty, lastx, lasty, 1);
-                    al_set_target_backbuffer(al_get_current_display());
-                    al_draw_scaled_bitmap(b32, firstx, firsty, xsize, ysize, scr_x_start, scr_y_start, scr_x_size, scr_y_size, 0);
-                    break;
-                case VDT_INTERLACE:
-                    pal_convert(firstx, firsty << 1, lastx, lasty << 1, 1);
-                    upscale_only(b32, firstx, firsty << 1, xsize, ysize << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
-                    break;
-                case VDT_SCANLINES:
-                    pal_convert(firstx, firsty, lastx, lasty, 1);
-                    al_set_target_bitmap(b16);
-                    al_clear_to_color(al_map_rgb(0, 0,0));
-                    for (int c = firsty; c < lasty; c++)
-                        al_draw_bitmap_region(b32, firstx, c, lastx - firstx, 1, 0, c << 1, 0);
-                    upscale_only(b16, 0, firsty << 1, xsize, ysize << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
-                    break;
-                case VDT_LINEDOUBLE:
-                    line_double();
-                    pal_convert(firstx, firsty << 1, lastx, lasty << 1, 1);
-                    upscale_only(b32, firstx, firsty << 1, xsize, ysize << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
-                    break;
-                case VDT_UNSET:
-                    break;
-            }
+        case VDT_INTERLACE:
+        case VDT_LINEDOUBLE:
+            upscale_only(src, x1, y1 << 1, xsize, ysize << 1, fr->scr_x_start, fr->scr_y_start, fr->scr_x_size, fr->scr_y_size);
+            break;
+        case VDT_SCANLINES:
+            al_set_target_bitmap(b16);
+            al_clear_to_color(border_col);
+            for (int c = y1; c < y2; c++)
+                al_draw_bitmap_region(src, x1, c, xsize, 1, 0, c << 1, 0);
+            upscale_only(b16, 0, y1 << 1, xsize, ysize << 1, fr->scr_x_start, fr->scr_y_start, fr->scr_x_size, fr->scr_y_size);
+            break;
+        case VDT_UNSET:
             break;
-        case VDC_GREEN:
-            mono_col = mono_green_col;
-            goto mono_common;
-        case VDC_AMBER:
-            mono_col = mono_amber_col;
-            goto mono_common;
-        case VDC_WHITE:
-            mono_col = mono_white_col;
-        mono_common:
-            switch(vid_dtype_intern) {
-                case VDT_SCALE:
-                    mono_convert(firstx, firsty, lastx, lasty, mono_col);
-                    al_set_target_backbuffer(al_get_current_display());
-                    al_draw_scaled_bitmap(b32, firstx, firsty, xsize, ysize, scr_x_start, scr_y_start, scr_x_size, scr_y_size, 0);
-                    break;
-                case VDT_INTERLACE:
-                    mono_convert(firstx, firsty << 1, lastx, lasty << 1, mono_col);
-                    upscale_only(b32, firstx, firsty << 1, xsize, ysize << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
-                    break;
-                case VDT_SCANLINES:
-                    mono_convert(firstx, firsty, lastx, lasty, mono_col);
-                    al_set_target_bitmap(b16);
-                    al_clear_to_color(al_map_rgb(0, 0,0));
-                    for (int c = firsty; c < lasty; c++)
-                        al_draw_bitmap_region(b32, firstx, c, lastx - firstx, 1, 0, c << 1, 0);
-                    upscale_only(b16, 0, firsty << 1, xsize, ysize << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
-                    break;
-                case VDT_LINEDOUBLE:
-                    line_double();
-                    mono_convert(firstx, firsty << 1, lastx, lasty << 1, mono_col);
-                    upscale_only(b32, firstx, firsty << 1, xsize, ysize << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
-                    break;
-                case VDT_UNSET:
-                    break;
-
-            }
     }
 }
 
-static inline void fill_pillarbox(void)
+static inline void fill_pillarbox(const render_frame_t *fr)
 {
     // fill the gap between the left screen edge and the BBC image.
-    al_draw_filled_rectangle(0, 0, scr_x_start, scr_y_size, border_col);
+    al_draw_filled_rectangle(0, 0, fr->scr_x_start, fr->scr_y_size, border_col);
     // fill the gap between the BBC image and the right screen edge.
-    al_draw_filled_rectangle(scr_x_start + scr_x_size, 0, winsizex, winsizey, border_col);
+    al_draw_filled_rectangle(fr->scr_x_start + fr->scr_x_size, 0, fr->winsizex, fr->winsizey, border_col);
 }
 
-static inline void fill_letterbox(void)
+static inline void fill_letterbox(const render_frame_t *fr)
 {
     // fill the gap between the top of the screen and the BBC image.
-    al_draw_filled_rectangle(0, 0, scr_x_size, scr_y_start, border_col);
+    al_draw_filled_rectangle(0, 0, fr->scr_x_size, fr->scr_y_start, border_col);
     // fill the gap between the BBC image and the bottom of the screen.
-    al_draw_filled_rectangle(0, scr_y_start + scr_y_size, winsizex, winsizey, border_col);
+    al_draw_filled_rectangle(0, fr->scr_y_start + fr->scr_y_size, fr->winsizex, fr->winsizey, border_col);
 }
 
-static void render_leds(void)
+static void render_leds(const render_frame_t *fr)
 {
-    if (vid_ledlocation > LED_LOC_NONE) {
-        if (led_ticks > 0 && --led_ticks == 0) {
-            led_timer_fired();
-            al_set_target_backbuffer(al_get_current_display());
-        }
+    if (fr->ledlocation > LED_LOC_NONE) {
+        led_render(fr->leds);
+        al_set_target_backbuffer(render_display);
         float w = al_get_bitmap_width(led_bitmap);
         float h = al_get_bitmap_height(led_bitmap);
+        al_draw_tinted_scaled_bitmap(led_bitmap, fr->led_tint, 0, 0, w, h, (fr->winsizex-w)/2, fr->winsizey-h, w, h, 0);
+    }
+}
+
+static void render_present(render_frame_t *fr)
+{
+    render_prepare(fr);
+    if (fr->shot)
+        render_screenshot(fr);
+    blit_screen(fr);
+    al_set_target_backbuffer(render_display);
+    if (fr->scr_x_start > 0)
+        fill_pillarbox(fr);
+    else if (fr->scr_y_start > 0)
+        fill_letterbox(fr);
+    render_leds(fr);
+    al_flip_display();
+}
+
+static void *render_thread_proc(ALLEGRO_THREAD *thread, void *data)
+{
+    al_set_new_bitmap_flags(ALLEGRO_VIDEO_BITMAP|ALLEGRO_NO_PRESERVE_TEXTURE);
+    al_lock_mutex(render_mutex);
+    for (;;) {
+        while (!render_ready && !al_get_thread_should_stop(thread))
+            al_wait_cond(render_cond, render_mutex);
+        if (al_get_thread_should_stop(thread))
+            break;
+        int slot = render_latest;
+        render_latest = render_shown;
+        render_shown = slot;
+        render_ready = false;
+        al_unlock_mutex(render_mutex);
+
+        al_lock_mutex(video_mutex);
+        al_set_target_backbuffer(render_display);
+        render_present(&render_frames[slot]);
+        al_set_target_bitmap(NULL);
+        al_unlock_mutex(video_mutex);
+        al_lock_mutex(render_mutex);
+    }
+    al_unlock_mutex(render_mutex);
+    return NULL;
+}
+
+/*
+ * Copy the lines of b wanted for display or a screenshot into the slot.
+ */
+
+static void frame_capture(render_frame_t *fr)
+{
+    int x1 = fr->firstx, y1 = fr->firsty, x2 = fr->lastx, y2 = fr->lasty;
+
+    if (fr->shot) {
+        if (fr->shotx1 < x1)
+            x1 = fr->shotx1;
+        if (fr->shoty1 < y1)
+            y1 = fr->shoty1;
+        if (fr->shotx2 > x2)
+            x2 = fr->shotx2;
+        if (fr->shoty2 > y2)
+            y2 = fr->shoty2;
+    }
+    if (fr->dtype == VDT_INTERLACE || fr->dtype == VDT_LINEDOUBLE) {
+        y1 <<= 1;
+        y2 = (y2 << 1) + 2;
+    }
+    else
+        y2++;
+    if (x1 < 0)
+        x1 = 0;
+    if (x2 > FRAME_WIDTH)
+        x2 = FRAME_WIDTH;
+    if (y1 < 0)
+        y1 = 0;
+    if (y2 > FRAME_HEIGHT)
+        y2 = FRAME_HEIGHT;
+    fr->cx1 = x1;
+    fr->cy1 = y1;
+    fr->cx2 = x2 > x1 ? x2 : x1;
+    fr->cy2 = y2 > y1 ? y2 : y1;
+
+    size_t linesize = (fr->cx2 - fr->cx1) * region->pixel_size;
+    for (int y = fr->cy1; y < fr->cy2; y++)
+        memcpy((char *)fr->region.data + fr->region.pitch * y + x1 * region->pixel_size, (char *)region->data + region->pitch * y + x1 * region->pixel_size, linesize);
+}
+
+static void frame_settings(render_frame_t *fr)
+{
+    fr->clear = clear_pending;
+    clear_pending = false;
+    fr->dtype = vid_dtype_intern;
+    fr->colour = vid_colour_out;
+    fr->scr_x_start = scr_x_start;
+    fr->scr_x_size = scr_x_size;
+    fr->scr_y_start = scr_y_start;
+    fr->scr_y_size = scr_y_size;
+    fr->winsizex = winsizex;
+    fr->winsizey = winsizey;
+    fr->ledlocation = vid_ledlocation;
+    if (vid_ledlocation > LED_LOC_NONE) {
+        if (led_ticks > 0 && --led_ticks == 0)
+            led_timer_fired();
+        fr->leds = led_state();
         if (vid_ledvisibility == LED_VIS_ALWAYS || (vid_ledvisibility == LED_VIS_TRANSIENT && led_any_transient_led_on())) {
             log_debug("led: drawing non-faded bitmap");
-            al_draw_scaled_bitmap(led_bitmap, 0, 0, w, h, (winsizex-w)/2, winsizey-h, w, h, 0);
+            fr->led_tint = al_map_rgb(255, 255, 255);
         }
         else {
-            ALLEGRO_COLOR led_tint;
             const int led_visible_for_frames = 50;
             const int led_fade_frames = 25;
 
@@ -582,50 +664,154 @@ static void render_leds(void)
                 if (led_visible_frames_left <= led_fade_frames) {
                     int i = (255 * led_visible_frames_left) / led_fade_frames;
                     log_debug("led: tint, i=%d", i);
-                    led_tint = al_map_rgba(i, i, i, vid_ledlocation == LED_LOC_SEPARATE ? 255 : i);
+                    fr->led_tint = al_map_rgba(i, i, i, vid_ledlocation == LED_LOC_SEPARATE ? 255 : i);
                 }
                 else
-                    led_tint = al_map_rgb(255, 255, 255);
+                    fr->led_tint = al_map_rgb(255, 255, 255);
             }
             else
-                led_tint = al_map_rgba(0, 0, 0, vid_ledlocation == LED_LOC_SEPARATE ? 255 : 0);
-            al_draw_tinted_scaled_bitmap(led_bitmap, led_tint, 0, 0, w, h, (winsizex-w)/2, winsizey-h, w, h, 0);
+                fr->led_tint = al_map_rgba(0, 0, 0, vid_ledlocation == LED_LOC_SEPARATE ? 255 : 0);
         }
     }
 }
 
+static void frame_publish(render_frame_t *fr)
+{
+    if (!render_thread) {
+        render_present(fr);
+        return;
+    }
+    al_lock_mutex(render_mutex);
+    if (render_ready) {
+        render_frame_t *prev = &render_frames[render_latest];
+        if (prev->shot) {
+            // Not drawn yet: keep it for its screenshot, drop this one.
+            prev->clear |= fr->clear;
+            al_unlock_mutex(render_mutex);
+            return;
+        }
+        fr->clear |= prev->clear;
+    }
+    int slot = render_latest;
+    render_latest = render_fill;
+    render_fill = slot;
+    render_ready = true;
+    al_signal_cond(render_cond);
+    al_unlock_mutex(render_mutex);
+}
+
+void video_render_clear(void)
+{
+    clear_pending = true;
+}
+
+void video_render_start(ALLEGRO_DISPLAY *display)
+{
+    render_display = display;
+    if (!(render_mutex = al_create_mutex()) || !(video_mutex = al_create_mutex()) || !(render_cond = al_create_cond())) {
+        log_warn("vidalleg: unable to create synchronisation objects, drawing frames on the emulation thread");
+        return;
+    }
+    if (!(render_thread = al_create_thread(render_thread_proc, NULL))) {
+        log_warn("vidalleg: unable to create render thread, drawing frames on the emulation thread");
+        return;
+    }
+    // A display can only be current on one thread, hand it over.
+    al_set_target_bitmap(NULL);
+    al_start_thread(render_thread);
+}
+
+void video_render_stop(void)
+{
+    if (render_thread) {
+        al_set_thread_should_stop(render_thread);
+        al_lock_mutex(render_mutex);
+        al_signal_cond(render_cond);
+        al_unlock_mutex(render_mutex);
+        al_join_thread(render_thread, NULL);
+        al_destroy_thread(render_thread);
+        render_thread = NULL;
+        al_set_target_backbuffer(render_display);
+    }
+    if (render_cond) {
+        al_destroy_cond(render_cond);
+        render_cond = NULL;
+    }
+    if (video_mutex) {
+        al_destroy_mutex(video_mutex);
+        video_mutex = NULL;
+    }
+    if (render_mutex) {
+        al_destroy_mutex(render_mutex);
+        render_mutex = NULL;
+    }
+}
+
 void video_doblit(bool non_ttx, uint8_t vtotal)
 {
-    if (vid_savescrshot)
-        save_screenshot();
+    render_frame_t *fr = &render_frames[render_fill];
+
+    fr->shot = vid_savescrshot && !--vid_savescrshot;
+    if (fr->shot) {
+        fr->shotx1 = firstx;
+        fr->shoty1 = firsty;
+        fr->shotx2 = lastx;
+        fr->shoty2 = lasty;
+        strncpy(fr->shotname, vid_scrshotname, sizeof(fr->shotname) - 1);
+        fr->shotname[sizeof(fr->shotname) - 1] = 0;
+    }
+    if (!fr->region.data) {
+        for (int i = 0; i < 3; i++) {
+            render_frames[i].region.data = render_data[i];
+            render_frames[i].region.format = ALLEGRO_PIXEL_FORMAT_ARGB_8888;
+            render_frames[i].region.pitch = FRAME_WIDTH * sizeof(uint32_t);
+            render_frames[i].region.pixel_size = sizeof(uint32_t);
+        }
+    }
 
     ++framesrun;
-    if (++fskipcount >= ((motor && fasttape) ? 5 : vid_fskipmax)) {
-        if (fullscreen_pending) {
-            ALLEGRO_DISPLAY *display = al_get_current_display();
-            int newsizex = al_get_display_width(display);
-            int newsizey = al_get_display_height(display);
-            log_debug("vidalleg: fullscreen_pending=%d, newsizex=%d, newsizey=%d", fullscreen_pending, newsizex, newsizey);
-            --fullscreen_pending;
-            if (newsizex > winsizex || newsizey > winsizey) {
-                winsizex = newsizex;
-                winsizey = newsizey;
-                video_calc_fullscreen(display);
-                fullscreen_pending = 0;
+    if (headless) {
+        // No display to draw to but screenshots can still be saved.
+        if (fr->shot) {
+            fr->firstx = fr->shotx1;
+            fr->firsty = fr->shoty1;
+            fr->lastx = fr->shotx2;
+            fr->lasty = fr->shoty2;
+            fr->clear = clear_pending;
+            clear_pending = false;
+            fr->dtype = vid_dtype_intern;
+            fr->colour = vid_colour_out;
+            frame_capture(fr);
+            render_prepare(fr);
+            render_screenshot(fr);
+        }
+    }
+    else {
+        bool show = ++fskipcount >= ((motor && fasttape) ? 5 : vid_fskipmax);
+        if (show || fr->shot) {
+            if (fullscreen_pending) {
+                int newsizex = al_get_display_width(render_display);
+                int newsizey = al_get_display_height(render_display);
+                log_debug("vidalleg: fullscreen_pending=%d, newsizex=%d, newsizey=%d", fullscreen_pending, newsizex, newsizey);
+                --fullscreen_pending;
+                if (newsizex > winsizex || newsizey > winsizey) {
+                    winsizex = newsizex;
+                    winsizey = newsizey;
+                    video_calc_fullscreen();
+                    fullscreen_pending = 0;
+                }
             }
+            calc_limits(non_ttx, vtotal);
+            if (show)
+                fskipcount = 0;
+            fr->firstx = firstx;
+            fr->firsty = firsty;
+            fr->lastx = lastx;
+            fr->lasty = lasty;
+            frame_settings(fr);
+            frame_capture(fr);
+            frame_publish(fr);
         }
-        lasty++;
-        calc_limits(non_ttx, vtotal);
-        fskipcount = 0;
-        blit_screen();
-        if (scr_x_start > 0)
-            fill_pillarbox();
-        else if (scr_y_start > 0)
-            fill_letterbox();
-
-        render_leds();
-        al_set_target_bitmap(b);
-        al_flip_display();
     }
     firstx = firsty = 65535;
     lastx  = lasty  = 0;
@@ -8,6 +8,7 @@
 
 #include "config.h"
 #include "6502.h"
+#include "main.h"
 #include "mem.h"
 #include "model.h"
 #include "serial.h"
@@ -131,6 +132,13 @@ int nula_collook[16];           // maps palette (logical) colours to 12-bit RGB
 
 static uint8_t table4bpp[4][256][16];
 
+/* Per-byte cache of finished pixel colours for the current ULA mode and
+ * palette.  Entries are rebuilt lazily when their generation no longer
+ * matches, so a palette write costs nothing until a byte is drawn. */
+static uint32_t ula_pixlook[256][16];
+static uint32_t ula_pixlook_gen[256];
+static uint32_t ula_lookup_gen = 1;
+
 static int nula_pal_write_flag = 0;
 static uint8_t nula_pal_first_byte;
 uint8_t nula_flash[8];
@@ -170,6 +178,27 @@ static inline uint32_t makecol(int red, int green, int blue)
     return 0xff000000 | (red << 16) | (green << 8) | blue;
 }
 
+static inline void ula_lookup_changed(void)
+{
+    if (++ula_lookup_gen == 0) {
+        memset(ula_pixlook_gen, 0, sizeof(ula_pixlook_gen));
+        ula_lookup_gen = 1;
+    }
+}
+
+static inline const uint32_t *ula_pixels(uint8_t dat)
+{
+    uint32_t *pix = ula_pixlook[dat];
+    if (ula_pixlook_gen[dat] != ula_lookup_gen) {
+        const int *pal = nula_palette_mode ? nula_collook : ula_pal;
+        const uint8_t *tab = table4bpp[ula_mode][dat];
+        for (int c = 0; c < 16; c++)
+            pix[c] = pal[tab[c]];
+        ula_pixlook_gen[dat] = ula_lookup_gen;
+    }
+    return pix;
+}
+
 static inline int get_pixel(ALLEGRO_LOCKED_REGION *region, int x, int y)
 {
     return *((uint32_t *)((char *)region->data + region->pitch * y + x * region->pixel_size));
@@ -207,8 +236,18 @@ static inline void nula_putpixel_checked(ALLEGRO_LOCKED_REGION *region, int x, i
         put_pixel_checked(region, x, y, colour, line);
 }
 
+static inline void put_pixel_run_checked(ALLEGRO_LOCKED_REGION *region, int x, int y, int count, const uint32_t *colours, int line)
+{
+    if (x < 0 || (x + count) > 1280)
+        log_debug("video: pixel out of bounds, x=%d at %d", x, line);
+    if (y < 0 || y > 800)
+        log_debug("video: pixel out of bounds, y=%d at %d", y, line);
+    memcpy((char *)region->data + region->pitch * y + x * region->pixel_size, colours, count * sizeof(uint32_t));
+}
+
 #define put_pixel(region, x, y, colour) put_pixel_checked(region, x, y, colour, __LINE__)
 #define put_pixels(region, x, y, count, colour) put_pixels_checked(region, x, y, count, colour, __LINE__)
+#define put_pixel_run(region, x, y, count, colours) put_pixel_run_checked(region, x, y, count, colours, __LINE__)
 #define nula_putpixel(region, x, y, colour) nula_putpixel_checked(region, x, y, colour, __LINE__)
 
 #else
@@ -227,6 +266,11 @@ static inline void put_pixels(ALLEGRO_LOCKED_REGION *region, int x, int y, int c
     }
 }
 
+static inline void put_pixel_run(ALLEGRO_LOCKED_REGION *region, int x, int y, int count, const uint32_t *colours)
+{
+    memcpy((char *)region->data + region->pitch * y + x * region->pixel_size, colours, count * sizeof(uint32_t));
+}
+
 static inline void nula_putpixel(ALLEGRO_LOCKED_REGION *region, int x, int y, uint32_t colour)
 {
     if (crtc_mode && (nula_horizontal_offset || nula_left_blank) && (x < nula_left_cut || x >= nula_left_edge + (crtc[1] * crtc_mode * 8)))
@@ -257,6 +301,7 @@ static void nula_default_palette(void)
     nula_collook[15] = 0xffffffff; // white
 
     mode7_need_new_lookup = 1;
+    ula_lookup_changed();
 }
 
 void nula_reset(void)
@@ -428,6 +473,7 @@ void videoula_write(uint16_t addr, uint8_t val)
         break;
 
     }
+    ula_lookup_changed();
 }
 
 void videoula_savestate(FILE * f)
@@ -477,6 +523,7 @@ void videoula_loadstate(FILE * f)
     nula_disable = *ptr++;
     nula_attribute_mode = *ptr++;
     nula_attribute_text = *ptr++;
+    ula_lookup_changed();
 }
 
 /*Mode 7 (SAA5050)*/
@@ -791,13 +838,22 @@ static int oldr8;
 int firstx, firsty, lastx, lasty;
 
 static ALLEGRO_DISPLAY *display;
-ALLEGRO_BITMAP *b, *b16, *b32;
+ALLEGRO_BITMAP *b, *b16, *b32, *bvid;
 
 ALLEGRO_LOCKED_REGION *region;
 
 ALLEGRO_COLOR border_col;
 
-ALLEGRO_DISPLAY *video_init(void)
+static void video_clear_frame(void)
+{
+    for (int y = 0; y < 800; y++) {
+        uint32_t *row = (uint32_t *)((char *)region->data + region->pitch * y);
+        for (int x = 0; x < 1280; x++)
+            row[x] = colblack;
+    }
+}
+
+static void video_create_display(void)
 {
 #ifdef ALLEGRO_GTK_TOPLEVEL
     al_set_new_display_flags(ALLEGRO_WINDOWED | ALLEGRO_GTK_TOPLEVEL | ALLEGRO_RESIZABLE);
@@ -818,8 +874,21 @@ ALLEGRO_DISPLAY *video_init(void)
     }
 
     al_set_new_bitmap_flags(ALLEGRO_VIDEO_BITMAP|ALLEGRO_NO_PRESERVE_TEXTURE);
+}
+
+ALLEGRO_DISPLAY *video_init(void)
+{
+    if (headless) {
+        /* No display: render into memory bitmaps so screenshots still work. */
+        display = NULL;
+        al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+    }
+    else
+        video_create_display();
+
     b16 = al_create_bitmap(832, 614);
     b32 = al_create_bitmap(1536, 800);
+    bvid = al_create_bitmap(1280, 800);
 
     colblack = 0xff000000;
     colwhite = 0xffffffff;
@@ -851,19 +920,30 @@ ALLEGRO_DISPLAY *video_init(void)
             table4bpp[0][temp][c] = table4bpp[3][temp][c >> 3];
         }
     }
+    /*
+     * The emulation draws into b in memory, without reference to the
+     * display, which belongs to the render thread once that starts.
+     */
+    int flags = al_get_new_bitmap_flags();
+    int format = al_get_new_bitmap_format();
+    al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+    al_set_new_bitmap_format(ALLEGRO_PIXEL_FORMAT_ARGB_8888);
     b = al_create_bitmap(1280, 800);
-    al_set_target_bitmap(b);
-    al_clear_to_color(al_map_rgb(0, 0,0));
+    al_set_new_bitmap_format(format);
+    al_set_new_bitmap_flags(flags);
     region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_WRITEONLY);
+    video_clear_frame();
     return display;
 }
 
 void video_close()
 {
+    al_destroy_bitmap(bvid);
     al_destroy_bitmap(b32);
     al_destroy_bitmap(b16);
     al_destroy_bitmap(b);
-    al_destroy_display(display);
+    if (display)
+        al_destroy_display(display);
     if (font_dir)
         al_destroy_path(font_dir);
 }
@@ -1078,11 +1158,12 @@ void video_poll(int clocks, int timer_enable)
                                         nula_putpixel(region, scrx + c, scry, output);
                                     }
                                 }
-                            } else {
+                            } else if (nula_horizontal_offset || nula_left_blank) {
                                 for (c = 0; c < 8; c++) {
                                     nula_putpixel(region, scrx + c, scry, nula_palette_mode ? nula_collook[table4bpp[ula_mode][dat][c]] : ula_pal[table4bpp[ula_mode][dat][c]]);
                                 }
-                            }
+                            } else
+                                put_pixel_run(region, scrx, scry, 8, ula_pixels(dat));
                         }
                         break;
                     case CRTC_LOFREQ:
@@ -1112,11 +1193,12 @@ void video_poll(int clocks, int timer_enable)
                                         nula_putpixel(region, scrx + c, scry, output);
                                     }
                                 }
-                            } else {
+                            } else if (nula_horizontal_offset || nula_left_blank) {
                                 for (c = 0; c < 16; c++) {
                                     nula_putpixel(region, scrx + c, scry, nula_palette_mode ? nula_collook[table4bpp[ula_mode][dat][c]] : ula_pal[table4bpp[ula_mode][dat][c]]);
                                 }
-                            }
+                            } else
+                                put_pixel_run(region, scrx, scry, 16, ula_pixels(dat));
                         }
                         break;
                     }
@@ -1252,13 +1334,8 @@ void video_poll(int clocks, int timer_enable)
                     // Reached vertical sync position.
                     int intsync = crtc[8] & 1;
                     if (!intsync && oldr8) {
-                        ALLEGRO_COLOR black = al_map_rgb(0, 0, 0);
-                        al_set_target_bitmap(b32);
-                        al_clear_to_color(black);
-                        al_unlock_bitmap(b);
-                        al_set_target_bitmap(b);
-                        al_clear_to_color(black);
-                        region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_WRITEONLY);
+                        video_render_clear();
+                        video_clear_frame();
                     }
                     frameodd ^= 1;
                     if (frameodd)
@@ -1270,10 +1347,7 @@ void video_poll(int clocks, int timer_enable)
                         vid_cleared = 0;
                     } else if (vidclocks <= 1024 && !vid_cleared) {
                         vid_cleared = 1;
-                        al_unlock_bitmap(b);
-                        al_set_target_bitmap(b);
-                        al_clear_to_color(al_map_rgb(0, 0, 0));
-                        region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_WRITEONLY);
+                        video_clear_frame();
                         video_doblit(crtc_mode, crtc[4]);
                     }
                     ccount++;
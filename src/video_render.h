@@ -1,7 +1,7 @@
 #ifndef __INC_VIDEO_RENDER_H
 #define __INC_VIDEO_RENDER_H
 
-extern ALLEGRO_BITMAP *b, *b16, *b32;
+extern ALLEGRO_BITMAP *b, *b16, *b32, *bvid;
 extern ALLEGRO_LOCKED_REGION *region;
 extern ALLEGRO_COLOR border_col, mono_green_col, mono_amber_col, mono_white_col;
 
@@ -73,6 +73,10 @@ void video_set_multipier(int multipler);
 void video_set_led_location(int location);
 void video_set_led_visibility(int visibility);
 
+void video_render_start(ALLEGRO_DISPLAY *display);
+void video_render_stop(void);
+void video_render_clear(void);
+
 void video_close(void);
 
 void clearscreen(void);
@@ -52,6 +52,8 @@ static int tempc;
 static int output = 0;
 static int ins = 0;
 static uint8_t znptable[256], znptablenv[256], znptable16[65536];
+static uint8_t adctable[0x20000], sbctable[0x20000];   /* by carry, a, b */
+static uint8_t inctable[256], dectable[256];
 static uint8_t intreg;
 
 static bool z80_rom_in = true;
@@ -146,70 +148,28 @@ static inline void setznc(uint8_t v)
     af.b.l |= znptable[v];
 }
 
+/* The 8-bit arithmetic flags come from the tables made by makeznptable */
+
 static inline void z80_setadd(uint8_t a, uint8_t b)
 {
-    uint8_t r = a + b;
-    af.b.l = (r) ? ((r & 0x80) ? S_FLAG : 0) : Z_FLAG;
-    af.b.l |= (r & 0x28);       /* undocumented flag bits 5+3 */
-    if ((r & 0x0f) < (a & 0x0f))
-        af.b.l |= H_FLAG;
-    if (r < a)
-        af.b.l |= C_FLAG;
-    if ((b ^ a ^ 0x80) & (b ^ r) & 0x80)
-        af.b.l |= V_FLAG;
+    af.b.l = adctable[(a << 8) | b];
 }
 
 static inline uint8_t setinc(uint8_t v)
 {
-    uint8_t res = (v + 1) & 0xff;
-    af.b.l &= ~(S_FLAG | Z_FLAG | V_FLAG | 0x28 | H_FLAG | N_FLAG);
-    af.b.l |= znptablenv[res];
-    if (v == 0x7F)
-        af.b.l |= V_FLAG;
-    else
-        af.b.l &= ~V_FLAG;
-    if (((v & 0xF) + 1) & 0x10)
-        af.b.l |= H_FLAG;
-    return res;
+    af.b.l = (af.b.l & C_FLAG) | inctable[v];
+    return v + 1;
 }
 
 static inline uint8_t setdec(uint8_t v)
 {
-    uint8_t res = (v - 1) & 0xff;
-    af.b.l &= ~(S_FLAG | Z_FLAG | V_FLAG | 0x28 | H_FLAG);
-    af.b.l |= znptablenv[res] | N_FLAG;
-    if (v == 0x80)
-        af.b.l |= V_FLAG;
-    else
-        af.b.l &= ~V_FLAG;
-    if (!(v & 8) && ((v - 1) & 8))
-        af.b.l |= H_FLAG;
-    return res;
+    af.b.l = (af.b.l & C_FLAG) | dectable[v];
+    return v - 1;
 }
 
 static inline void setadc(uint8_t a, uint8_t b)
 {
-    uint8_t r = a + b + (af.b.l & C_FLAG);
-    if (af.b.l & C_FLAG) {
-        af.b.l = (r) ? ((r & 0x80) ? S_FLAG : 0) : Z_FLAG;
-        af.b.l |= (r & 0x28);   /* undocumented flag bits 5+3 */
-        if ((r & 0x0f) <= (a & 0x0f))
-            af.b.l |= H_FLAG;
-        if (r <= a)
-            af.b.l |= C_FLAG;
-        if ((b ^ a ^ 0x80) & (b ^ r) & 0x80)
-            af.b.l |= V_FLAG;
-    }
-    else {
-        af.b.l = (r) ? ((r & 0x80) ? S_FLAG : 0) : Z_FLAG;
-        af.b.l |= (r & 0x28);   /* undocumented flag bits 5+3 */
-        if ((r & 0x0f) < (a & 0x0f))
-            af.b.l |= H_FLAG;
-        if (r < a)
-            af.b.l |= C_FLAG;
-        if ((b ^ a ^ 0x80) & (b ^ r) & 0x80)
-            af.b.l |= V_FLAG;
-    }
+    af.b.l = adctable[((af.b.l & C_FLAG) << 16) | (a << 8) | b];
 }
 
 static inline void setadc16(uint16_t a, uint16_t b)
@@ -232,27 +192,7 @@ static inline void z80_setadd16(uint16_t a, uint16_t b)
 
 static inline void setsbc(uint8_t a, uint8_t b)
 {
-    uint8_t r = a - (b + (af.b.l & C_FLAG));
-    if (af.b.l & C_FLAG) {
-        af.b.l = N_FLAG | ((r) ? ((r & 0x80) ? S_FLAG : 0) : Z_FLAG);
-        af.b.l |= (r & 0x28);   /* undocumented flag bits 5+3 */
-        if ((r & 0x0f) >= (a & 0x0f))
-            af.b.l |= H_FLAG;
-        if (r >= a)
-            af.b.l |= C_FLAG;
-        if ((b ^ a) & (a ^ r) & 0x80)
-            af.b.l |= V_FLAG;
-    }
-    else {
-        af.b.l = N_FLAG | ((r) ? ((r & 0x80) ? S_FLAG : 0) : Z_FLAG);
-        af.b.l |= (r & 0x28);   /* undocumented flag bits 5+3 */
-        if ((r & 0x0f) > (a & 0x0f))
-            af.b.l |= H_FLAG;
-        if (r > a)
-            af.b.l |= C_FLAG;
-        if ((b ^ a) & (a ^ r) & 0x80)
-            af.b.l |= V_FLAG;
-    }
+    af.b.l = sbctable[((af.b.l & C_FLAG) << 16) | (a << 8) | b];
 }
 
 static inline void setsbc16(uint16_t a, uint16_t b)
@@ -266,38 +206,18 @@ static inline void setsbc16(uint16_t a, uint16_t b)
 
 static inline void setcpED(uint8_t a, uint8_t b)
 {
-    uint8_t r = a - b;
-    af.b.l &= C_FLAG;
-    af.b.l |= N_FLAG | ((r) ? ((r & 0x80) ? S_FLAG : 0) : Z_FLAG);
-    af.b.l |= (b & 0x28);       /* undocumented flag bits 5+3 */
-    if ((r & 0x0f) > (a & 0x0f))
-        af.b.l |= H_FLAG;
+    /* undocumented flag bits 5+3 from the operand */
+    af.b.l = (af.b.l & C_FLAG) | (sbctable[(a << 8) | b] & (S_FLAG | Z_FLAG | H_FLAG | N_FLAG)) | (b & 0x28);
 }
 
 static inline void setcp(uint8_t a, uint8_t b)
 {
-    uint8_t r = a - b;
-    af.b.l = N_FLAG | ((r) ? ((r & 0x80) ? S_FLAG : 0) : Z_FLAG);
-    af.b.l |= (b & 0x28);       /* undocumented flag bits 5+3 */
-    if ((r & 0x0f) > (a & 0x0f))
-        af.b.l |= H_FLAG;
-    if (r > a)
-        af.b.l |= C_FLAG;
-    if ((b ^ a) & (a ^ r) & 0x80)
-        af.b.l |= V_FLAG;
+    af.b.l = (sbctable[(a << 8) | b] & ~0x28) | (b & 0x28);
 }
 
 static inline void z80_setsub(uint8_t a, uint8_t b)
 {
-    uint8_t r = a - b;
-    af.b.l = N_FLAG | ((r) ? ((r & 0x80) ? S_FLAG : 0) : Z_FLAG);
-    af.b.l |= (r & 0x28);       /* undocumented flag bits 5+3 */
-    if ((r & 0x0f) > (a & 0x0f))
-        af.b.l |= H_FLAG;
-    if (r > a)
-        af.b.l |= C_FLAG;
-    if ((b ^ a) & (a ^ r) & 0x80)
-        af.b.l |= V_FLAG;
+    af.b.l = sbctable[(a << 8) | b];
 }
 
 static void makeznptable()
@@ -337,6 +257,46 @@ static void makeznptable()
         znptable16[c] = d;
     }
     znptable16[0] |= 0x40;
+    for (c = 0; c < 2; c++) {
+        for (d = 0; d < 256; d++) {
+            for (e = 0; e < 256; e++) {
+                uint8_t r = d + e + c;
+                f = (r) ? ((r & 0x80) ? S_FLAG : 0) : Z_FLAG;
+                f |= (r & 0x28);        /* undocumented flag bits 5+3 */
+                if (c ? (r & 0x0f) <= (d & 0x0f) : (r & 0x0f) < (d & 0x0f))
+                    f |= H_FLAG;
+                if (c ? r <= d : r < d)
+                    f |= C_FLAG;
+                if ((e ^ d ^ 0x80) & (e ^ r) & 0x80)
+                    f |= V_FLAG;
+                adctable[(c << 16) | (d << 8) | e] = f;
+                r = d - (e + c);
+                f = N_FLAG | ((r) ? ((r & 0x80) ? S_FLAG : 0) : Z_FLAG);
+                f |= (r & 0x28);        /* undocumented flag bits 5+3 */
+                if (c ? (r & 0x0f) >= (d & 0x0f) : (r & 0x0f) > (d & 0x0f))
+                    f |= H_FLAG;
+                if (c ? r >= d : r > d)
+                    f |= C_FLAG;
+                if ((e ^ d) & (d ^ r) & 0x80)
+                    f |= V_FLAG;
+                sbctable[(c << 16) | (d << 8) | e] = f;
+            }
+        }
+    }
+    for (c = 0; c < 256; c++) {
+        f = znptablenv[(c + 1) & 0xff];
+        if (c == 0x7F)
+            f |= V_FLAG;
+        if (((c & 0xF) + 1) & 0x10)
+            f |= H_FLAG;
+        inctable[c] = f;
+        f = znptablenv[(c - 1) & 0xff] | N_FLAG;
+        if (c == 0x80)
+            f |= V_FLAG;
+        if (!(c & 8) && ((c - 1) & 8))
+            f |= H_FLAG;
+        dectable[c] = f;
+    }
 }
 
 static int dbg_debug_enable(int newvalue)